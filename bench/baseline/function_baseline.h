@@ -1,5 +1,11 @@
 #pragma once
 
+// The callback wrapper that Delegate replaced, kept only for the benchmarks.
+// Holds a plain function pointer, so callbacks can't carry any state.
+
+namespace Baseline
+{
+
 // Can't make a function with a simple type
 template <typename Type>
 struct Function
@@ -54,4 +60,6 @@ struct Function <RetType (Args...)>
         return _function != nullptr;
     }
 
-};
\ No newline at end of file
+};
+
+} // namespace Baseline
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core/types.h"
+#include "containers/hash.h"
+
+// The hashers from before wyhash and the integer finalizers, kept only for the
+// benchmarks. hash_char_buffer reads up to 4 bytes past the end of the buffer
+// (the mask is applied after the read), so whatever it hashes needs that much slack.
+
+namespace Baseline
+{
+
+constexpr Hash bytes[4] = {
+    0x000000FF,
+    0x0000FF00,
+    0x00FF0000,
+    0xFF000000
+};
+
+// Hasher<s32> and Hasher<u32>
+inline Hash hash_u32(u32 key)
+{
+    // 00 00 00 FF -> 00 FF 00 00   << 16
+    // 00 00 FF 00 -> 00 00 00 FF   >> 8
+    // 00 FF 00 00 -> FF 00 00 00   << 8
+    // FF 00 00 00 -> 00 00 FF 00   >> 16
+
+    return ((key & bytes[0]) << 16) |
+           ((key & bytes[1]) >>  8) |
+           ((key & bytes[2]) <<  8) |
+           ((key & bytes[3]) >> 16);
+}
+
+// Hasher<String> and Hasher<Bytes>
+inline Hash hash_char_buffer(char const* buffer, const u64 length)
+{
+    Hash const* ptr = (Hash*) buffer;
+    u64 count = length / 4;
+    u32 rem = length % 4;
+
+    Hash hash = (Hash) 0x8BDC195DF;
+    while (count)
+    {
+        const Hash val = *ptr;
+
+        hash = (Hash) (hash + hash * val * val * (count * count + 1));
+        hash = hash_u32(hash);
+
+        count--;
+        ptr++;
+    }
+
+    {   // Hash the remaining chars
+        const u32 shift = (4 - rem) * 8;
+        const u32 mask = (shift < 32u) ? (0xFFFFFFFF << shift) : 0u;
+        const Hash val = (*ptr) & mask;
+
+        hash = hash + hash * val * val;
+        hash = hash_u32(hash);
+    }
+
+    return hash;
+}
+
+} // namespace Baseline
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "core/types.h"
+#include "core/logger.h"
+#include "core/number_conversion.h"
+#include "containers/string.h"
+#include "math/common.h"
+#include "platform/platform.h"
+
+// Shared helpers for the benchmarks. Every .cpp in bench is its own executable
+// (build.bat bench) that prints its timings as a table, best of a few runs each.
+
+inline void bench_init()
+{
+    platform_init_clock();
+}
+
+// Same sequence on every run and machine (splitmix64)
+struct BenchRandom
+{
+    u64 state;
+};
+
+inline u64 bench_next(BenchRandom& random)
+{
+    u64 z = (random.state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// The fastest run is the one least disturbed by everything else running on the machine
+template <typename Function>
+inline f64 bench_best_ms(u32 runs, Function function)
+{
+    f64 best = 1e300;
+    for (u32 i = 0; i < runs; i++)
+    {
+        const f64 start = platform_get_time_absolute();
+        function();
+        best = min(best, (platform_get_time_absolute() - start) * 1000.0);
+    }
+
+    return best;
+}
+
+// Results go through here so the optimizer can't throw the work away
+inline void bench_consume(u64 value)
+{
+    static volatile u64 sink;
+    sink = sink + value;
+}
+
+// The optimizer can't see what's behind the returned pointer, so calls made through
+// what it points to can't be resolved at compile time and inlined
+template <typename T>
+inline T* bench_opaque(T* pointer)
+{
+    static void* volatile hidden;
+    hidden = pointer;
+    return (T*) hidden;
+}
+
+inline void bench_print_padding(u64 used, u32 width)
+{
+    for (u64 i = used; i < width; i++)
+        print(" ");
+}
+
+inline void bench_print_label(const char* label, u32 width = 24)
+{
+    const String str = ref((char*) label);
+    print("%", str);
+    bench_print_padding(str.size, width);
+}
+
+// Right aligned with 2 decimals, print's shortest float format doesn't line up in a table
+inline void bench_print_value(f64 value, u32 width = 12)
+{
+    char buffer[MAX_INTEGER_CHARS + 4];
+
+    const u64 hundredths = (u64) (max(value, 0.0) * 100.0 + 0.5);
+    u64 size = format_u64(buffer, hundredths / 100);
+
+    buffer[size++] = '.';
+    buffer[size++] = (char) ('0' + (hundredths / 10) % 10);
+    buffer[size++] = (char) ('0' + hundredths % 10);
+
+    bench_print_padding(size, width);
+    print("%", ref(buffer, size));
+}
+
+inline void bench_print_count(u64 value, u32 width = 12)
+{
+    char buffer[MAX_INTEGER_CHARS];
+    const u64 size = format_u64(buffer, value);
+
+    bench_print_padding(size, width);
+    print("%", ref(buffer, size));
+}
+
+inline void bench_print_header(const char* const* columns, u32 column_count, u32 label_width = 24, u32 width = 12)
+{
+    bench_print_padding(0, label_width);
+    for (u32 i = 0; i < column_count; i++)
+    {
+        const String str = ref((char*) columns[i]);
+        bench_print_padding(str.size, width);
+        print("%", str);
+    }
+
+    print("\n");
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <functional>
+#include "bench.h"
+#include "containers/delegate.h"
+#include "engine/imgui.h"
+#include "baseline/function_baseline.h"
+
+// Calls the registered callbacks the way render_button does when a button is clicked,
+// with the old Function (state has to live in globals), std::function and Delegate
+// holding a function pointer, a capturing lambda and a member function.
+// The lists are hidden behind bench_opaque so none of the calls get inlined.
+
+using Imgui::ID;
+
+constexpr u32 CALLBACK_COUNT = 4;
+constexpr u64 CLICKS         = 20000000;
+constexpr u32 BENCH_RUNS     = 5;
+
+struct ButtonState
+{
+    u64 clicks;
+    u64 last_id;
+
+    void on_click(ID id)
+    {
+        clicks++;
+        last_id += (u64) id.primary;
+    }
+};
+
+static ButtonState global_states[CALLBACK_COUNT];
+
+static void on_click_0(ID id) { global_states[0].on_click(id); }
+static void on_click_1(ID id) { global_states[1].on_click(id); }
+static void on_click_2(ID id) { global_states[2].on_click(id); }
+static void on_click_3(ID id) { global_states[3].on_click(id); }
+
+static void (*const click_functions[CALLBACK_COUNT])(ID) = { on_click_0, on_click_1, on_click_2, on_click_3 };
+
+template <typename Callable>
+struct CallbackList
+{
+    Callable callbacks[CALLBACK_COUNT];
+    u64 size;
+};
+
+// Returns ns per call
+template <typename Callable>
+static f64 bench_callbacks(CallbackList<Callable>& list, ButtonState* states)
+{
+    CallbackList<Callable>* callbacks = bench_opaque(&list);
+
+    const f64 ms = bench_best_ms(BENCH_RUNS, [&]()
+    {
+        for (u64 click = 0; click < CLICKS; click++)
+        {
+            const ID id = { (s32) click, 0 };
+            for (u64 i = 0; i < callbacks->size; i++)
+                callbacks->callbacks[i](id);
+        }
+    });
+
+    for (u32 i = 0; i < CALLBACK_COUNT; i++)
+    {
+        bench_consume(states[i].clicks + states[i].last_id);
+        states[i] = {};
+    }
+
+    return ms * 1e6 / (f64) (CLICKS * CALLBACK_COUNT);
+}
+
+static void print_result(const char* label, f64 ns)
+{
+    bench_print_label(label, 32);
+    bench_print_value(ns);
+    print("\n");
+}
+
+int main()
+{
+    bench_init();
+
+    ButtonState states[CALLBACK_COUNT] = {};
+
+    print("Button callbacks, % per click, ns per call\n\n", CALLBACK_COUNT);
+
+    {   // Old Function, the callbacks have to find their state through a global
+        CallbackList<Baseline::Function<void(ID)>> list;
+        list.size = CALLBACK_COUNT;
+        for (u32 i = 0; i < CALLBACK_COUNT; i++)
+            list.callbacks[i] = click_functions[i];
+
+        print_result("baseline Function, global", bench_callbacks(list, global_states));
+    }
+
+    {   // std::function, capturing
+        CallbackList<std::function<void(ID)>> list;
+        list.size = CALLBACK_COUNT;
+        for (u32 i = 0; i < CALLBACK_COUNT; i++)
+        {
+            ButtonState* state = &states[i];
+            list.callbacks[i] = [state](ID id) { state->on_click(id); };
+        }
+
+        print_result("std::function, capturing", bench_callbacks(list, states));
+    }
+
+    {   // Delegate, function pointer
+        CallbackList<Delegate<void(ID)>> list;
+        list.size = CALLBACK_COUNT;
+        for (u32 i = 0; i < CALLBACK_COUNT; i++)
+            list.callbacks[i] = click_functions[i];
+
+        print_result("Delegate, function pointer", bench_callbacks(list, global_states));
+    }
+
+    {   // Delegate, capturing lambda
+        CallbackList<Delegate<void(ID)>> list;
+        list.size = CALLBACK_COUNT;
+        for (u32 i = 0; i < CALLBACK_COUNT; i++)
+        {
+            ButtonState* state = &states[i];
+            list.callbacks[i] = [state](ID id) { state->on_click(id); };
+        }
+
+        print_result("Delegate, capturing lambda", bench_callbacks(list, states));
+    }
+
+    {   // Delegate, member function
+        CallbackList<Delegate<void(ID)>> list;
+        list.size = CALLBACK_COUNT;
+        for (u32 i = 0; i < CALLBACK_COUNT; i++)
+            list.callbacks[i] = Delegate<void(ID)>(&states[i], &ButtonState::on_click);
+
+        print_result("Delegate, member function", bench_callbacks(list, states));
+    }
+
+    return 0;
+}
\ No newline at end of file
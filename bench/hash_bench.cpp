@@ -0,0 +1,276 @@
+#include "bench.h"
+#include "containers/hash.h"
+#include "containers/hash_table.h"
+#include "containers/algorithms.h"
+#include "baseline/hash_baseline.h"
+
+// Compares the current hashers with the old byte shuffling ones.
+//
+// Distribution is measured on the bits HashTable uses: the group (hash >> 7) at the
+// capacity the table would have for the key set and the 7 bit fragment in the control
+// byte. chi2/dof is about 1 when the keys spread out like random numbers would, the
+// higher it goes the longer the probe sequences get. Full collisions are keys with the
+// same 32 bit hash, which the table can only tell apart by comparing the keys.
+//
+// Throughput hashes byte buffers of a fixed size, the old hasher also reads past the
+// end so every buffer has some slack.
+
+using namespace HashTableInternal;
+
+constexpr u32 BENCH_RUNS = 5;
+constexpr u32 KEY_COUNT  = 20000;
+constexpr u64 SLACK      = 64;
+
+// Keys packed one after another, integer keys are stored as their 4 bytes
+struct KeySet
+{
+    const char* name;
+    bool integers;
+
+    char* data;
+    u64*  offsets;
+    u32*  sizes;
+    u32   count;
+};
+
+static KeySet make_key_set(const char* name, bool integers, u32 capacity, u64 data_size)
+{
+    KeySet set = {};
+    set.name     = name;
+    set.integers = integers;
+    set.data     = (char*) platform_allocate(data_size + SLACK);
+    set.offsets  = (u64*)  platform_allocate(capacity * sizeof(u64));
+    set.sizes    = (u32*)  platform_allocate(capacity * sizeof(u32));
+
+    platform_zero_memory(set.data, data_size + SLACK);
+    return set;
+}
+
+static void free(KeySet& set)
+{
+    platform_free(set.data);
+    platform_free(set.offsets);
+    platform_free(set.sizes);
+    set = {};
+}
+
+static void add_key(KeySet& set, u64& used, const char* prefix, u64 number, const char* suffix)
+{
+    char* key = set.data + used;
+    u64 size = 0;
+
+    for (const char* c = prefix; *c; c++) key[size++] = *c;
+    size += format_u64(key + size, number);
+    for (const char* c = suffix; *c; c++) key[size++] = *c;
+
+    set.offsets[set.count] = used;
+    set.sizes[set.count]   = (u32) size;
+    set.count++;
+    used += size;
+}
+
+static void add_integer(KeySet& set, u64& used, s32 value)
+{
+    platform_copy_memory(set.data + used, &value, sizeof(value));
+
+    set.offsets[set.count] = used;
+    set.sizes[set.count]   = sizeof(value);
+    set.count++;
+    used += sizeof(value);
+}
+
+static Hash hash_key(const KeySet& set, u32 index, bool baseline)
+{
+    const char* key = set.data + set.offsets[index];
+    if (set.integers)
+    {
+        s32 value;
+        platform_copy_memory(&value, key, sizeof(value));
+        return baseline ? Baseline::hash_u32((u32) value) : Hasher<s32>()(value);
+    }
+
+    return baseline ? Baseline::hash_char_buffer(key, set.sizes[index]) : Hasher<String>()(ref((char*) key, (u64) set.sizes[index]));
+}
+
+struct Distribution
+{
+    f64 group_chi2;
+    f64 fragment_chi2;
+    u32 full_collisions;
+};
+
+static Distribution measure_distribution(const KeySet& set, bool baseline)
+{
+    Distribution result = {};
+
+    // Capacity the table grows to when the keys are put one by one
+    u32 capacity = 2 * MIN_CAPACITY;
+    while (set.count > max_filled_for_capacity(capacity))
+        capacity *= 2;
+
+    const u32 group_count = capacity / GROUP_WIDTH;
+    u32* groups = (u32*) platform_allocate(group_count * sizeof(u32));
+    u32* hashes = (u32*) platform_allocate(set.count * sizeof(u32));
+    u32 fragments[128] = {};
+
+    platform_zero_memory(groups, group_count * sizeof(u32));
+
+    for (u32 i = 0; i < set.count; i++)
+    {
+        const Hash hash = hash_key(set, i, baseline);
+        hashes[i] = hash;
+        groups[hash_group(hash) & (group_count - 1)]++;
+        fragments[hash_fragment(hash)]++;
+    }
+
+    {   // Chi squared over the groups and fragments
+        const f64 expected_group = (f64) set.count / (f64) group_count;
+        for (u32 i = 0; i < group_count; i++)
+            result.group_chi2 += (groups[i] - expected_group) * (groups[i] - expected_group) / expected_group;
+
+        const f64 expected_fragment = (f64) set.count / 128.0;
+        for (u32 i = 0; i < 128; i++)
+            result.fragment_chi2 += (fragments[i] - expected_fragment) * (fragments[i] - expected_fragment) / expected_fragment;
+
+        result.group_chi2    /= (f64) (group_count - 1);
+        result.fragment_chi2 /= 127.0;
+    }
+
+    sort(hashes, set.count);
+    for (u32 i = 1; i < set.count; i++)
+        result.full_collisions += (hashes[i] == hashes[i - 1]);
+
+    platform_free(groups);
+    platform_free(hashes);
+
+    return result;
+}
+
+static void print_distribution(const char* label, const Distribution& distribution)
+{
+    bench_print_label(label);
+    bench_print_value(distribution.group_chi2, 16);
+    bench_print_value(distribution.fragment_chi2, 16);
+    bench_print_count(distribution.full_collisions, 16);
+    print("\n");
+}
+
+int main()
+{
+    bench_init();
+
+    KeySet sets[4];
+
+    {   // Kerning pairs as imgui builds them, every pair of printable ascii characters
+        const u32 count = 95 * 95;
+        KeySet& set = sets[0] = make_key_set("kerning pairs", true, count, count * sizeof(s32));
+
+        u64 used = 0;
+        for (s32 a = ' '; a < 127; a++)
+            for (s32 b = ' '; b < 127; b++)
+                add_integer(set, used, (a << 8) | b);
+    }
+
+    {   // Sequential ids
+        KeySet& set = sets[1] = make_key_set("sequential ids", true, KEY_COUNT, KEY_COUNT * sizeof(s32));
+
+        u64 used = 0;
+        for (u32 i = 0; i < KEY_COUNT; i++)
+            add_integer(set, used, (s32) i);
+    }
+
+    {   // Field names of slz documents with a number to make them unique
+        const char* fields[] = { "name", "position", "scale", "rotation", "texture", "color", "children", "id",
+                                 "x", "y", "z", "w", "width", "height", "frames", "duration", "pivot", "layer",
+                                 "shader", "glyphs", "kerning", "size", "line_height", "advance" };
+        const u32 field_count = sizeof(fields) / sizeof(fields[0]);
+
+        KeySet& set = sets[2] = make_key_set("slz keys", false, KEY_COUNT, KEY_COUNT * 32);
+
+        u64 used = 0;
+        for (u32 i = 0; i < KEY_COUNT; i++)
+        {
+            char prefix[32];
+            u64 size = 0;
+            for (const char* c = fields[i % field_count]; *c; c++) prefix[size++] = *c;
+            prefix[size++] = '_';
+            prefix[size]   = '\0';
+
+            add_key(set, used, prefix, i, "");
+        }
+    }
+
+    {   // Texture paths that only differ by a number in the middle
+        KeySet& set = sets[3] = make_key_set("texture paths", false, KEY_COUNT, KEY_COUNT * 64);
+
+        u64 used = 0;
+        for (u32 i = 0; i < KEY_COUNT; i++)
+            add_key(set, used, "assets/textures/sprites/sheet_", i, ".png");
+    }
+
+    print("Distribution over HashTable groups and control byte fragments (chi2/dof, 1 is ideal)\n");
+
+    const char* distribution_columns[] = { "group chi2", "fragment chi2", "collisions" };
+    for (KeySet& set : sets)
+    {
+        print("\n% (% keys)\n", set.name, set.count);
+        bench_print_header(distribution_columns, 3, 24, 16);
+
+        print_distribution("baseline", measure_distribution(set, true));
+        print_distribution("Hasher", measure_distribution(set, false));
+    }
+
+    for (KeySet& set : sets)
+        free(set);
+
+    print("\nThroughput over byte buffers\n\n");
+
+    const u64 sizes[] = { 8, 16, 32, 64, 256, 4096, 1 << 20 };
+    const char* throughput_columns[] = { "baseline ns", "Hasher ns", "baseline GB/s", "Hasher GB/s" };
+    bench_print_header(throughput_columns, 4, 24, 16);
+
+    BenchRandom random = { 1 };
+    for (u64 size : sizes)
+    {
+        const u64 buffer_size = size + SLACK;
+        u8* buffer = (u8*) platform_allocate(buffer_size);
+        for (u64 i = 0; i < buffer_size; i++)
+            buffer[i] = (u8) bench_next(random);
+
+        // About 200 MB hashed per run, moving the start so the reads aren't always aligned
+        const u64 iterations = max(200000000ui64 / (size + 16), 1ui64);
+
+        const f64 baseline_ms = bench_best_ms(BENCH_RUNS, [&]()
+        {
+            u64 sum = 0;
+            for (u64 i = 0; i < iterations; i++)
+                sum += Baseline::hash_char_buffer((char*) buffer + (i & 7), size);
+
+            bench_consume(sum);
+        });
+
+        const f64 current_ms = bench_best_ms(BENCH_RUNS, [&]()
+        {
+            u64 sum = 0;
+            for (u64 i = 0; i < iterations; i++)
+                sum += Hasher<Bytes>()(Bytes { buffer + (i & 7), size });
+
+            bench_consume(sum);
+        });
+
+        char label[MAX_INTEGER_CHARS + 8];
+        const u64 label_size = format_u64(label, size);
+        platform_copy_memory(label + label_size, " bytes", 7);
+
+        bench_print_label(label);
+        bench_print_value(baseline_ms * 1e6 / (f64) iterations, 16);
+        bench_print_value(current_ms  * 1e6 / (f64) iterations, 16);
+        bench_print_value((f64) (size * iterations) / (baseline_ms * 1e6), 16);
+        bench_print_value((f64) (size * iterations) / (current_ms  * 1e6), 16);
+        print("\n");
+
+        platform_free(buffer);
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "bench.h"
+#include "containers/hash_table.h"
+#include "baseline/hash_table_baseline.h"
+
+// Lookups and updates with random u32 keys on the current table and the linear probing
+// one it replaced. Churn removes every key and puts a new one in its place, which
+// leaves a tombstone behind each time in the old table, and the hits after it show
+// how much that slows down later lookups. Everything is in ns per operation.
+
+constexpr u32 BENCH_RUNS         = 5;
+constexpr u64 OPERATIONS_PER_RUN = 2000000;
+
+struct HashTableResult
+{
+    f64 insert;
+    f64 hit;
+    f64 miss;
+    f64 churn;
+    f64 hit_after_churn;
+};
+
+template <typename Table>
+static HashTableResult bench_table(const u32* source_keys, u32 count)
+{
+    HashTableResult result;
+
+    u32* keys = (u32*) platform_allocate(count * sizeof(u32));
+    platform_copy_memory(keys, source_keys, count * sizeof(u32));
+
+    const u32 passes = (u32) max(OPERATIONS_PER_RUN / count, 1ui64);
+    const f64 operations = (f64) count * (f64) passes;
+
+    {   // Insert, starting from the default capacity so the resizes are included
+        result.insert = bench_best_ms(BENCH_RUNS, [&]()
+        {
+            for (u32 pass = 0; pass < max(passes / 8, 1u); pass++)
+            {
+                Table table = make<Table>();
+                for (u32 i = 0; i < count; i++)
+                    put(table, keys[i], i);
+
+                bench_consume(table.filled);
+                free(table);
+            }
+        }) * 1e6 / ((f64) count * (f64) max(passes / 8, 1u));
+    }
+
+    Table table = make<Table>();
+    for (u32 i = 0; i < count; i++)
+        put(table, keys[i], i);
+
+    auto hits = [&]()
+    {
+        u64 sum = 0;
+        for (u32 pass = 0; pass < passes; pass++)
+        {
+            for (u32 i = 0; i < count; i++)
+            {
+                auto element = find(table, keys[i]);
+                sum += element ? element.value() : 0;
+            }
+        }
+
+        bench_consume(sum);
+    };
+
+    result.hit = bench_best_ms(BENCH_RUNS, hits) * 1e6 / operations;
+
+    result.miss = bench_best_ms(BENCH_RUNS, [&]()
+    {
+        u64 found = 0;
+        for (u32 pass = 0; pass < passes; pass++)
+        {
+            for (u32 i = 0; i < count; i++)
+                found += (bool) find(table, keys[i] ^ 0x5BD1E995);
+        }
+
+        bench_consume(found);
+    }) * 1e6 / operations;
+
+    // Changes the table so it only runs once
+    result.churn = bench_best_ms(1, [&]()
+    {
+        for (u32 pass = 0; pass < passes; pass++)
+        {
+            for (u32 i = 0; i < count; i++)
+            {
+                auto element = find(table, keys[i]);
+                if (element)
+                    remove(element);
+
+                keys[i] += 1 + pass;
+                put(table, keys[i], i);
+            }
+        }
+
+        bench_consume(table.filled);
+    }) * 1e6 / operations;
+
+    result.hit_after_churn = bench_best_ms(BENCH_RUNS, hits) * 1e6 / operations;
+
+    free(table);
+    platform_free(keys);
+
+    return result;
+}
+
+static void print_result(const char* label, const HashTableResult& result)
+{
+    bench_print_label(label);
+    bench_print_value(result.insert);
+    bench_print_value(result.hit);
+    bench_print_value(result.miss);
+    bench_print_value(result.churn);
+    bench_print_value(result.hit_after_churn);
+    print("\n");
+}
+
+int main()
+{
+    bench_init();
+
+    const u32 sizes[] = { 1000, 100000, 1000000 };
+    const char* columns[] = { "insert", "hit", "miss", "churn", "churn hit" };
+
+    print("Hash table, u32 keys, ns per operation\n");
+
+    for (u32 size : sizes)
+    {
+        BenchRandom random = { size };
+
+        u32* keys = (u32*) platform_allocate(size * sizeof(u32));
+        for (u32 i = 0; i < size; i++)
+            keys[i] = (u32) bench_next(random);
+
+        print("\n% keys\n", size);
+        bench_print_header(columns, sizeof(columns) / sizeof(columns[0]));
+
+        print_result("baseline", bench_table<Baseline::HashTable<u32, u32>>(keys, size));
+        print_result("HashTable", bench_table<HashTable<u32, u32>>(keys, size));
+
+        platform_free(keys);
+    }
+
+    return 0;
+}
\ No newline at end of file
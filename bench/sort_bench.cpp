@@ -0,0 +1,156 @@
+#include <algorithm>
+#include "bench.h"
+#include "containers/darray.h"
+#include "containers/algorithms.h"
+#include "baseline/sort_baseline.h"
+
+// Sorts u32 arrays with every sort in algorithms.h, the quicksort it replaced and
+// std::sort for reference. Inputs are random, already sorted, reversed and random with
+// only 16 distinct values. Times are in ns per element and only cover the sort, the
+// input is copied back before every run. The old quicksort is quadratic on everything
+// but random input (and recurses once per element) so it only runs on small arrays there.
+
+constexpr u64 BASELINE_MAX_ORDERED = 10000;
+
+enum struct Pattern : u8
+{
+    RANDOM,
+    SORTED,
+    REVERSED,
+    DUPLICATES
+};
+
+static const char* pattern_names[] = { "random", "sorted", "reversed", "16 values" };
+
+enum struct Algorithm : u8
+{
+    BASELINE,
+    SORT,
+    STD_SORT,
+    STABLE_SORT,
+    RADIX_SORT,
+    PARALLEL_SORT,
+
+    COUNT
+};
+
+static const char* algorithm_names[] = { "baseline", "sort", "std::sort", "stable_sort", "radix_sort", "parallel_sort" };
+
+static void fill(u32* data, u64 count, Pattern pattern, BenchRandom& random)
+{
+    for (u64 i = 0; i < count; i++)
+    {
+        switch (pattern)
+        {
+            case Pattern::RANDOM:     data[i] = (u32) bench_next(random);        break;
+            case Pattern::SORTED:     data[i] = (u32) i;                         break;
+            case Pattern::REVERSED:   data[i] = (u32) (count - i);               break;
+            case Pattern::DUPLICATES: data[i] = (u32) (bench_next(random) % 16); break;
+        }
+    }
+}
+
+static void run(Algorithm algorithm, u32* data, u64 count)
+{
+    DynamicArray<u32> array = { data, count, count, nullptr };
+
+    switch (algorithm)
+    {
+        case Algorithm::BASELINE:      Baseline::q_sort(data, 0, (int) count - 1); break;
+        case Algorithm::SORT:          sort(data, count);                          break;
+        case Algorithm::STD_SORT:      std::sort(data, data + count);              break;
+        case Algorithm::STABLE_SORT:   stable_sort(data, count);                   break;
+        case Algorithm::RADIX_SORT:    radix_sort(array);                          break;
+        case Algorithm::PARALLEL_SORT: parallel_sort(array);                       break;
+    }
+}
+
+// Returns ns per element, negative if the result wasn't sorted
+static f64 bench_sort(Algorithm algorithm, const u32* input, u32* work, u64 count)
+{
+    // Enough runs to sort about 10M elements in total, at least 3, but stops
+    // after a second so the slow cases don't take over the whole benchmark
+    const u32 runs = (u32) max(10000000ui64 / count, 3ui64);
+
+    f64 best  = 1e300;
+    f64 total = 0.0;
+    for (u32 i = 0; i < runs && total < 1.0; i++)
+    {
+        platform_copy_memory(work, input, count * sizeof(u32));
+
+        const f64 start = platform_get_time_absolute();
+        run(algorithm, work, count);
+
+        const f64 elapsed = platform_get_time_absolute() - start;
+        best   = min(best, elapsed);
+        total += elapsed;
+    }
+
+    for (u64 i = 1; i < count; i++)
+    {
+        if (work[i - 1] > work[i])
+            return -1.0;
+    }
+
+    bench_consume(work[count / 2]);
+    return best * 1e9 / (f64) count;
+}
+
+int main()
+{
+    bench_init();
+
+    const u64 sizes[] = { 1000, 10000, 100000, 1000000, 10000000 };
+    const u64 max_size = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+
+    u32* input = (u32*) platform_allocate(max_size * sizeof(u32));
+    u32* work  = (u32*) platform_allocate(max_size * sizeof(u32));
+
+    print("Sorting u32, ns per element (- means skipped)\n\n");
+    bench_print_header(algorithm_names, (u32) Algorithm::COUNT, 24, 14);
+
+    for (u32 pattern = 0; pattern < sizeof(pattern_names) / sizeof(pattern_names[0]); pattern++)
+    {
+        for (u64 size : sizes)
+        {
+            BenchRandom random = { size };
+            fill(input, size, (Pattern) pattern, random);
+
+            char label[64];
+            u64 label_size = 0;
+            for (const char* c = pattern_names[pattern]; *c; c++) label[label_size++] = *c;
+            label[label_size++] = ' ';
+            label_size += format_u64(label + label_size, size);
+            label[label_size] = '\0';
+
+            bench_print_label(label);
+
+            for (u32 algorithm = 0; algorithm < (u32) Algorithm::COUNT; algorithm++)
+            {
+                if ((Algorithm) algorithm == Algorithm::BASELINE && (Pattern) pattern != Pattern::RANDOM && size > BASELINE_MAX_ORDERED)
+                {
+                    bench_print_padding(1, 14);
+                    print("-");
+                    continue;
+                }
+
+                const f64 ns = bench_sort((Algorithm) algorithm, input, work, size);
+                if (ns < 0.0)
+                {
+                    bench_print_padding(8, 14);
+                    print("UNSORTED");
+                    continue;
+                }
+
+                bench_print_value(ns, 14);
+            }
+
+            print("\n");
+        }
+    }
+
+    platform_free(input);
+    platform_free(work);
+
+    return 0;
+}
\ No newline at end of file
@@ -8,6 +8,12 @@ if "%1"=="release" (
     set link_flags= /NODEFAULTLIB:libcmt.lib /NODEFAULTLIB:libcmtd.lib /NODEFAULTLIB:msvcrtd.lib /SUBSYSTEM:WINDOWS /ENTRY:mainCRTStartup /LTCG
 
     echo BUILDING RELEASE EXECUTABLE
+) else if "%1"=="bench" (
+    set defines= /DGN_USE_OPENGL /DGN_PLATFORM_WINDOWS /DGN_USE_DEDICATED_GPU /DGN_RELEASE /DNDEBUG /DGN_COMPILER_MSVC /DGN_CUSTOM_MAIN
+    set compile_flags= /MT /O2 /EHsc /std:c++17 /MP7
+    set link_flags= /NODEFAULTLIB:libcmt.lib /NODEFAULTLIB:libcmtd.lib /NODEFAULTLIB:msvcrtd.lib /SUBSYSTEM:CONSOLE
+
+    echo BUILDING BENCHMARKS
 ) else (
     set defines= /DGN_USE_OPENGL /DGN_PLATFORM_WINDOWS /DGN_USE_DEDICATED_GPU /DGN_DEBUG /DGN_COMPILER_MSVC
     set compile_flags= /MTd /Zi /EHsc /std:c++17 /cgthreads8 /MP7 /GL
@@ -34,6 +40,8 @@ set libs= shell32.lib                     ^
           dependencies\stb\lib\stb.lib    ^
           dependencies\miniz\lib\miniz.lib
 
+if "%1"=="bench" goto bench
+
 rem Source
 cl %compile_flags% /c src/serialization/json/*.cpp %defines% %includes%   &^
 cl %compile_flags% /c src/serialization/binary/*.cpp %defines% %includes% &^
@@ -56,4 +64,33 @@ rc resources.rc
 link *.obj %libs% *.res /OUT:%executable_name% %link_flags%
 
 rem Remove intermediate files
-del *.obj *.exp *.lib *.res
\ No newline at end of file
+del *.obj *.exp *.lib *.res
+
+goto :eof
+
+rem Every file in bench is its own executable (bench_<name>.exe) linked against the
+rem engine without main.cpp and the sprite editor, GN_CUSTOM_MAIN leaves main to them
+:bench
+if not exist bench_obj mkdir bench_obj
+
+cl %compile_flags% /c src/serialization/json/*.cpp %defines% %includes% /Fobench_obj\   &^
+cl %compile_flags% /c src/serialization/binary/*.cpp %defines% %includes% /Fobench_obj\ &^
+cl %compile_flags% /c src/serialization/slz/*.cpp %defines% %includes% /Fobench_obj\    &^
+cl %compile_flags% /c src/audio/*.cpp %defines% %includes% /Fobench_obj\                &^
+cl %compile_flags% /c src/fileio/*.cpp %defines% %includes% /Fobench_obj\               &^
+cl %compile_flags% /c src/graphics/*.cpp %defines% %includes% /Fobench_obj\             &^
+cl %compile_flags% /c src/platform/*.cpp %defines% %includes% /Fobench_obj\             &^
+cl %compile_flags% /c src/application/*.cpp %defines% %includes% /Fobench_obj\          &^
+cl %compile_flags% /c src/core/*.cpp %defines% %includes% /Fobench_obj\                 &^
+cl %compile_flags% /c src/math/*.cpp %defines% %includes% /Fobench_obj\                 &^
+cl %compile_flags% /c src/engine/*.cpp %defines% %includes% /Fobench_obj\
+
+for %%f in (bench\*.cpp) do (
+    cl %compile_flags% /c %%f %defines% %includes% /I bench
+    link bench_obj\*.obj %%~nf.obj %libs% /OUT:bench_%%~nf.exe %link_flags%
+    del %%~nf.obj
+)
+
+rem Remove intermediate files
+rmdir /s /q bench_obj
+del *.exp *.lib
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "containers/string.h"
-#include "containers/function.h"
+#include "containers/delegate.h"
 #include "math/vecs/vector4.h"
 #include "core/types.h"
 
@@ -47,11 +47,11 @@ struct Application
 
     bool is_running;
 
-    Function<bool (Application& app)> on_init          = [](Application&) -> bool { return true; };
-    Function<void (Application& app)> on_update        = [](Application&) {};
-    Function<void (Application& app)> on_render        = [](Application&) {};
-    Function<void (Application& app)> on_shutdown      = [](Application&) {};
-    Function<void (Application& app)> on_window_resize = [](Application&) {};
+    Delegate<bool (Application& app)> on_init          = [](Application&) -> bool { return true; };
+    Delegate<void (Application& app)> on_update        = [](Application&) {};
+    Delegate<void (Application& app)> on_render        = [](Application&) {};
+    Delegate<void (Application& app)> on_shutdown      = [](Application&) {};
+    Delegate<void (Application& app)> on_window_resize = [](Application&) {};
 };
 
 void application_set_active(Application& app);
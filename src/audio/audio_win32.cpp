@@ -3,6 +3,7 @@
 #ifdef GN_PLATFORM_WINDOWS
 
 #include "containers/bytes.h"
+#include "containers/concurrent_queue.h"
 #include "containers/darray.h"
 #include "containers/hash.h"
 #include "containers/hash_table.h"
@@ -44,7 +45,8 @@ static struct
     HashTable<WavFmtData, u64> idle_source_pool_table;
     HashTable<Source, u64>     active_source_pool_table;
 
-    DynamicArray<Source> sources_to_be_pooled;
+    // Filled from the XAudio2 thread, drained on the main thread in pool_sources
+    MpscQueue<Source> sources_to_be_pooled;
 
     s32 active_sources;
     s32 total_sources;
@@ -61,8 +63,9 @@ public:
     void OnBufferStart(void* pBufferContext) noexcept override {}
     void OnBufferEnd(void* pBufferContext) noexcept override
     {
+        // If the queue is ever full the source just stays active and isn't reused
         if (pBufferContext)
-            append(audio_data.sources_to_be_pooled, (Source) pBufferContext);
+            push(audio_data.sources_to_be_pooled, (Source) pBufferContext);
     }
 
     void OnLoopEnd(void* pBufferContext) noexcept override {}
@@ -102,7 +105,7 @@ bool init()
         audio_data.idle_source_pool_table = make<HashTable<WavFmtData, u64>>();
         audio_data.active_source_pool_table = make<HashTable<Source, u64>>();
 
-        audio_data.sources_to_be_pooled = make<DynamicArray<Source>>();
+        init(audio_data.sources_to_be_pooled, 1024);
 
         audio_data.active_sources = 0;
     }
@@ -127,6 +130,7 @@ void shutdown()
     }
 
     free(audio_data.source_pools);
+    free(audio_data.sources_to_be_pooled);
 }
 
 void source_destroy(Audio::Source& source)
@@ -190,17 +194,23 @@ static inline u64 find_pool_index(const WavFmtData& fmt)
 
 void pool_sources()
 {
-    for (s64 i = audio_data.sources_to_be_pooled.size - 1; i >= 0; i--)
+    Source finished_sources[64];
+    u64 count;
+
+    while ((count = pop_many(audio_data.sources_to_be_pooled, finished_sources, 64)) > 0)
     {
-        Source source = pop(audio_data.sources_to_be_pooled);
-        auto& elem = find(audio_data.active_source_pool_table, source);
+        for (u64 i = 0; i < count; i++)
+        {
+            const Source source = finished_sources[i];
+            auto& elem = find(audio_data.active_source_pool_table, source);
 
-        gn_assert_with_message(elem, "Audio source can't be pooled since it wasn't considered active!");
-        append(audio_data.source_pools[elem.value()], source);
+            gn_assert_with_message(elem, "Audio source can't be pooled since it wasn't considered active!");
+            append(audio_data.source_pools[elem.value()], source);
 
-        remove(elem);   // Remove element from active sources
+            remove(elem);   // Remove element from active sources
 
-        audio_data.active_sources--;
+            audio_data.active_sources--;
+        }
     }
 }
 
@@ -1,39 +1,644 @@
 #pragma once
 
+#include <cstring>
+#include <thread>
+#include "core/types.h"
+#include "core/common.h"
+#include "core/allocator.h"
+#include "core/bit_utils.h"
+#include "core/logger.h"
+#include "math/common.h"
+#include "platform/platform.h"
 #include "darray.h"
 
+// Sorting
+//
+// sort            Pattern defeating quicksort (Orson Peters), O(n log n) worst case through a
+//                 heapsort fallback, linear on sorted, reversed and all equal inputs. Not stable.
+// stable_sort     Bottom up merge sort, needs a temporary buffer of n elements.
+// radix_sort      LSD radix sort on integer or float keys, 8 bits per pass. Stable, needs a
+//                 temporary buffer of n elements. Passes where every key has the same byte are skipped.
+// parallel_sort   Sorts chunks on separate threads and merges them, falls back to sort for small arrays.
+//
+// Comparators are callables that return true when a goes before b, the *_by versions take a
+// projection that maps elements to the key they're compared (or radix sorted) by.
+// Temporary buffers come from the allocator (null means the heap).
+
 template <typename T>
-inline u64 q_sort_partition(T* array, int start, int end)
+struct Less
+{
+    inline bool operator()(const T& a, const T& b) const
+    {
+        return a < b;
+    }
+};
+
+template <typename Projection>
+struct ProjectionLess
+{
+    Projection key;
+
+    template <typename T>
+    inline bool operator()(const T& a, const T& b) const
+    {
+        return key(a) < key(b);
+    }
+};
+
+namespace SortInternal
+{
+
+constexpr u64 INSERTION_SORT_THRESHOLD = 24;
+constexpr u64 NINTHER_THRESHOLD        = 128;
+constexpr u64 PARTIAL_INSERTION_LIMIT  = 8;
+
+template <typename T, typename Compare>
+inline void insertion_sort(T* begin, T* end, Compare& less)
+{
+    if (begin == end)
+        return;
+
+    for (T* current = begin + 1; current != end; current++)
+    {
+        T* sift = current;
+        T* sift_1 = current - 1;
+
+        if (less(*sift, *sift_1))
+        {
+            T temp = *sift;
+
+            do { *sift-- = *sift_1; }
+            while (sift != begin && less(temp, *--sift_1));
+
+            *sift = temp;
+        }
+    }
+}
+
+// Assumes there is an element before begin that is <= every element in the range
+template <typename T, typename Compare>
+inline void unguarded_insertion_sort(T* begin, T* end, Compare& less)
+{
+    if (begin == end)
+        return;
+
+    for (T* current = begin + 1; current != end; current++)
+    {
+        T* sift = current;
+        T* sift_1 = current - 1;
+
+        if (less(*sift, *sift_1))
+        {
+            T temp = *sift;
+
+            do { *sift-- = *sift_1; }
+            while (less(temp, *--sift_1));
+
+            *sift = temp;
+        }
+    }
+}
+
+// Gives up if more than a few elements had to be moved, returns true if the range got sorted
+template <typename T, typename Compare>
+inline bool partial_insertion_sort(T* begin, T* end, Compare& less)
+{
+    if (begin == end)
+        return true;
+
+    u64 moved = 0;
+    for (T* current = begin + 1; current != end; current++)
+    {
+        T* sift = current;
+        T* sift_1 = current - 1;
+
+        if (less(*sift, *sift_1))
+        {
+            T temp = *sift;
+
+            do { *sift-- = *sift_1; }
+            while (sift != begin && less(temp, *--sift_1));
+
+            *sift = temp;
+            moved += current - sift;
+        }
+
+        if (moved > PARTIAL_INSERTION_LIMIT)
+            return false;
+    }
+
+    return true;
+}
+
+template <typename T, typename Compare>
+inline void sort2(T* a, T* b, Compare& less)
+{
+    if (less(*b, *a))
+        swap(*a, *b);
+}
+
+template <typename T, typename Compare>
+inline void sort3(T* a, T* b, T* c, Compare& less)
+{
+    sort2(a, b, less);
+    sort2(b, c, less);
+    sort2(a, b, less);
+}
+
+template <typename T, typename Compare>
+inline void sift_down(T* heap, u64 index, u64 count, Compare& less)
+{
+    T value = heap[index];
+
+    while (true)
+    {
+        u64 child = 2 * index + 1;
+        if (child >= count)
+            break;
+
+        if (child + 1 < count && less(heap[child], heap[child + 1]))
+            child++;
+
+        if (!less(value, heap[child]))
+            break;
+
+        heap[index] = heap[child];
+        index = child;
+    }
+
+    heap[index] = value;
+}
+
+template <typename T, typename Compare>
+inline void heap_sort(T* begin, T* end, Compare& less)
+{
+    const u64 count = end - begin;
+
+    for (u64 i = count / 2; i > 0; i--)
+        sift_down(begin, i - 1, count, less);
+
+    for (u64 i = count; i > 1; i--)
+    {
+        swap(begin[0], begin[i - 1]);
+        sift_down(begin, 0, i - 1, less);
+    }
+}
+
+// Pivot is at begin, elements equal to the pivot go to the right.
+// Returns the final position of the pivot, already_partitioned is set if no elements were swapped.
+template <typename T, typename Compare>
+inline T* partition_right(T* begin, T* end, Compare& less, bool& already_partitioned)
+{
+    T pivot = *begin;
+    T* first = begin;
+    T* last = end;
+
+    // Median of 3 guarantees there is an element >= pivot, so this can't run off the end
+    while (less(*++first, pivot));
+
+    // If the first element was already in place there is no guard on the right side
+    if (first - 1 == begin)
+        while (first < last && !less(*--last, pivot));
+    else
+        while (!less(*--last, pivot));
+
+    already_partitioned = first >= last;
+
+    while (first < last)
+    {
+        swap(*first, *last);
+        while (less(*++first, pivot));
+        while (!less(*--last, pivot));
+    }
+
+    T* pivot_position = first - 1;
+    *begin = *pivot_position;
+    *pivot_position = pivot;
+
+    return pivot_position;
+}
+
+// Elements equal to the pivot go to the left. Used when the pivot is equal to the element
+// before the range, so everything equal to it is already in its final place.
+template <typename T, typename Compare>
+inline T* partition_left(T* begin, T* end, Compare& less)
+{
+    T pivot = *begin;
+    T* first = begin;
+    T* last = end;
+
+    while (less(pivot, *--last));
+
+    if (last + 1 == end)
+        while (first < last && !less(pivot, *++first));
+    else
+        while (!less(pivot, *++first));
+
+    while (first < last)
+    {
+        swap(*first, *last);
+        while (less(pivot, *--last));
+        while (!less(pivot, *++first));
+    }
+
+    T* pivot_position = last;
+    *begin = *pivot_position;
+    *pivot_position = pivot;
+
+    return pivot_position;
+}
+
+template <typename T, typename Compare>
+void pdq_sort_loop(T* begin, T* end, Compare& less, s32 bad_allowed, bool leftmost)
+{
+    while (true)
+    {
+        const u64 size = end - begin;
+
+        if (size < INSERTION_SORT_THRESHOLD)
+        {
+            if (leftmost)
+                insertion_sort(begin, end, less);
+            else
+                unguarded_insertion_sort(begin, end, less);
+
+            return;
+        }
+
+        {   // Move the pivot to begin, pseudo median of 9 for large ranges
+            const u64 half = size / 2;
+            if (size > NINTHER_THRESHOLD)
+            {
+                sort3(begin, begin + half, end - 1, less);
+                sort3(begin + 1, begin + (half - 1), end - 2, less);
+                sort3(begin + 2, begin + (half + 1), end - 3, less);
+                sort3(begin + (half - 1), begin + half, begin + (half + 1), less);
+                swap(*begin, *(begin + half));
+            }
+            else
+            {
+                sort3(begin + half, begin, end - 1, less);
+            }
+        }
+
+        // Pivot is equal to the element before the range, all the elements equal to it can be skipped
+        if (!leftmost && !less(*(begin - 1), *begin))
+        {
+            begin = partition_left(begin, end, less) + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        T* pivot_position = partition_right(begin, end, less, already_partitioned);
+
+        const u64 left_size  = pivot_position - begin;
+        const u64 right_size = end - (pivot_position + 1);
+
+        if (left_size < size / 8 || right_size < size / 8)
+        {
+            // Too many bad partitions, switch to heapsort to guarantee n log n
+            if (--bad_allowed == 0)
+            {
+                heap_sort(begin, end, less);
+                return;
+            }
+
+            // Shuffle some elements around to break patterns
+            if (left_size >= INSERTION_SORT_THRESHOLD)
+            {
+                swap(*begin, *(begin + left_size / 4));
+                swap(*(pivot_position - 1), *(pivot_position - left_size / 4));
+
+                if (left_size > NINTHER_THRESHOLD)
+                {
+                    swap(*(begin + 1), *(begin + (left_size / 4 + 1)));
+                    swap(*(begin + 2), *(begin + (left_size / 4 + 2)));
+                    swap(*(pivot_position - 2), *(pivot_position - (left_size / 4 + 1)));
+                    swap(*(pivot_position - 3), *(pivot_position - (left_size / 4 + 2)));
+                }
+            }
+
+            if (right_size >= INSERTION_SORT_THRESHOLD)
+            {
+                swap(*(pivot_position + 1), *(pivot_position + (1 + right_size / 4)));
+                swap(*(end - 1), *(end - right_size / 4));
+
+                if (right_size > NINTHER_THRESHOLD)
+                {
+                    swap(*(pivot_position + 2), *(pivot_position + (2 + right_size / 4)));
+                    swap(*(pivot_position + 3), *(pivot_position + (3 + right_size / 4)));
+                    swap(*(end - 2), *(end - (1 + right_size / 4)));
+                    swap(*(end - 3), *(end - (2 + right_size / 4)));
+                }
+            }
+        }
+        else if (already_partitioned)
+        {
+            // Probably already sorted, try finishing with a bounded insertion sort
+            if (partial_insertion_sort(begin, pivot_position, less) && partial_insertion_sort(pivot_position + 1, end, less))
+                return;
+        }
+
+        // Recurse on the left side, loop on the right side
+        pdq_sort_loop(begin, pivot_position, less, bad_allowed, leftmost);
+        begin = pivot_position + 1;
+        leftmost = false;
+    }
+}
+
+// Merges the sorted ranges [left, middle) and [middle, end) into out
+template <typename T, typename Compare>
+inline void merge(const T* left, const T* middle, const T* end, T* out, Compare& less)
+{
+    const T* right = middle;
+
+    while (left < middle && right < end)
+    {
+        // Take from the right only if it's strictly smaller, keeps the merge stable
+        if (less(*right, *left))
+            *out++ = *right++;
+        else
+            *out++ = *left++;
+    }
+
+    while (left < middle)
+        *out++ = *left++;
+
+    while (right < end)
+        *out++ = *right++;
+}
+
+constexpr u64 MERGE_SORT_RUN_SIZE = 32;
+
+// Sorts data, buffer must be able to hold count elements
+template <typename T, typename Compare>
+void merge_sort(T* data, T* buffer, u64 count, Compare& less)
 {
-    const T& pivot = array[end];
-    u64 left_end = start - 1;  // Index for end of left partition
+    // Sort small runs in place first
+    for (u64 start = 0; start < count; start += MERGE_SORT_RUN_SIZE)
+        insertion_sort(data + start, data + min(start + MERGE_SORT_RUN_SIZE, count), less);
 
-    for (u64 i = start; i <= end - 1; i++)
+    T* from = data;
+    T* to = buffer;
+
+    for (u64 width = MERGE_SORT_RUN_SIZE; width < count; width *= 2)
     {
-        if (array[i] < pivot)
+        for (u64 start = 0; start < count; start += 2 * width)
         {
-            left_end++;
-            swap(array[left_end], array[i]);
+            const u64 middle = min(start + width, count);
+            const u64 end = min(start + 2 * width, count);
+            merge(from + start, from + middle, from + end, to + start, less);
         }
+
+        swap(from, to);
     }
 
-    swap(array[left_end + 1], array[end]);
-    return left_end + 1;
+    if (from != data)
+        platform_copy_memory(data, from, count * sizeof(T));
+}
+
+// Maps keys to unsigned integers with the same ordering
+inline u32 radix_key(u8 key)  { return key; }
+inline u32 radix_key(u16 key) { return key; }
+inline u32 radix_key(u32 key) { return key; }
+inline u64 radix_key(u64 key) { return key; }
+inline u32 radix_key(s8 key)  { return (u8) key ^ 0x80u; }
+inline u32 radix_key(s16 key) { return (u16) key ^ 0x8000u; }
+inline u32 radix_key(s32 key) { return (u32) key ^ 0x80000000u; }
+inline u64 radix_key(s64 key) { return (u64) key ^ 0x8000000000000000ull; }
+
+// Negative floats have all bits flipped so they sort in reverse, positive floats only get the sign bit set
+inline u32 radix_key(f32 key)
+{
+    u32 bits;
+    memcpy(&bits, &key, sizeof(u32));
+    return bits ^ ((u32) ((s32) bits >> 31) | 0x80000000u);
+}
+
+inline u64 radix_key(f64 key)
+{
+    u64 bits;
+    memcpy(&bits, &key, sizeof(u64));
+    return bits ^ ((u64) ((s64) bits >> 63) | 0x8000000000000000ull);
+}
+
+struct Identity
+{
+    template <typename T>
+    inline const T& operator()(const T& value) const
+    {
+        return value;
+    }
+};
+
+template <typename T, typename Projection>
+void radix_sort(T* data, T* buffer, u64 count, Projection& key)
+{
+    using Key = decltype(radix_key(key(*data)));
+    constexpr u32 passes = sizeof(Key);
+
+    // All the histograms are built in a single pass over the data
+    u64 histograms[passes][256] = {};
+    for (u64 i = 0; i < count; i++)
+    {
+        const Key k = radix_key(key(data[i]));
+        for (u32 pass = 0; pass < passes; pass++)
+            histograms[pass][(k >> (pass * 8)) & 0xFF]++;
+    }
+
+    T* from = data;
+    T* to = buffer;
+
+    for (u32 pass = 0; pass < passes; pass++)
+    {
+        u64* histogram = histograms[pass];
+        const u32 shift = pass * 8;
+
+        // Every key has the same byte, nothing would move
+        if (histogram[(radix_key(key(from[0])) >> shift) & 0xFF] == count)
+            continue;
+
+        // Turn counts into offsets
+        u64 offset = 0;
+        for (u32 i = 0; i < 256; i++)
+        {
+            const u64 bucket_count = histogram[i];
+            histogram[i] = offset;
+            offset += bucket_count;
+        }
+
+        for (u64 i = 0; i < count; i++)
+        {
+            const u32 digit = (radix_key(key(from[i])) >> shift) & 0xFF;
+            to[histogram[digit]++] = from[i];
+        }
+
+        swap(from, to);
+    }
+
+    if (from != data)
+        platform_copy_memory(data, from, count * sizeof(T));
+}
+
+template <typename T>
+inline T* allocate_buffer(Allocator* allocator, u64 count)
+{
+    T* buffer = (T*) allocator_allocate(allocator, count * sizeof(T), darray_alignment<T>());
+    gn_assert_with_message(buffer, "Could not allocate temporary buffer for sorting! (element count: %)", count);
+    return buffer;
 }
 
 template <typename T>
-inline void q_sort(T* array, int start, int end)
+inline void free_buffer(Allocator* allocator, T* buffer)
 {
-    if (start < end)
+    allocator_free(allocator, buffer, darray_alignment<T>());
+}
+
+} // namespace SortInternal
+
+template <typename T, typename Compare = Less<T>>
+inline void sort(T* data, u64 count, Compare less = Compare {})
+{
+    if (count < 2)
+        return;
+
+    // Bad partitions allowed before falling back to heapsort
+    const s32 bad_allowed = 64 - (s32) count_leading_zeros(count);
+    SortInternal::pdq_sort_loop(data, data + count, less, bad_allowed, true);
+}
+
+template <typename T, typename Compare = Less<T>>
+inline void sort(DynamicArray<T>& array, Compare less = Compare {})
+{
+    sort(array.data, array.size, less);
+}
+
+template <typename T, typename Projection>
+inline void sort_by(DynamicArray<T>& array, Projection key)
+{
+    sort(array.data, array.size, ProjectionLess<Projection> { key });
+}
+
+template <typename T, typename Compare = Less<T>>
+inline void stable_sort(T* data, u64 count, Compare less = Compare {}, Allocator* allocator = nullptr)
+{
+    if (count < 2)
+        return;
+
+    if (count <= SortInternal::MERGE_SORT_RUN_SIZE)
     {
-        u64 partition_idx = q_sort_partition(array, start, end);
-        q_sort(array, start, partition_idx - 1);
-        q_sort(array, partition_idx + 1, end);
+        SortInternal::insertion_sort(data, data + count, less);
+        return;
     }
+
+    T* buffer = SortInternal::allocate_buffer<T>(allocator, count);
+    SortInternal::merge_sort(data, buffer, count, less);
+    SortInternal::free_buffer(allocator, buffer);
+}
+
+template <typename T, typename Compare = Less<T>>
+inline void stable_sort(DynamicArray<T>& array, Compare less = Compare {}, Allocator* allocator = nullptr)
+{
+    stable_sort(array.data, array.size, less, allocator);
+}
+
+template <typename T, typename Projection>
+inline void stable_sort_by(DynamicArray<T>& array, Projection key, Allocator* allocator = nullptr)
+{
+    stable_sort(array.data, array.size, ProjectionLess<Projection> { key }, allocator);
+}
+
+// Key has to be an integer or a float (NaNs end up on either end depending on their sign)
+template <typename T, typename Projection>
+inline void radix_sort_by(T* data, u64 count, Projection key, Allocator* allocator = nullptr)
+{
+    if (count < 2)
+        return;
+
+    T* buffer = SortInternal::allocate_buffer<T>(allocator, count);
+    SortInternal::radix_sort(data, buffer, count, key);
+    SortInternal::free_buffer(allocator, buffer);
+}
+
+template <typename T, typename Projection>
+inline void radix_sort_by(DynamicArray<T>& array, Projection key, Allocator* allocator = nullptr)
+{
+    radix_sort_by(array.data, array.size, key, allocator);
 }
 
 template <typename T>
-inline void sort(DynamicArray<T>& array)
+inline void radix_sort(DynamicArray<T>& array, Allocator* allocator = nullptr)
 {
-    q_sort(array.data, 0, array.size - 1);
+    radix_sort_by(array.data, array.size, SortInternal::Identity {}, allocator);
+}
+
+// Arrays smaller than this aren't worth starting threads for
+constexpr u64 PARALLEL_SORT_THRESHOLD = 64 * 1024;
+
+// Not stable. Comparator gets called from multiple threads.
+template <typename T, typename Compare = Less<T>>
+void parallel_sort(DynamicArray<T>& array, Compare less = Compare {}, Allocator* allocator = nullptr)
+{
+    const u64 count = array.size;
+    const u64 hardware_threads = max((u64) std::thread::hardware_concurrency(), 1ull);
+    const u64 max_threads = 64;
+
+    // Power of 2 number of chunks so they merge evenly
+    u64 chunk_count = 1;
+    while (chunk_count * 2 <= min(hardware_threads, max_threads) && count / (chunk_count * 2) >= PARALLEL_SORT_THRESHOLD)
+        chunk_count *= 2;
+
+    if (chunk_count == 1)
+    {
+        sort(array.data, count, less);
+        return;
+    }
+
+    u64 bounds[max_threads + 1];
+    for (u64 i = 0; i <= chunk_count; i++)
+        bounds[i] = count * i / chunk_count;
+
+    std::thread threads[max_threads];
+
+    {   // Sort every chunk on its own thread
+        for (u64 i = 0; i < chunk_count; i++)
+        {
+            T* begin = array.data + bounds[i];
+            const u64 size = bounds[i + 1] - bounds[i];
+            threads[i] = std::thread([begin, size, less]() { sort(begin, size, less); });
+        }
+
+        for (u64 i = 0; i < chunk_count; i++)
+            threads[i].join();
+    }
+
+    T* buffer = SortInternal::allocate_buffer<T>(allocator, count);
+    T* from = array.data;
+    T* to = buffer;
+
+    // Merge pairs of chunks until there is only one left, every merge in a round gets a thread
+    for (u64 width = 1; width < chunk_count; width *= 2)
+    {
+        const u64 merge_count = chunk_count / (2 * width);
+        for (u64 i = 0; i < merge_count; i++)
+        {
+            const u64 start  = bounds[2 * width * i];
+            const u64 middle = bounds[2 * width * i + width];
+            const u64 end    = bounds[2 * width * (i + 1)];
+
+            threads[i] = std::thread([from, to, start, middle, end, less]() mutable {
+                SortInternal::merge(from + start, from + middle, from + end, to + start, less);
+            });
+        }
+
+        for (u64 i = 0; i < merge_count; i++)
+            threads[i].join();
+
+        swap(from, to);
+    }
+
+    if (from != array.data)
+        platform_copy_memory(array.data, from, count * sizeof(T));
+
+    SortInternal::free_buffer(allocator, buffer);
 }
\ No newline at end of file
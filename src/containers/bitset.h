@@ -0,0 +1,281 @@
+#pragma once
+
+#include <emmintrin.h>
+
+#include "core/common.h"
+#include "core/allocator.h"
+#include "core/bit_utils.h"
+#include "core/logger.h"
+#include "core/types.h"
+#include "math/common.h"
+#include "platform/platform.h"
+
+// Growable set of bits stored in 64 bit words, meant for membership sets over small
+// dense indices (selections, pending deletions, visited flags). Bits past size are
+// always kept at 0 so counting and searching never have to mask the last word.
+
+struct DynamicBitSet
+{
+    u64* words;
+    u64  size;          // Number of bits
+    u64  capacity;      // Number of words
+
+    Allocator* allocator;   // Null means the platform heap
+};
+
+namespace BitSetInternal
+{
+    constexpr u64 BITS_PER_WORD = 64;
+
+    inline u64 word_count(u64 bit_count)
+    {
+        return (bit_count + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    }
+
+    // Mask of the valid bits in the last word (all of them if the size is a multiple of 64)
+    inline u64 tail_mask(u64 bit_count)
+    {
+        const u64 used = bit_count % BITS_PER_WORD;
+        return (used) ? (1ui64 << used) - 1 : ~0ui64;
+    }
+
+    // Mask with bits [first, last) set, both within the same word
+    inline u64 range_mask(u64 first, u64 last)
+    {
+        const u64 high = (last == BITS_PER_WORD) ? ~0ui64 : (1ui64 << last) - 1;
+        return high & ~((1ui64 << first) - 1);
+    }
+
+    inline void clear_tail(DynamicBitSet& bits)
+    {
+        if (bits.size % BITS_PER_WORD)
+            bits.words[bits.size / BITS_PER_WORD] &= tail_mask(bits.size);
+    }
+}
+
+inline DynamicBitSet make(Type<DynamicBitSet>, u64 bit_count = 0, Allocator* allocator = nullptr)
+{
+    DynamicBitSet bits = {};
+
+    bits.size = bit_count;
+    bits.capacity = max(BitSetInternal::word_count(bit_count), 2ui64);
+    bits.allocator = allocator;
+    bits.words = (u64*) allocator_allocate(bits.allocator, bits.capacity * sizeof(u64), DEFAULT_ALIGNMENT);
+    gn_assert_with_message(bits.words, "Could not allocate data for bit set!");
+
+    platform_zero_memory(bits.words, bits.capacity * sizeof(u64));
+    return bits;
+}
+
+inline void free(DynamicBitSet& bits)
+{
+    allocator_free(bits.allocator, bits.words, DEFAULT_ALIGNMENT);
+
+    bits.words = nullptr;
+    bits.size = bits.capacity = 0;
+}
+
+// Changes the number of bits, bits added at the end start out as 0
+inline void resize(DynamicBitSet& bits, u64 bit_count)
+{
+    const u64 old_word_count = BitSetInternal::word_count(bits.size);
+    const u64 new_word_count = BitSetInternal::word_count(bit_count);
+
+    if (new_word_count > bits.capacity)
+    {
+        const u64 new_capacity = max(2 * bits.capacity, new_word_count);
+        bits.words = (u64*) allocator_reallocate(bits.allocator, bits.words, bits.capacity * sizeof(u64), new_capacity * sizeof(u64), DEFAULT_ALIGNMENT);
+        gn_assert_with_message(bits.words, "Could not reallocate data for bit set! (new capacity: %)", new_capacity);
+
+        bits.capacity = new_capacity;
+    }
+
+    if (new_word_count > old_word_count)
+        platform_zero_memory(bits.words + old_word_count, (new_word_count - old_word_count) * sizeof(u64));
+
+    bits.size = bit_count;
+    BitSetInternal::clear_tail(bits);
+}
+
+inline bool test_bit(const DynamicBitSet& bits, u64 index)
+{
+    gn_assert_with_message(index < bits.size, "Bit index out of bounds! (index: %, bit set size: %)", index, bits.size);
+    return (bits.words[index / 64] >> (index % 64)) & 1;
+}
+
+inline void set_bit(DynamicBitSet& bits, u64 index)
+{
+    gn_assert_with_message(index < bits.size, "Bit index out of bounds! (index: %, bit set size: %)", index, bits.size);
+    bits.words[index / 64] |= 1ui64 << (index % 64);
+}
+
+inline void clear_bit(DynamicBitSet& bits, u64 index)
+{
+    gn_assert_with_message(index < bits.size, "Bit index out of bounds! (index: %, bit set size: %)", index, bits.size);
+    bits.words[index / 64] &= ~(1ui64 << (index % 64));
+}
+
+inline void toggle_bit(DynamicBitSet& bits, u64 index)
+{
+    gn_assert_with_message(index < bits.size, "Bit index out of bounds! (index: %, bit set size: %)", index, bits.size);
+    bits.words[index / 64] ^= 1ui64 << (index % 64);
+}
+
+// Sets or clears bits [first, first + count) a word at a time
+inline void set_range(DynamicBitSet& bits, u64 first, u64 count, bool value = true)
+{
+    gn_assert_with_message(first + count <= bits.size, "Bit range out of bounds! (first: %, count: %, bit set size: %)", first, count, bits.size);
+
+    const u64 last = first + count;
+    u64 index = first;
+
+    while (index < last)
+    {
+        const u64 word_index = index / 64;
+        const u64 word_end   = min((word_index + 1) * 64, last);
+        const u64 mask       = BitSetInternal::range_mask(index % 64, word_end - word_index * 64);
+
+        if (value)
+            bits.words[word_index] |= mask;
+        else
+            bits.words[word_index] &= ~mask;
+
+        index = word_end;
+    }
+}
+
+inline void clear_range(DynamicBitSet& bits, u64 first, u64 count)
+{
+    set_range(bits, first, count, false);
+}
+
+inline void set_all(DynamicBitSet& bits)
+{
+    platform_set_memory(bits.words, 0xFF, BitSetInternal::word_count(bits.size) * sizeof(u64));
+    BitSetInternal::clear_tail(bits);
+}
+
+// Keeps the size, only the bits are reset
+inline void clear_all(DynamicBitSet& bits)
+{
+    platform_zero_memory(bits.words, BitSetInternal::word_count(bits.size) * sizeof(u64));
+}
+
+inline u64 count_set_bits(const DynamicBitSet& bits)
+{
+    const u64 word_count = BitSetInternal::word_count(bits.size);
+
+    u64 count = 0;
+    for (u64 i = 0; i < word_count; i++)
+        count += pop_count(bits.words[i]);
+
+    return count;
+}
+
+inline bool any_set(const DynamicBitSet& bits)
+{
+    const u64 word_count = BitSetInternal::word_count(bits.size);
+
+    for (u64 i = 0; i < word_count; i++)
+    {
+        if (bits.words[i])
+            return true;
+    }
+
+    return false;
+}
+
+// Index of the first set bit at or after start, returns the size if there isn't one
+inline u64 find_next_set(const DynamicBitSet& bits, u64 start = 0)
+{
+    if (start >= bits.size)
+        return bits.size;
+
+    const u64 word_count = BitSetInternal::word_count(bits.size);
+
+    u64 word_index = start / 64;
+    u64 word = bits.words[word_index] & (~0ui64 << (start % 64));
+
+    while (true)
+    {
+        if (word)
+            return word_index * 64 + count_trailing_zeros(word);
+
+        if (++word_index == word_count)
+            return bits.size;
+
+        word = bits.words[word_index];
+    }
+}
+
+// Calls the callback with the index of every set bit in increasing order.
+// Only the current word is cached, so bits can be cleared from the callback.
+template <typename Callback>
+inline void for_each_set_bit(const DynamicBitSet& bits, Callback callback)
+{
+    const u64 word_count = BitSetInternal::word_count(bits.size);
+
+    for (u64 word_index = 0; word_index < word_count; word_index++)
+    {
+        u64 word = bits.words[word_index];
+        while (word)
+        {
+            callback(word_index * 64 + count_trailing_zeros(word));
+            word &= word - 1;
+        }
+    }
+}
+
+namespace BitSetInternal
+{
+    // Applies the operation to the words of both sets, two words per SSE2 op
+    template <typename WideOperation, typename Operation>
+    inline void combine(DynamicBitSet& dest, const DynamicBitSet& src, WideOperation wide_op, Operation op)
+    {
+        gn_assert_with_message(dest.size == src.size, "Bit sets need to be the same size! (dest size: %, src size: %)", dest.size, src.size);
+
+        const u64 word_count = BitSetInternal::word_count(dest.size);
+
+        u64 i = 0;
+        for (; i + 2 <= word_count; i += 2)
+        {
+            const __m128i a = _mm_loadu_si128((const __m128i*) (dest.words + i));
+            const __m128i b = _mm_loadu_si128((const __m128i*) (src.words + i));
+            _mm_storeu_si128((__m128i*) (dest.words + i), wide_op(a, b));
+        }
+
+        for (; i < word_count; i++)
+            dest.words[i] = op(dest.words[i], src.words[i]);
+    }
+}
+
+// Bulk operations, the result is stored in dest (both sets need to be the same size)
+
+inline void bitset_or(DynamicBitSet& dest, const DynamicBitSet& src)
+{
+    BitSetInternal::combine(dest, src,
+        [](__m128i a, __m128i b) { return _mm_or_si128(a, b); },
+        [](u64 a, u64 b) { return a | b; });
+}
+
+inline void bitset_and(DynamicBitSet& dest, const DynamicBitSet& src)
+{
+    BitSetInternal::combine(dest, src,
+        [](__m128i a, __m128i b) { return _mm_and_si128(a, b); },
+        [](u64 a, u64 b) { return a & b; });
+}
+
+inline void bitset_xor(DynamicBitSet& dest, const DynamicBitSet& src)
+{
+    BitSetInternal::combine(dest, src,
+        [](__m128i a, __m128i b) { return _mm_xor_si128(a, b); },
+        [](u64 a, u64 b) { return a ^ b; });
+}
+
+// Removes the bits set in src from dest
+inline void bitset_and_not(DynamicBitSet& dest, const DynamicBitSet& src)
+{
+    BitSetInternal::combine(dest, src,
+        [](__m128i a, __m128i b) { return _mm_andnot_si128(b, a); },
+        [](u64 a, u64 b) { return a & ~b; });
+}
\ No newline at end of file
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <emmintrin.h>
+
+#include "core/common.h"
+#include "core/allocator.h"
+#include "core/bit_utils.h"
+#include "core/logger.h"
+#include "core/types.h"
+#include "platform/platform.h"
+#include "darray.h"
+#include "hash_table.h"
+
+// Hash table that can be shared between threads, for process wide caches.
+// Keys are split between shards by their hash and every shard is a regular HashTable
+// guarded by a spin lock for writers and a sequence counter for readers:
+//  - Writers take the shard's lock and make the sequence odd while they change the table.
+//    The lock is only held for the table operation itself, find_or_insert builds values without it.
+//  - Readers don't write anything, they read the table and retry if the sequence was
+//    odd or changed in the meantime, so reads never contend with each other.
+// A reader can race a writer that's growing the table, so shard tables allocate from
+// an arena and the blocks they grew out of are only released when the map is freed.
+// Since a racing reader can see half written slots, keys and values need to be
+// trivially copyable and keys must compare without following pointers (ids, atoms,
+// handles, plain structs, not Strings).
+
+#define CONCURRENT_HASH_MAP_TEMPLATE template <typename KeyType, typename ValueType, typename Hasher = Hasher<KeyType>>
+
+namespace ConcurrentHashMapInternal
+{
+    constexpr u32 DEFAULT_SHARD_COUNT = 16;
+    constexpr u64 SHARD_ARENA_BLOCK_SIZE = 4 * 1024;
+
+    CONCURRENT_HASH_MAP_TEMPLATE
+    struct Shard
+    {
+        alignas(CACHE_LINE_SIZE) std::atomic<u32> sequence;     // Odd while a writer is changing the table
+        std::atomic<bool> locked;                               // Only taken by writers
+
+        Arena storage;
+        HashTable<KeyType, ValueType, Hasher> table;
+
+        // Keys find_or_insert is making a value for right now, only used with the lock held
+        DynamicArray<KeyType> pending;
+    };
+}
+
+CONCURRENT_HASH_MAP_TEMPLATE
+struct ConcurrentHashMap
+{
+    using Shard = ConcurrentHashMapInternal::Shard<KeyType, ValueType, Hasher>;
+
+    static_assert(__is_trivially_copyable(KeyType),   "Keys of a concurrent hash map need to be trivially copyable!");
+    static_assert(__is_trivially_copyable(ValueType), "Values of a concurrent hash map need to be trivially copyable!");
+
+    Shard* shards;      // Atomics can't be copied, so they live behind a pointer and the map itself can be
+    u32 shard_shift;    // Shards are picked with the top bits of the hash
+
+    Hasher hasher;
+    Allocator* allocator;   // Null means the platform heap, only used for the shard array
+};
+
+namespace ConcurrentHashMapInternal
+{
+    CONCURRENT_HASH_MAP_TEMPLATE
+    inline Shard<KeyType, ValueType, Hasher>& get_shard(const ConcurrentHashMap<KeyType, ValueType, Hasher>& map, Hash hash)
+    {
+        // The table uses the low bits of the hash, so the shard gets the high ones
+        return map.shards[(u64) hash >> map.shard_shift];
+    }
+
+    // Call with the lock held
+    CONCURRENT_HASH_MAP_TEMPLATE
+    inline u64 find_pending(const Shard<KeyType, ValueType, Hasher>& shard, const KeyType& key)
+    {
+        for (u64 i = 0; i < shard.pending.size; i++)
+        {
+            if (shard.pending[i] == key)
+                return i;
+        }
+
+        return shard.pending.size;
+    }
+
+    CONCURRENT_HASH_MAP_TEMPLATE
+    inline void lock_shard(Shard<KeyType, ValueType, Hasher>& shard)
+    {
+        while (shard.locked.exchange(true, std::memory_order_acquire))
+        {
+            while (shard.locked.load(std::memory_order_relaxed))
+                _mm_pause();
+        }
+    }
+
+    CONCURRENT_HASH_MAP_TEMPLATE
+    inline void unlock_shard(Shard<KeyType, ValueType, Hasher>& shard)
+    {
+        shard.locked.store(false, std::memory_order_release);
+    }
+
+    // Call with the lock held, readers retry until end_write is called
+    CONCURRENT_HASH_MAP_TEMPLATE
+    inline void begin_write(Shard<KeyType, ValueType, Hasher>& shard)
+    {
+        shard.sequence.store(shard.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    CONCURRENT_HASH_MAP_TEMPLATE
+    inline void end_write(Shard<KeyType, ValueType, Hasher>& shard)
+    {
+        shard.sequence.store(shard.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Lock free lookup, returns false if the key isn't in the shard
+    CONCURRENT_HASH_MAP_TEMPLATE
+    inline bool read(const Shard<KeyType, ValueType, Hasher>& shard, const KeyType& key, Hash hash, ValueType& out_value)
+    {
+        while (true)
+        {
+            const u32 sequence = shard.sequence.load(std::memory_order_acquire);
+            if (sequence & 1)
+            {
+                _mm_pause();
+                continue;
+            }
+
+            // The table header could be torn if a writer grew the table, only use it once the sequence checks out
+            const HashTable<KeyType, ValueType, Hasher> table = shard.table;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (shard.sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+
+            const u32 index = find_index(table, key, hash);
+            const bool found = index < table.capacity;
+            if (found)
+                out_value = table.values[index];
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (shard.sequence.load(std::memory_order_relaxed) == sequence)
+                return found;
+        }
+    }
+}
+
+// Shard count is rounded up to a power of 2
+CONCURRENT_HASH_MAP_TEMPLATE
+inline ConcurrentHashMap<KeyType, ValueType, Hasher> make(Type<ConcurrentHashMap<KeyType, ValueType, Hasher>>, u32 shard_count = ConcurrentHashMapInternal::DEFAULT_SHARD_COUNT, u32 shard_start_cap = HashTableInternal::MIN_CAPACITY, Allocator* allocator = nullptr)
+{
+    using Shard = ConcurrentHashMapInternal::Shard<KeyType, ValueType, Hasher>;
+
+    shard_count = next_power_of_2(max(shard_count, 1u));
+
+    ConcurrentHashMap<KeyType, ValueType, Hasher> map = {};
+    map.allocator = allocator;
+    map.shard_shift = 32 - count_trailing_zeros(shard_count);
+
+    map.shards = (Shard*) allocator_allocate(map.allocator, shard_count * sizeof(Shard), alignof(Shard));
+    gn_assert_with_message(map.shards, "Could not allocate shards for concurrent hash map! (shard count: %)", shard_count);
+
+    for (u32 i = 0; i < shard_count; i++)
+    {
+        Shard& shard = map.shards[i];
+
+        new (&shard.sequence) std::atomic<u32>(0);
+        new (&shard.locked)   std::atomic<bool>(false);
+
+        shard.storage = make<Arena>(ConcurrentHashMapInternal::SHARD_ARENA_BLOCK_SIZE);
+        shard.table = make<HashTable<KeyType, ValueType, Hasher>>(shard_start_cap, arena_allocator(shard.storage));
+        shard.table.hasher = map.hasher;
+
+        shard.pending = make<DynamicArray<KeyType>>(4ui64);
+    }
+
+    return map;
+}
+
+CONCURRENT_HASH_MAP_TEMPLATE
+inline u32 concurrent_hash_map_shard_count(const ConcurrentHashMap<KeyType, ValueType, Hasher>& map)
+{
+    return (u32) (1ui64 << (32 - map.shard_shift));
+}
+
+// No other thread can be using the map at this point
+CONCURRENT_HASH_MAP_TEMPLATE
+inline void free(ConcurrentHashMap<KeyType, ValueType, Hasher>& map)
+{
+    using Shard = ConcurrentHashMapInternal::Shard<KeyType, ValueType, Hasher>;
+
+    const u32 shard_count = concurrent_hash_map_shard_count(map);
+    for (u32 i = 0; i < shard_count; i++)
+    {
+        free(map.shards[i].storage);
+        free(map.shards[i].pending);
+    }
+
+    allocator_free(map.allocator, map.shards, alignof(Shard));
+    map.shards = nullptr;
+}
+
+// Copies the value out since another thread could change it right after
+CONCURRENT_HASH_MAP_TEMPLATE
+inline bool find(const ConcurrentHashMap<KeyType, ValueType, Hasher>& map, const KeyType& key, ValueType& out_value)
+{
+    const Hash hash = map.hasher(key);
+    return ConcurrentHashMapInternal::read(ConcurrentHashMapInternal::get_shard(map, hash), key, hash, out_value);
+}
+
+CONCURRENT_HASH_MAP_TEMPLATE
+inline void put(ConcurrentHashMap<KeyType, ValueType, Hasher>& map, const KeyType& key, const ValueType& value)
+{
+    using namespace ConcurrentHashMapInternal;
+
+    auto& shard = get_shard(map, map.hasher(key));
+
+    lock_shard(shard);
+    begin_write(shard);
+
+    put(shard.table, key, value);
+
+    end_write(shard);
+    unlock_shard(shard);
+}
+
+// Returns false if the key wasn't in the map
+CONCURRENT_HASH_MAP_TEMPLATE
+inline bool remove(ConcurrentHashMap<KeyType, ValueType, Hasher>& map, const KeyType& key)
+{
+    using namespace ConcurrentHashMapInternal;
+
+    auto& shard = get_shard(map, map.hasher(key));
+
+    lock_shard(shard);
+
+    auto elem = find(shard.table, key);
+    const bool found = (bool) elem;
+
+    if (found)
+    {
+        begin_write(shard);
+        remove(elem);
+        end_write(shard);
+    }
+
+    unlock_shard(shard);
+    return found;
+}
+
+// Returns the value for the key, calling constructor(key) to make it if it isn't in the map yet.
+// Only one thread ever constructs the value for a key. The key is marked as pending and the
+// constructor runs without the shard locked, so it can take as long as it needs (and use the map).
+// Other threads asking for the same key yield until it's there, everything else carries on.
+template <typename KeyType, typename ValueType, typename Hasher, typename Constructor>
+inline ValueType find_or_insert(ConcurrentHashMap<KeyType, ValueType, Hasher>& map, const KeyType& key, Constructor constructor)
+{
+    using namespace ConcurrentHashMapInternal;
+
+    const Hash hash = map.hasher(key);
+    auto& shard = get_shard(map, hash);
+
+    ValueType value;
+    while (true)
+    {
+        if (read(shard, key, hash, value))
+            return value;
+
+        lock_shard(shard);
+
+        {   // Someone else could've inserted it before the lock was taken
+            const u32 index = find_index(shard.table, key, hash);
+            if (index < shard.table.capacity)
+            {
+                value = shard.table.values[index];
+                unlock_shard(shard);
+                return value;
+            }
+        }
+
+        if (find_pending(shard, key) == shard.pending.size)
+        {
+            append(shard.pending, key);
+            unlock_shard(shard);
+            break;
+        }
+
+        // Another thread is making it
+        unlock_shard(shard);
+        std::this_thread::yield();
+    }
+
+    value = constructor(key);
+
+    lock_shard(shard);
+
+    begin_write(shard);
+    put(shard.table, key, value);
+    end_write(shard);
+
+    remove_swap(shard.pending, find_pending(shard, key));
+
+    unlock_shard(shard);
+    return value;
+}
+
+#undef CONCURRENT_HASH_MAP_TEMPLATE
\ No newline at end of file
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <atomic>
+#include <new>
+
+#include "core/allocator.h"
+#include "core/bit_utils.h"
+#include "core/logger.h"
+#include "core/types.h"
+#include "math/common.h"
+#include "platform/platform.h"
+
+// Bounded lock free queues for handing data from one thread to another.
+// Capacity is rounded up to a power of 2 and never changes, pushing into a full
+// queue fails instead of blocking. Items are copied in and out, so keep them small
+// and trivially copyable (handles, pointers, small structs).
+// Atomics can't be copied, so queues are set up in place with init().
+
+// Single producer, single consumer ring buffer.
+// Each side keeps a cached copy of the other side's index and only reloads it
+// when the cached one says the queue is full/empty, so the shared cache lines are
+// touched once per batch instead of once per item.
+template <typename T>
+struct SpscQueue
+{
+    T*  data;
+    u64 mask;   // capacity - 1
+
+    Allocator* allocator;   // Null means the platform heap
+
+    alignas(CACHE_LINE_SIZE) std::atomic<u64> head;     // Next item to pop, written by the consumer
+    u64 cached_tail;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<u64> tail;     // Next free slot, written by the producer
+    u64 cached_head;
+};
+
+template <typename T>
+inline void init(SpscQueue<T>& queue, u64 capacity, Allocator* allocator = nullptr)
+{
+    gn_assert_with_message(capacity > 0, "Queue capacity can't be 0!");
+    capacity = next_power_of_2(capacity);
+
+    queue.allocator = allocator;
+    queue.mask = capacity - 1;
+    queue.data = (T*) allocator_allocate(queue.allocator, capacity * sizeof(T), max((u64) alignof(T), DEFAULT_ALIGNMENT));
+    gn_assert_with_message(queue.data, "Could not allocate data for queue!");
+
+    queue.head.store(0, std::memory_order_relaxed);
+    queue.tail.store(0, std::memory_order_relaxed);
+    queue.cached_head = queue.cached_tail = 0;
+}
+
+template <typename T>
+inline void free(SpscQueue<T>& queue)
+{
+    allocator_free(queue.allocator, queue.data, max((u64) alignof(T), DEFAULT_ALIGNMENT));
+
+    queue.data = nullptr;
+    queue.mask = 0;
+}
+
+// Producer only, pushes as many items as fit and returns how many were pushed
+template <typename T>
+inline u64 push_many(SpscQueue<T>& queue, const T* items, u64 count)
+{
+    const u64 capacity = queue.mask + 1;
+    const u64 tail = queue.tail.load(std::memory_order_relaxed);
+
+    if (capacity - (tail - queue.cached_head) < count)
+        queue.cached_head = queue.head.load(std::memory_order_acquire);
+
+    count = min(count, capacity - (tail - queue.cached_head));
+
+    // Copy in at most two pieces (before and after wrapping around)
+    const u64 start = tail & queue.mask;
+    const u64 first = min(count, capacity - start);
+    platform_copy_memory(queue.data + start, items, first * sizeof(T));
+    platform_copy_memory(queue.data, items + first, (count - first) * sizeof(T));
+
+    queue.tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+// Consumer only, pops up to max_count items and returns how many were popped
+template <typename T>
+inline u64 pop_many(SpscQueue<T>& queue, T* out_items, u64 max_count)
+{
+    const u64 capacity = queue.mask + 1;
+    const u64 head = queue.head.load(std::memory_order_relaxed);
+
+    if (queue.cached_tail - head < max_count)
+        queue.cached_tail = queue.tail.load(std::memory_order_acquire);
+
+    const u64 count = min(max_count, queue.cached_tail - head);
+
+    const u64 start = head & queue.mask;
+    const u64 first = min(count, capacity - start);
+    platform_copy_memory(out_items, queue.data + start, first * sizeof(T));
+    platform_copy_memory(out_items + first, queue.data, (count - first) * sizeof(T));
+
+    queue.head.store(head + count, std::memory_order_release);
+    return count;
+}
+
+template <typename T>
+inline bool push(SpscQueue<T>& queue, const T& item)
+{
+    return push_many(queue, &item, 1) == 1;
+}
+
+template <typename T>
+inline bool pop(SpscQueue<T>& queue, T& out_item)
+{
+    return pop_many(queue, &out_item, 1) == 1;
+}
+
+// Multiple producers, single consumer (bounded Vyukov queue).
+// Every slot has a sequence number that tells whose turn it is: producers claim
+// slots by bumping tail with a CAS and publish them by updating the sequence, so
+// the consumer never waits on a producer that's still writing a different slot.
+template <typename T>
+struct MpscQueue
+{
+    struct Slot
+    {
+        std::atomic<u64> sequence;
+        T value;
+    };
+
+    Slot* slots;
+    u64   mask;     // capacity - 1
+
+    Allocator* allocator;   // Null means the platform heap
+
+    alignas(CACHE_LINE_SIZE) std::atomic<u64> tail;     // Next slot to claim, shared by producers
+    alignas(CACHE_LINE_SIZE) u64 head;                  // Next slot to pop, only touched by the consumer
+};
+
+template <typename T>
+inline void init(MpscQueue<T>& queue, u64 capacity, Allocator* allocator = nullptr)
+{
+    using Slot = typename MpscQueue<T>::Slot;
+
+    gn_assert_with_message(capacity > 0, "Queue capacity can't be 0!");
+    capacity = next_power_of_2(capacity);
+
+    queue.allocator = allocator;
+    queue.mask = capacity - 1;
+    queue.slots = (Slot*) allocator_allocate(queue.allocator, capacity * sizeof(Slot), max((u64) alignof(Slot), DEFAULT_ALIGNMENT));
+    gn_assert_with_message(queue.slots, "Could not allocate data for queue!");
+
+    // A slot is free for the producer at position p when its sequence is p
+    for (u64 i = 0; i < capacity; i++)
+        new (&queue.slots[i].sequence) std::atomic<u64>(i);
+
+    queue.tail.store(0, std::memory_order_relaxed);
+    queue.head = 0;
+}
+
+template <typename T>
+inline void free(MpscQueue<T>& queue)
+{
+    using Slot = typename MpscQueue<T>::Slot;
+    allocator_free(queue.allocator, queue.slots, max((u64) alignof(Slot), DEFAULT_ALIGNMENT));
+
+    queue.slots = nullptr;
+    queue.mask = 0;
+}
+
+// Any thread, pushes as many items as fit (in one contiguous run) and returns how many were pushed
+template <typename T>
+inline u64 push_many(MpscQueue<T>& queue, const T* items, u64 count)
+{
+    u64 position = queue.tail.load(std::memory_order_relaxed);
+    u64 claimed = min(count, queue.mask + 1);
+
+    while (claimed > 0)
+    {
+        // The consumer frees slots in order, so if the last slot of the run is free all of them are
+        const u64 last = position + claimed - 1;
+        const s64 diff = (s64) (queue.slots[last & queue.mask].sequence.load(std::memory_order_acquire) - last);
+
+        if (diff == 0)
+        {
+            if (queue.tail.compare_exchange_weak(position, position + claimed, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // Not enough room for the whole run, try a smaller one
+            claimed /= 2;
+        }
+        else
+        {
+            // Another producer got there first
+            position = queue.tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    for (u64 i = 0; i < claimed; i++)
+    {
+        auto& slot = queue.slots[(position + i) & queue.mask];
+        slot.value = items[i];
+        slot.sequence.store(position + i + 1, std::memory_order_release);
+    }
+
+    return claimed;
+}
+
+// Consumer only, stops at the first slot that isn't published yet
+template <typename T>
+inline u64 pop_many(MpscQueue<T>& queue, T* out_items, u64 max_count)
+{
+    const u64 capacity = queue.mask + 1;
+
+    u64 count = 0;
+    while (count < max_count)
+    {
+        auto& slot = queue.slots[queue.head & queue.mask];
+        if (slot.sequence.load(std::memory_order_acquire) != queue.head + 1)
+            break;
+
+        out_items[count++] = slot.value;
+
+        // Hand the slot to the producer one lap ahead
+        slot.sequence.store(queue.head + capacity, std::memory_order_release);
+        queue.head++;
+    }
+
+    return count;
+}
+
+template <typename T>
+inline bool push(MpscQueue<T>& queue, const T& item)
+{
+    return push_many(queue, &item, 1) == 1;
+}
+
+template <typename T>
+inline bool pop(MpscQueue<T>& queue, T& out_item)
+{
+    return pop_many(queue, &out_item, 1) == 1;
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/common.h"
+#include "core/allocator.h"
 #include "core/logger.h"
 #include "core/types.h"
 #include "math/common.h"
@@ -13,6 +14,8 @@ struct DynamicArray
     u64 size;
     u64 capacity;
 
+    Allocator* allocator;   // Null means the platform heap
+
     T& operator[](const u64 index)
     {
         gn_assert_with_message(index < size, "Index out of bounds! (index: %, array size: %)", index, size);
@@ -26,27 +29,36 @@ struct DynamicArray
     }
 };
 
+// Over aligned types (SIMD types, cache line aligned structs) get aligned storage
+template <typename T>
+constexpr u64 darray_alignment()
+{
+    return max((u64) alignof(T), DEFAULT_ALIGNMENT);
+}
+
 template <typename T>
-inline DynamicArray<T> make(Type<DynamicArray<T>>, u64 start_cap = 16)
+inline DynamicArray<T> make(Type<DynamicArray<T>>, u64 start_cap = 16, Allocator* allocator = nullptr)
 {
     DynamicArray<T> arr;
 
     arr.capacity = start_cap;
     arr.size = 0;
-    arr.data = (T*) platform_allocate(arr.capacity * sizeof(T));
+    arr.allocator = allocator;
+    arr.data = (T*) allocator_allocate(arr.allocator, arr.capacity * sizeof(T), darray_alignment<T>());
     gn_assert_with_message(arr.data, "Could not allocate data for array!");
 
     return arr;
 }
 
 template <typename T>
-inline DynamicArray<T> copy(const DynamicArray<T>& other)
+inline DynamicArray<T> copy(const DynamicArray<T>& other, Allocator* allocator = nullptr)
 {
     DynamicArray<T> arr;
 
     arr.capacity = other.capacity;
     arr.size = other.size;
-    arr.data = (T*) platform_allocate(arr.capacity * sizeof(T));
+    arr.allocator = allocator;
+    arr.data = (T*) allocator_allocate(arr.allocator, arr.capacity * sizeof(T), darray_alignment<T>());
     gn_assert_with_message(arr.data, "Could not allocate data for array!");
 
     for (u64 i = 0; i < arr.size; i++)
@@ -58,7 +70,7 @@ inline DynamicArray<T> copy(const DynamicArray<T>& other)
 template <typename T>
 inline void free(DynamicArray<T>& arr)
 {
-    platform_free(arr.data);
+    allocator_free(arr.allocator, arr.data, darray_alignment<T>());
 
     arr.data = nullptr;
     arr.capacity = arr.size = 0;
@@ -91,7 +103,7 @@ inline void clear_with_free(DynamicArray<T>& arr)
 template <typename T>
 inline void resize(DynamicArray<T>& arr, u64 new_capacity)
 {
-    T* new_data = (T*) platform_reallocate(arr.data, new_capacity * sizeof(T));
+    T* new_data = (T*) allocator_reallocate(arr.allocator, arr.data, arr.capacity * sizeof(T), new_capacity * sizeof(T), darray_alignment<T>());
     gn_assert_with_message(new_data, "Could not reallocate data for array!");
 
     arr.capacity = new_capacity;
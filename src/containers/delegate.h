@@ -0,0 +1,71 @@
+#pragma once
+
+#include <new>
+
+#include "core/types.h"
+
+// Callable that stores its target inline: a function pointer, a lambda with captures
+// or an object + member function pair. Nothing is ever allocated and a call is a
+// single indirect jump into a thunk with the target's body inlined.
+// Targets have to be trivially copyable (capture pointers and references, not owning
+// containers), which keeps the delegate itself trivially copyable so it can be stored
+// in arrays and moved around with memcpy.
+
+constexpr u64 DELEGATE_STORAGE_SIZE = 32;
+
+// Can't make a delegate with a simple type
+template <typename Type>
+struct Delegate
+{
+    Delegate() = delete;
+};
+
+template <typename RetType, typename... Args>
+struct Delegate <RetType (Args...)>
+{
+    using Invoker = RetType (*)(void* storage, Args... args);
+
+    alignas(u64) u8 storage[DELEGATE_STORAGE_SIZE];
+    Invoker invoker = nullptr;
+
+    Delegate()
+    {}
+
+    // Taken by value so plain functions decay to function pointers
+    template <typename Callable>
+    Delegate(Callable callable)
+    {
+        static_assert(sizeof(Callable) <= DELEGATE_STORAGE_SIZE, "Callable is too big to be stored in a delegate!");
+        static_assert(alignof(Callable) <= alignof(u64), "Callable is over aligned!");
+        static_assert(__is_trivially_copyable(Callable), "Callable needs to be trivially copyable!");
+
+        new (storage) Callable(callable);
+        invoker = [](void* storage, Args... args) -> RetType
+        {
+            return (*(Callable*) storage)(args...);
+        };
+    }
+
+    template <typename Object>
+    Delegate(Object* object, RetType (Object::*method)(Args...))
+    :   Delegate([object, method](Args... args) -> RetType { return (object->*method)(args...); })
+    {
+    }
+
+    template <typename Object>
+    Delegate(const Object* object, RetType (Object::*method)(Args...) const)
+    :   Delegate([object, method](Args... args) -> RetType { return (object->*method)(args...); })
+    {
+    }
+
+    RetType operator()(Args... args) const
+    {
+        return invoker((void*) storage, args...);
+    }
+
+    // Conversion operator
+    operator bool() const
+    {
+        return invoker != nullptr;
+    }
+};
\ No newline at end of file
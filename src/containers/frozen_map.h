@@ -0,0 +1,435 @@
+#pragma once
+
+#include "core/types.h"
+#include "core/common.h"
+#include "core/allocator.h"
+#include "core/logger.h"
+#include "math/common.h"
+#include "platform/platform.h"
+#include "bitset.h"
+#include "bytes.h"
+#include "hash.h"
+#include "hash_table.h"
+
+// Read only map for tables that are built once and then only looked up.
+// Keys are sent to their own slot by a minimal perfect hash (CHD / PTHash style:
+// keys are split into small buckets and every bucket stores a "pilot" value that
+// moves all of its keys into free slots), so a lookup is one hash, one slot and one
+// key compare. Keys and values are stored next to each other in an array with no
+// empty slots, so a hit touches one pilot and one entry.
+// Keys need distinct 32 bit hashes. The integer hashes are bijections so that always
+// holds for 32 bit integers and atoms.
+// The whole map is one block without any pointers in it: frozen_map_get_bytes gives
+// the block to write out and frozen_map_view uses a loaded block in place.
+
+#define FROZEN_MAP_TEMPLATE template <typename KeyType, typename ValueType, typename Hasher = Hasher<KeyType>>
+
+namespace FrozenMapInternal
+{
+
+constexpr u32 AVERAGE_BUCKET_SIZE = 4;
+constexpr u32 MAX_PILOT           = 1u << 24;
+constexpr u32 MAX_SEED_ATTEMPTS   = 32;
+
+// Start of the block, also written out with it
+struct Header
+{
+    u32 count;
+    u32 bucket_count;
+    u64 seed;
+    u32 key_size;
+    u32 value_size;
+};
+
+template <typename KeyType, typename ValueType>
+struct Entry
+{
+    KeyType   key;
+    ValueType value;
+};
+
+struct Layout
+{
+    u64 pilots_offset;
+    u64 entries_offset;
+    u64 size_in_bytes;
+};
+
+GN_FORCE_INLINE u64 align_up(u64 value, u64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+template <typename KeyType, typename ValueType>
+inline Layout get_layout(u32 count, u32 bucket_count)
+{
+    Layout layout;
+    layout.pilots_offset = align_up(sizeof(Header), alignof(u32));
+    layout.entries_offset = align_up(layout.pilots_offset + bucket_count * sizeof(u32), alignof(Entry<KeyType, ValueType>));
+    layout.size_in_bytes  = layout.entries_offset + count * sizeof(Entry<KeyType, ValueType>);
+    return layout;
+}
+
+template <typename KeyType, typename ValueType>
+constexpr u64 block_alignment()
+{
+    return max(max((u64) alignof(Entry<KeyType, ValueType>), (u64) alignof(Header)), DEFAULT_ALIGNMENT);
+}
+
+// Spreads the 32 bit hash over 64 bits, the upper half picks the bucket
+GN_FORCE_INLINE u64 expand_hash(Hash hash, u64 seed)
+{
+    return (hash ^ seed) * 0x9E3779B97F4A7C15ull;
+}
+
+// Maps a 32 bit value to [0, range) without a division
+GN_FORCE_INLINE u32 reduce(u32 value, u32 range)
+{
+    return (u32) (((u64) value * range) >> 32);
+}
+
+GN_FORCE_INLINE u32 get_bucket(u64 hash, u32 bucket_count)
+{
+    return reduce((u32) (hash >> 32), bucket_count);
+}
+
+// The multiply makes the upper bits depend on every bit, so keys that only differ
+// in their low bits still end up in different slots
+GN_FORCE_INLINE u32 get_slot(u64 hash, u32 pilot, u32 count)
+{
+    const u64 mixed = (hash ^ (pilot * 0x9E3779B97F4A7C15ull)) * 0xD6E8FEB86659FD93ull;
+    return reduce((u32) (mixed >> 32), count);
+}
+
+} // namespace FrozenMapInternal
+
+FROZEN_MAP_TEMPLATE
+struct FrozenMap
+{
+    FrozenMapInternal::Header* header;  // Start of the block
+    u32*       pilots;
+    FrozenMapInternal::Entry<KeyType, ValueType>* entries;  // Dense, count of them
+
+    u32 count;
+
+    Hasher hasher;
+    Allocator* allocator;   // Null means the platform heap
+    bool is_view;           // Points into memory owned by someone else
+};
+
+FROZEN_MAP_TEMPLATE
+struct FrozenMapElement
+{
+    const FrozenMap<KeyType, ValueType, Hasher>* map;
+    u32 index;
+
+    // Conversions
+    inline operator bool() const
+    {
+        gn_assert_with_message(map, "Element doesn't point to a valid frozen map!");
+        return index < map->count;
+    }
+
+    // Getters
+    inline const KeyType& key() const
+    {
+        gn_assert_with_message(map, "Element doesn't point to a valid frozen map!");
+        gn_assert_with_message(index < map->count, "Element not valid!");
+        return map->entries[index].key;
+    }
+
+    inline const ValueType& value() const
+    {
+        gn_assert_with_message(map, "Element doesn't point to a valid frozen map!");
+        gn_assert_with_message(index < map->count, "Element not valid!");
+        return map->entries[index].value;
+    }
+};
+
+namespace FrozenMapInternal
+{
+
+FROZEN_MAP_TEMPLATE
+inline void set_pointers(FrozenMap<KeyType, ValueType, Hasher>& map, u8* block)
+{
+    const Header* header = (const Header*) block;
+    const Layout layout = get_layout<KeyType, ValueType>(header->count, header->bucket_count);
+
+    map.header  = (Header*) block;
+    map.pilots  = (u32*) (block + layout.pilots_offset);
+    map.entries = (Entry<KeyType, ValueType>*) (block + layout.entries_offset);
+    map.count   = header->count;
+}
+
+enum struct PilotResult : u8
+{
+    FOUND,
+    RETRY,          // Some bucket didn't fit, another seed might work
+    IMPOSSIBLE,     // Keys with the same hash land in the same slot whatever the seed is
+};
+
+// Finds a pilot for every bucket with the given seed.
+// Buckets are placed biggest first since those are the hardest to fit.
+FROZEN_MAP_TEMPLATE
+PilotResult find_pilots(FrozenMap<KeyType, ValueType, Hasher>& map, const KeyType* keys, const ValueType* values, u64 seed, Arena& scratch)
+{
+    const u32 count        = map.header->count;
+    const u32 bucket_count = map.header->bucket_count;
+
+    u64* hashes       = (u64*) arena_allocate(scratch, count * sizeof(u64));
+    u32* sorted_keys  = (u32*) arena_allocate(scratch, count * sizeof(u32));
+    u32* bucket_start = (u32*) arena_allocate(scratch, (bucket_count + 1) * sizeof(u32));
+    u32* bucket_order = (u32*) arena_allocate(scratch, bucket_count * sizeof(u32));
+    u32* slots        = (u32*) arena_allocate(scratch, count * sizeof(u32));
+
+    {   // Group keys by bucket (counting sort)
+        platform_zero_memory(bucket_start, (bucket_count + 1) * sizeof(u32));
+
+        for (u32 i = 0; i < count; i++)
+        {
+            hashes[i] = expand_hash(map.hasher(keys[i]), seed);
+            bucket_start[get_bucket(hashes[i], bucket_count) + 1]++;
+        }
+
+        for (u32 b = 0; b < bucket_count; b++)
+            bucket_start[b + 1] += bucket_start[b];
+
+        // bucket_order is used as the fill cursor for now
+        platform_copy_memory(bucket_order, bucket_start, bucket_count * sizeof(u32));
+        for (u32 i = 0; i < count; i++)
+            sorted_keys[bucket_order[get_bucket(hashes[i], bucket_count)]++] = i;
+    }
+
+    u32 max_bucket_size = 0;
+    for (u32 b = 0; b < bucket_count; b++)
+        max_bucket_size = max(max_bucket_size, bucket_start[b + 1] - bucket_start[b]);
+
+    {   // Order buckets by size, biggest first (counting sort again)
+        u32* size_start = (u32*) arena_allocate(scratch, (max_bucket_size + 2) * sizeof(u32));
+        platform_zero_memory(size_start, (max_bucket_size + 2) * sizeof(u32));
+
+        for (u32 b = 0; b < bucket_count; b++)
+            size_start[max_bucket_size - (bucket_start[b + 1] - bucket_start[b]) + 1]++;
+
+        for (u32 s = 0; s <= max_bucket_size; s++)
+            size_start[s + 1] += size_start[s];
+
+        for (u32 b = 0; b < bucket_count; b++)
+            bucket_order[size_start[max_bucket_size - (bucket_start[b + 1] - bucket_start[b])]++] = b;
+    }
+
+    DynamicBitSet taken = make<DynamicBitSet>((u64) count, arena_allocator(scratch));
+
+    for (u32 order = 0; order < bucket_count; order++)
+    {
+        const u32 bucket = bucket_order[order];
+        const u32 first  = bucket_start[bucket];
+        const u32 size   = bucket_start[bucket + 1] - first;
+
+        // Sorted by size so the rest are empty
+        if (size == 0)
+            break;
+
+        // Equal 32 bit hashes stay equal after mixing in the seed, buckets are small enough to compare every pair
+        for (u32 i = first; i < first + size; i++)
+        {
+            for (u32 j = i + 1; j < first + size; j++)
+            {
+                if (hashes[sorted_keys[i]] == hashes[sorted_keys[j]])
+                    return PilotResult::IMPOSSIBLE;
+            }
+        }
+
+        bool placed = false;
+        for (u32 pilot = 0; !placed && pilot <= MAX_PILOT; pilot++)
+        {
+            u32 filled = 0;
+            for (; filled < size; filled++)
+            {
+                const u32 slot = get_slot(hashes[sorted_keys[first + filled]], pilot, count);
+                if (test_bit(taken, slot))
+                    break;
+
+                set_bit(taken, slot);
+                slots[first + filled] = slot;
+            }
+
+            placed = (filled == size);
+            if (!placed)
+            {
+                for (u32 i = 0; i < filled; i++)
+                    clear_bit(taken, slots[first + i]);
+            }
+            else
+            {
+                map.pilots[bucket] = pilot;
+            }
+        }
+
+        if (!placed)
+            return PilotResult::RETRY;
+    }
+
+    for (u32 i = 0; i < count; i++)
+    {
+        const u32 key_index = sorted_keys[i];
+        map.entries[slots[i]].key   = keys[key_index];
+        map.entries[slots[i]].value = values[key_index];
+    }
+
+    return PilotResult::FOUND;
+}
+
+} // namespace FrozenMapInternal
+
+// Keys have to be unique. If they aren't (or two of them share a hash) no perfect hash exists and
+// an empty map is returned, so check that the count matches when the keys come from outside.
+FROZEN_MAP_TEMPLATE
+FrozenMap<KeyType, ValueType, Hasher> make(Type<FrozenMap<KeyType, ValueType, Hasher>>, const KeyType* keys, const ValueType* values, u32 count, Allocator* allocator = nullptr)
+{
+    using namespace FrozenMapInternal;
+
+    FrozenMap<KeyType, ValueType, Hasher> map = {};
+    map.allocator = allocator;
+
+    const u32 bucket_count = max(count / AVERAGE_BUCKET_SIZE, 1u);
+    const Layout layout = get_layout<KeyType, ValueType>(count, bucket_count);
+
+    u8* block = (u8*) allocator_allocate(map.allocator, layout.size_in_bytes, block_alignment<KeyType, ValueType>());
+    gn_assert_with_message(block, "Could not allocate data for frozen map!");
+
+    // Padding bytes get written out too, keep them deterministic
+    platform_zero_memory(block, layout.size_in_bytes);
+
+    Header* header = (Header*) block;
+    header->count        = count;
+    header->bucket_count = bucket_count;
+    header->key_size     = sizeof(KeyType);
+    header->value_size   = sizeof(ValueType);
+
+    set_pointers(map, block);
+
+    Arena& scratch = get_scratch_arena();
+    PilotResult result = PilotResult::RETRY;
+
+    // Seeds are derived from a fixed one so the same keys always produce the same block
+    for (u32 attempt = 0; result == PilotResult::RETRY && attempt < MAX_SEED_ATTEMPTS; attempt++)
+    {
+        const ArenaMarker marker = arena_get_marker(scratch);
+
+        header->seed = Hashing::hash_u64(Hashing::DEFAULT_SEED + attempt);
+        result = find_pilots(map, keys, values, header->seed, scratch);
+
+        arena_restore(scratch, marker);
+    }
+
+    if (result != PilotResult::FOUND)
+    {
+        allocator_free(map.allocator, block, block_alignment<KeyType, ValueType>());
+
+        map = {};
+        map.allocator = allocator;
+    }
+
+    return map;
+}
+
+// Non const arrays would match the generic make better than the one above
+FROZEN_MAP_TEMPLATE
+inline FrozenMap<KeyType, ValueType, Hasher> make(Type<FrozenMap<KeyType, ValueType, Hasher>> type, KeyType* keys, ValueType* values, u32 count, Allocator* allocator = nullptr)
+{
+    return make(type, (const KeyType*) keys, (const ValueType*) values, count, allocator);
+}
+
+// Keys of a table are unique, but it can still come back empty if two of them share a hash
+FROZEN_MAP_TEMPLATE
+FrozenMap<KeyType, ValueType, Hasher> freeze(const HashTable<KeyType, ValueType, Hasher>& table, Allocator* allocator = nullptr)
+{
+    Arena& scratch = get_scratch_arena();
+    const ArenaMarker marker = arena_get_marker(scratch);
+
+    KeyType*   keys   = (KeyType*)   arena_allocate(scratch, max(table.filled, 1u) * sizeof(KeyType), alignof(KeyType));
+    ValueType* values = (ValueType*) arena_allocate(scratch, max(table.filled, 1u) * sizeof(ValueType), alignof(ValueType));
+
+    u32 count = 0;
+    for (u32 i = 0; count < table.filled && i < table.capacity; i++)
+    {
+        if (is_alive(table, i))
+        {
+            keys[count]   = table.keys[i];
+            values[count] = table.values[i];
+            count++;
+        }
+    }
+
+    FrozenMap<KeyType, ValueType, Hasher> map = make<FrozenMap<KeyType, ValueType, Hasher>>(keys, values, count, allocator);
+
+    arena_restore(scratch, marker);
+    return map;
+}
+
+FROZEN_MAP_TEMPLATE
+inline void free(FrozenMap<KeyType, ValueType, Hasher>& map)
+{
+    if (!map.is_view)
+        allocator_free(map.allocator, map.header, FrozenMapInternal::block_alignment<KeyType, ValueType>());
+
+    map.header = nullptr;
+    map.pilots = nullptr;
+    map.entries = nullptr;
+    map.count  = 0;
+}
+
+FROZEN_MAP_TEMPLATE
+FrozenMapElement<KeyType, ValueType, Hasher> find(const FrozenMap<KeyType, ValueType, Hasher>& map, const KeyType& key)
+{
+    using namespace FrozenMapInternal;
+    using FrozenMapElement = FrozenMapElement<KeyType, ValueType, Hasher>;
+
+    // Zero initialized and empty maps don't have any slots
+    if (map.count == 0)
+        return FrozenMapElement { &map, 0 };
+
+    const u64 hash = expand_hash(map.hasher(key), map.header->seed);
+    const u32 pilot = map.pilots[get_bucket(hash, map.header->bucket_count)];
+    const u32 slot = get_slot(hash, pilot, map.count);
+
+    return FrozenMapElement { &map, (map.entries[slot].key == key) ? slot : map.count };
+}
+
+// The whole map as a single block, keys and values have to be plain data for this to make sense
+FROZEN_MAP_TEMPLATE
+inline Bytes frozen_map_get_bytes(const FrozenMap<KeyType, ValueType, Hasher>& map)
+{
+    if (!map.header)
+        return Bytes {};
+
+    const auto layout = FrozenMapInternal::get_layout<KeyType, ValueType>(map.header->count, map.header->bucket_count);
+    return Bytes { (u8*) map.header, layout.size_in_bytes };
+}
+
+// Uses a block from frozen_map_get_bytes in place, the bytes have to outlive the map
+// and be aligned like the block was (freeing a view doesn't free the bytes)
+FROZEN_MAP_TEMPLATE
+inline bool frozen_map_view(FrozenMap<KeyType, ValueType, Hasher>& map, const Bytes bytes)
+{
+    using namespace FrozenMapInternal;
+
+    map = {};
+    map.is_view = true;
+
+    if (bytes.size < sizeof(Header) || ((u64) bytes.data % block_alignment<KeyType, ValueType>()) != 0)
+        return false;
+
+    const Header* header = (const Header*) bytes.data;
+    if (header->key_size != sizeof(KeyType) || header->value_size != sizeof(ValueType) || header->bucket_count == 0)
+        return false;
+
+    if (get_layout<KeyType, ValueType>(header->count, header->bucket_count).size_in_bytes != bytes.size)
+        return false;
+
+    set_pointers(map, bytes.data);
+    return true;
+}
+
+#undef FROZEN_MAP_TEMPLATE
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "core/types.h"
 #include "string.h"
 #include "bytes.h"
+#include "hash_functions.h"
 
 using Hash = u32;
 
@@ -13,22 +14,17 @@ struct Hasher
     inline Hash operator()(T const& key);
 };
 
-constexpr Hash bytes[4] = {
-    0x000000FF,
-    0x0000FF00,
-    0x00FF0000,
-    0xFF000000
-};
-
 template <>
 struct Hasher<f32>
 {
     inline Hash operator()(f32 const& key) const
     {
-        Hash hash = *(Hash*)(&key);
-        Hash shuffled = (hash >> 16) | (hash << 16);
+        // +0 and -0 compare equal so they need to hash the same
+        const f32 value = (key == 0.0f) ? 0.0f : key;
 
-        return shuffled ^ 0xE8BF6CDF;
+        u32 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return Hashing::hash_u32(bits);
     }
 };
 
@@ -37,19 +33,7 @@ struct Hasher<s32>
 {
     inline Hash operator()(s32 const& key) const
     {
-        Hash hash = *(Hash*)(&key);
-
-        // 00 00 00 FF -> 00 FF 00 00   << 16
-        // 00 00 FF 00 -> 00 00 00 FF   >> 8
-        // 00 FF 00 00 -> FF 00 00 00   << 8
-        // FF 00 00 00 -> 00 00 FF 00   >> 16
-        
-        Hash shuffled = ((hash & bytes[0]) << 16) |
-                        ((hash & bytes[1]) >>  8) |
-                        ((hash & bytes[2]) <<  8) |
-                        ((hash & bytes[3]) >> 16);
-
-        return shuffled;
+        return Hashing::hash_u32((u32) key);
     }
 };
 
@@ -58,19 +42,16 @@ struct Hasher<u32>
 {
     inline Hash operator()(u32 const& key) const
     {
-        Hash hash = *(Hash*)(&key);
-
-        // 00 00 00 FF -> 00 FF 00 00   << 16
-        // 00 00 FF 00 -> 00 00 00 FF   >> 8
-        // 00 FF 00 00 -> FF 00 00 00   << 8
-        // FF 00 00 00 -> 00 00 FF 00   >> 16
-        
-        Hash shuffled = ((hash & bytes[0]) << 16) |
-                        ((hash & bytes[1]) >>  8) |
-                        ((hash & bytes[2]) <<  8) |
-                        ((hash & bytes[3]) >> 16);
+        return Hashing::hash_u32(key);
+    }
+};
 
-        return shuffled;
+template <>
+struct Hasher<s64>
+{
+    inline Hash operator()(s64 const& key) const
+    {
+        return Hashing::fold_to_u32(Hashing::hash_u64((u64) key));
     }
 };
 
@@ -79,25 +60,7 @@ struct Hasher<u64>
 {
     inline Hash operator()(u64 const& key) const
     {
-        Hash hash1 = (((Hash*)(&key))[0]);
-        Hash hash2 = (((Hash*)(&key))[1]);
-
-        // 00 00 00 FF -> 00 FF 00 00   << 16
-        // 00 00 FF 00 -> 00 00 00 FF   >> 8
-        // 00 FF 00 00 -> FF 00 00 00   << 8
-        // FF 00 00 00 -> 00 00 FF 00   >> 16
-        
-        Hash shuffled1 = ((hash1 & bytes[0]) << 16) |
-                         ((hash1 & bytes[1]) >>  8) |
-                         ((hash1 & bytes[2]) <<  8) |
-                         ((hash1 & bytes[3]) >> 16);
-
-        Hash shuffled2 = ((hash2 & bytes[0]) << 16) |
-                         ((hash2 & bytes[1]) >>  8) |
-                         ((hash2 & bytes[2]) <<  8) |
-                         ((hash2 & bytes[3]) >> 16);
-
-        return shuffled1 ^ shuffled2;
+        return Hashing::fold_to_u32(Hashing::hash_u64(key));
     }
 };
 
@@ -112,48 +75,12 @@ struct Hasher<void*>
     }
 };
 
-static inline Hash HashCharBuffer(char const* buffer, const u64 length)
-{
-    Hash const* ptr = (Hash*) buffer;
-    u64 count = length / 4;
-    u32 rem = length % 4;
-
-    Hash hash = 0x8BDC195DF;
-    while (count)
-    {
-        const Hash val = *ptr;
-        
-        hash = hash + hash * val * val * (count * count + 1);
-        hash = ((hash & bytes[0]) << 16) |
-               ((hash & bytes[1]) >>  8) |
-               ((hash & bytes[2]) <<  8) |
-               ((hash & bytes[3]) >> 16);
-
-        count--;
-        ptr++;
-    }
-
-    {   // Hash the remaining chars
-        const u32 shift = (4 - rem) * 8;
-        const u32 mask = (shift < 32u) ? (0xFFFFFFFF << shift) : 0u;
-        const Hash val = (*ptr) & mask;
-        
-        hash = hash + hash * val * val;
-        hash = ((hash & bytes[0]) << 16) |
-               ((hash & bytes[1]) >>  8) |
-               ((hash & bytes[2]) <<  8) |
-               ((hash & bytes[3]) >> 16);
-    }
-
-    return hash;
-}
-
 template<>
 struct Hasher<String>
 {
     inline Hash operator()(String const& key) const
     {
-        return HashCharBuffer(key.data, key.size);
+        return Hashing::fold_to_u32(Hashing::hash_bytes(key.data, key.size));
     }
 };
 
@@ -162,7 +89,6 @@ struct Hasher<Bytes>
 {
     inline Hash operator()(Bytes const& key) const
     {
-        const char* as_char = (char*) key.data;
-        return HashCharBuffer(as_char, key.size);
+        return Hashing::fold_to_u32(Hashing::hash_bytes(key.data, key.size));
     }
 };
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstring>
+#include "core/types.h"
+#include "core/compiler_utils.h"
+
+#if defined(GN_COMPILER_MSVC)
+#include <intrin.h>
+#endif
+
+// 64 bit hash functions for byte buffers and integers.
+// Byte buffers use wyhash (final version 4), which consumes 48 bytes per
+// iteration over 3 independent 64 x 64 -> 128 bit multiplies and handles the
+// tail with overlapping reads, so nothing is ever read past the end of the buffer.
+// Output is deterministic for a given seed so hashes can be stored in files.
+
+namespace Hashing
+{
+
+constexpr u64 DEFAULT_SEED = 0xA0761D6478BD642Full;
+
+namespace Internal
+{
+
+constexpr u64 SECRET[4] = {
+    0x2D358DCCAA6C78A5ull,
+    0x8BB84B93962EACC9ull,
+    0x4B33A62ED433D4A3ull,
+    0x4D5A2DA51DE1AA47ull
+};
+
+// 64 x 64 -> 128 bit multiply, lower half goes in a and upper half goes in b
+GN_FORCE_INLINE void multiply_128(u64& a, u64& b)
+{
+#if defined(GN_COMPILER_MSVC)
+    u64 high;
+    a = _umul128(a, b, &high);
+    b = high;
+#else
+    const unsigned __int128 result = (unsigned __int128) a * b;
+    a = (u64) result;
+    b = (u64) (result >> 64);
+#endif
+}
+
+GN_FORCE_INLINE u64 mix(u64 a, u64 b)
+{
+    multiply_128(a, b);
+    return a ^ b;
+}
+
+// Unaligned reads, memcpy gets turned into a single load
+GN_FORCE_INLINE u64 read_u64(const u8* ptr)
+{
+    u64 value;
+    memcpy(&value, ptr, sizeof(u64));
+    return value;
+}
+
+GN_FORCE_INLINE u64 read_u32(const u8* ptr)
+{
+    u32 value;
+    memcpy(&value, ptr, sizeof(u32));
+    return value;
+}
+
+// Reads 1 to 3 bytes without going past the end
+GN_FORCE_INLINE u64 read_small(const u8* ptr, u64 length)
+{
+    return (((u64) ptr[0]) << 16) | (((u64) ptr[length >> 1]) << 8) | ptr[length - 1];
+}
+
+GN_FORCE_INLINE u64 wyhash(const u8* ptr, u64 length, u64 seed)
+{
+    seed ^= mix(seed ^ SECRET[0], SECRET[1]);
+
+    u64 a, b;
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            const u64 offset = (length >> 3) << 2;
+            a = (read_u32(ptr) << 32) | read_u32(ptr + offset);
+            b = (read_u32(ptr + length - 4) << 32) | read_u32(ptr + length - 4 - offset);
+        }
+        else if (length > 0)
+        {
+            a = read_small(ptr, length);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        u64 remaining = length;
+        if (remaining > 48)
+        {
+            u64 seed1 = seed, seed2 = seed;
+            do
+            {
+                seed  = mix(read_u64(ptr)      ^ SECRET[1], read_u64(ptr + 8)  ^ seed);
+                seed1 = mix(read_u64(ptr + 16) ^ SECRET[2], read_u64(ptr + 24) ^ seed1);
+                seed2 = mix(read_u64(ptr + 32) ^ SECRET[3], read_u64(ptr + 40) ^ seed2);
+                ptr += 48;
+                remaining -= 48;
+            }
+            while (remaining > 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (remaining > 16)
+        {
+            seed = mix(read_u64(ptr) ^ SECRET[1], read_u64(ptr + 8) ^ seed);
+            ptr += 16;
+            remaining -= 16;
+        }
+
+        // Last 16 bytes, these can overlap with the ones that were already hashed
+        a = read_u64(ptr + remaining - 16);
+        b = read_u64(ptr + remaining - 8);
+    }
+
+    a ^= SECRET[1];
+    b ^= seed;
+    multiply_128(a, b);
+
+    return mix(a ^ SECRET[0] ^ length, b ^ SECRET[1]);
+}
+
+} // namespace Internal
+
+inline u64 hash_bytes(const void* data, u64 length, u64 seed = DEFAULT_SEED)
+{
+    return Internal::wyhash((const u8*) data, length, seed);
+}
+
+// Integer finalizers, every input bit affects every output bit.
+// Sequential keys (indices, ids, kerning pairs) end up spread over the whole range.
+
+GN_FORCE_INLINE u32 hash_u32(u32 x)
+{
+    // lowbias32 by Chris Wellons
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+GN_FORCE_INLINE u64 hash_u64(u64 x)
+{
+    // Murmur3 / SplitMix64 style finalizer
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Mixes both halves so the lower 32 bits depend on all 64 bits
+GN_FORCE_INLINE u32 fold_to_u32(u64 hash)
+{
+    return (u32) (hash ^ (hash >> 32));
+}
+
+} // namespace Hashing
\ No newline at end of file
@@ -1,33 +1,140 @@
 #pragma once
 
 #include <cstdlib>
+#include <emmintrin.h>
 #include "core/types.h"
 #include "core/common.h"
+#include "core/allocator.h"
+#include "core/bit_utils.h"
 #include "math/common.h"
 #include "hash.h"
 
+// Open addressing hash table that probes 16 slots at a time (Swiss table style).
+// Every slot has a control byte which is either EMPTY, TOMBSTONE, or the lower
+// 7 bits of the key's hash if the slot is alive. A probe loads the control bytes
+// of a whole group and compares them against the hash fragment using SSE2, so
+// the keys are only compared for slots that are very likely to match.
+
 #define HASH_TABLE_TEMPLATE template <typename KeyType, typename ValueType, typename Hasher = Hasher<KeyType>>
-#define HASH_TABLE_MAX_LOAD_FACTOR 0.75f
 
-HASH_TABLE_TEMPLATE
-struct HashTable
+namespace HashTableInternal
+{
+
+constexpr u32 GROUP_WIDTH = 16;
+constexpr u32 MIN_CAPACITY = GROUP_WIDTH;
+
+// Alive slots store the lower 7 bits of the hash so their MSB is always 0
+constexpr u8 CONTROL_EMPTY     = 0b10000000;
+constexpr u8 CONTROL_TOMBSTONE = 0b11111110;
+
+GN_FORCE_INLINE bool is_alive(u8 control)
+{
+    return (control & 0b10000000) == 0;
+}
+
+GN_FORCE_INLINE u32 hash_group(Hash hash)
+{
+    return hash >> 7;
+}
+
+GN_FORCE_INLINE u8 hash_fragment(Hash hash)
+{
+    return (u8) (hash & 0b01111111);
+}
+
+// Max load factor is 7/8
+GN_FORCE_INLINE u32 max_filled_for_capacity(u32 capacity)
+{
+    return capacity - capacity / 8;
+}
+
+struct Group
+{
+    __m128i controls;
+
+    GN_FORCE_INLINE static Group load(const u8* controls)
+    {
+        return Group { _mm_load_si128((const __m128i*) controls) };
+    }
+
+    // Bitmask of slots whose hash fragment matches
+    GN_FORCE_INLINE u32 match(u8 fragment) const
+    {
+        return (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char) fragment), controls));
+    }
+
+    GN_FORCE_INLINE u32 match_empty() const
+    {
+        return (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char) CONTROL_EMPTY), controls));
+    }
+
+    // Both EMPTY and TOMBSTONE have their MSB set
+    GN_FORCE_INLINE u32 match_empty_or_tombstone() const
+    {
+        return (u32) _mm_movemask_epi8(controls);
+    }
+};
+
+// Triangular probing over groups, visits every group once when the group count is a power of 2
+struct ProbeSequence
+{
+    u32 group_mask;
+    u32 group;
+    u32 step;
+
+    GN_FORCE_INLINE u32 offset() const
+    {
+        return group * GROUP_WIDTH;
+    }
+
+    GN_FORCE_INLINE void next()
+    {
+        step++;
+        group = (group + step) & group_mask;
+    }
+};
+
+GN_FORCE_INLINE ProbeSequence probe_start(Hash hash, u32 capacity)
 {
-    enum struct State : u8
+    const u32 group_mask = capacity / GROUP_WIDTH - 1;
+    return ProbeSequence { group_mask, hash_group(hash) & group_mask, 0 };
+}
+
+GN_FORCE_INLINE u64 align_up(u64 value, u64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Returns the first slot in the probe sequence that is either EMPTY or a TOMBSTONE
+GN_FORCE_INLINE u32 find_first_non_alive(const u8* controls, u32 capacity, Hash hash)
+{
+    ProbeSequence seq = probe_start(hash, capacity);
+
+    while (true)
     {
-        EMPTY,
-        TOMBSTONE,
-        ALIVE
-    };
+        const u32 mask = Group::load(controls + seq.offset()).match_empty_or_tombstone();
+        if (mask)
+            return seq.offset() + count_trailing_zeros(mask);
 
-    State*     states;
-    Hash*      hashes;
+        seq.next();
+    }
+}
+
+} // namespace HashTableInternal
+
+HASH_TABLE_TEMPLATE
+struct HashTable
+{
+    u8*        controls;
     KeyType*   keys;
     ValueType* values;
 
     u32 filled;
-    u32 capacity;
+    u32 capacity;       // Always a power of 2 and a multiple of the group width
+    u32 growth_left;    // Number of EMPTY slots that can be filled before a rehash is needed
 
     Hasher hasher;
+    Allocator* allocator;   // Null means the platform heap
 };
 
 HASH_TABLE_TEMPLATE
@@ -35,94 +142,99 @@ struct HashTableElement
 {
     const HashTable<KeyType, ValueType, Hasher>* table;
     u32 index;
-    
+
     // Conversions
     inline operator bool() const
     {
-        using HashTable = HashTable<KeyType, ValueType, Hasher>;
-        using State     = HashTable::State;
-
         gn_assert_with_message(table, "Element doesn't point to a valid hash table!");
-        return index < table->capacity && table->states[index] == State::ALIVE;
+        return index < table->capacity && HashTableInternal::is_alive(table->controls[index]);
     }
 
     // Getters
     inline KeyType& key() const
     {
-        using HashTable = HashTable<KeyType, ValueType, Hasher>;
-        using State     = HashTable::State;
-
         gn_assert_with_message(table, "Element doesn't point to a valid hash table!");
         gn_assert_with_message(index < table->capacity, "Element not valid!");
-        gn_assert_with_message(table->states[index] == State::ALIVE, "Element at index % is not alive! (status %)", index, (u32) table->states[index]);
+        gn_assert_with_message(HashTableInternal::is_alive(table->controls[index]), "Element at index % is not alive! (control byte %)", index, (u32) table->controls[index]);
         return table->keys[index];
     }
 
     inline ValueType& value() const
     {
-        using HashTable = HashTable<KeyType, ValueType, Hasher>;
-        using State     = HashTable::State;
-
         gn_assert_with_message(table, "Element doesn't point to a valid hash table!");
         gn_assert_with_message(index < table->capacity, "Element not valid!");
-        gn_assert_with_message(table->states[index] == State::ALIVE, "Element at index % is not alive! (status %)", index, (u32) table->states[index]);
+        gn_assert_with_message(HashTableInternal::is_alive(table->controls[index]), "Element at index % is not alive! (control byte %)", index, (u32) table->controls[index]);
         return table->values[index];
     }
 };
 
+template <typename KeyType, typename ValueType>
+constexpr u64 hash_table_alignment()
+{
+    return max(max((u64) alignof(KeyType), (u64) alignof(ValueType)), DEFAULT_ALIGNMENT);
+}
+
+// Use this when iterating over all the slots of a table
 HASH_TABLE_TEMPLATE
-inline HashTable<KeyType, ValueType, Hasher> make(Type<HashTable<KeyType, ValueType, Hasher>>, u32 start_cap = 32)
+inline bool is_alive(const HashTable<KeyType, ValueType, Hasher>& table, u32 index)
 {
-    using HashTable = HashTable<KeyType, ValueType, Hasher>;
-    using State     = HashTable::State;
+    gn_assert_with_message(index < table.capacity, "Index out of bounds! (index: %, table capacity: %)", index, table.capacity);
+    return HashTableInternal::is_alive(table.controls[index]);
+}
 
-    HashTable table;
+HASH_TABLE_TEMPLATE
+inline void hash_table_allocate(HashTable<KeyType, ValueType, Hasher>& table, u32 capacity)
+{
+    gn_assert_with_message(is_power_of_2(capacity) && capacity >= HashTableInternal::MIN_CAPACITY, "Hash table capacity must be a power of 2 and at least % slots! (capacity: %)", HashTableInternal::MIN_CAPACITY, capacity);
 
-    table.capacity = max(start_cap, 2Ui32);
-    table.filled   = 0;
-    
-    const u64 size_in_bytes = table.capacity * (sizeof(State) + sizeof(Hash) + sizeof(KeyType) + sizeof(ValueType));
-    void* allocation = platform_allocate(size_in_bytes);
+    // Control bytes go first so they stay 16 byte aligned for group loads.
+    // Keys and values only need padding if they're over aligned.
+    const u64 keys_offset   = HashTableInternal::align_up(capacity * sizeof(u8), alignof(KeyType));
+    const u64 values_offset = HashTableInternal::align_up(keys_offset + capacity * sizeof(KeyType), alignof(ValueType));
+    const u64 size_in_bytes = values_offset + capacity * sizeof(ValueType);
+
+    void* allocation = allocator_allocate(table.allocator, size_in_bytes, hash_table_alignment<KeyType, ValueType>());
     gn_assert_with_message(allocation, "Could not allocate data for hash table!");
 
-    table.states = (State*)     (allocation);
-    table.hashes = (Hash*)      (table.states + table.capacity);
-    table.keys   = (KeyType*)   (table.hashes + table.capacity);
-    table.values = (ValueType*) (table.keys   + table.capacity);
+    table.controls = (u8*)        (allocation);
+    table.keys     = (KeyType*)   (table.controls + keys_offset);
+    table.values   = (ValueType*) (table.controls + values_offset);
 
-    platform_set_memory(table.states, (int) State::EMPTY, table.capacity * sizeof(State));
+    table.capacity    = capacity;
+    table.filled      = 0;
+    table.growth_left = HashTableInternal::max_filled_for_capacity(capacity);
 
-    return table;
+    platform_set_memory(table.controls, HashTableInternal::CONTROL_EMPTY, capacity * sizeof(u8));
 }
 
 HASH_TABLE_TEMPLATE
-inline HashTable<KeyType, ValueType, Hasher> copy(const HashTable<KeyType, ValueType, Hasher>& other)
+inline HashTable<KeyType, ValueType, Hasher> make(Type<HashTable<KeyType, ValueType, Hasher>>, u32 start_cap = 32, Allocator* allocator = nullptr)
 {
-    using HashTable = HashTable<KeyType, ValueType, Hasher>;
-    using State     = HashTable::State;
-
-    HashTable table;
+    HashTable<KeyType, ValueType, Hasher> table = {};
+    table.allocator = allocator;
+    hash_table_allocate(table, next_power_of_2(max(start_cap, HashTableInternal::MIN_CAPACITY)));
+    return table;
+}
 
-    table.capacity = other.capacity;
-    table.filled   = other.filled;
-    
-    const u64 size_in_bytes = table.capacity * (sizeof(State) + sizeof(Hash) + sizeof(KeyType) + sizeof(ValueType));
-    void* allocation = platform_allocate(size_in_bytes);
-    gn_assert_with_message(allocation, "Could not allocate data for hash table!");
+HASH_TABLE_TEMPLATE
+inline HashTable<KeyType, ValueType, Hasher> copy(const HashTable<KeyType, ValueType, Hasher>& other, Allocator* allocator = nullptr)
+{
+    HashTable<KeyType, ValueType, Hasher> table = {};
+    table.hasher    = other.hasher;
+    table.allocator = allocator;
+    hash_table_allocate(table, other.capacity);
 
-    table.states = (State*)     (allocation);
-    table.hashes = (Hash*)      (table.states + table.capacity);
-    table.keys   = (KeyType*)   (table.hashes + table.capacity);
-    table.values = (ValueType*) (table.keys   + table.capacity);
+    table.filled      = other.filled;
+    table.growth_left = other.growth_left;
 
-    // Copy states and hashes
-    platform_copy_memory(table.states, other.states, table.capacity * (sizeof(State) + sizeof(Hash)));
+    // Copy control bytes as they are so the tombstones also end up in the same place
+    platform_copy_memory(table.controls, other.controls, table.capacity * sizeof(u8));
 
     u32 remaining = table.filled;
     for (u32 i = 0; remaining > 0 && i < table.capacity; i++)
     {
         // Copy keys and values when required
-        if (table.states[i] == State::ALIVE)
+        if (HashTableInternal::is_alive(table.controls[i]))
         {
             table.keys[i]   = copy(other.keys[i]);
             table.values[i] = copy(other.values[i]);
@@ -136,24 +248,21 @@ inline HashTable<KeyType, ValueType, Hasher> copy(const HashTable<KeyType, Value
 HASH_TABLE_TEMPLATE
 inline void free(HashTable<KeyType, ValueType, Hasher>& table)
 {
-    platform_free(table.states);
+    allocator_free(table.allocator, table.controls, hash_table_alignment<KeyType, ValueType>());
 
-    table.states = nullptr;
-    table.hashes = nullptr;
-    table.keys   = nullptr;
-    table.values = nullptr;
-    table.capacity = table.filled = 0;
+    table.controls = nullptr;
+    table.keys     = nullptr;
+    table.values   = nullptr;
+    table.capacity = table.filled = table.growth_left = 0;
 }
 
 HASH_TABLE_TEMPLATE
 inline void free_keys(HashTable<KeyType, ValueType, Hasher>& table)
 {
-    using HashTable = HashTable<KeyType, ValueType, Hasher>;
-
     u32 remaining = table.filled;
     for (u32 i = 0; remaining > 0 && i < table.capacity; i++)
     {
-        if (table.states[i] == HashTable::State::ALIVE)
+        if (HashTableInternal::is_alive(table.controls[i]))
         {
             free(table.keys[i]);
             remaining--;
@@ -164,12 +273,10 @@ inline void free_keys(HashTable<KeyType, ValueType, Hasher>& table)
 HASH_TABLE_TEMPLATE
 inline void free_values(HashTable<KeyType, ValueType, Hasher>& table)
 {
-    using HashTable = HashTable<KeyType, ValueType, Hasher>;
-    
     u32 remaining = table.filled;
     for (u32 i = 0; remaining > 0 && i < table.capacity; i++)
     {
-        if (table.states[i] == HashTable::State::ALIVE)
+        if (HashTableInternal::is_alive(table.controls[i]))
         {
             free(table.values[i]);
             remaining--;
@@ -180,13 +287,11 @@ inline void free_values(HashTable<KeyType, ValueType, Hasher>& table)
 HASH_TABLE_TEMPLATE
 inline void free_all(HashTable<KeyType, ValueType, Hasher>& table)
 {
-    using HashTable = HashTable<KeyType, ValueType, Hasher>;
-
     // Free keys and values
     u32 remaining = table.filled;
     for (u32 i = 0; remaining > 0 && i < table.capacity; i++)
     {
-        if (table.states[i] == HashTable::State::ALIVE)
+        if (HashTableInternal::is_alive(table.controls[i]))
         {
             free(table.keys[i]);
             free(table.values[i]);
@@ -198,162 +303,220 @@ inline void free_all(HashTable<KeyType, ValueType, Hasher>& table)
 }
 
 HASH_TABLE_TEMPLATE
-void resize(HashTable<KeyType, ValueType, Hasher>& table, u32 new_capacity)
+inline void clear(HashTable<KeyType, ValueType, Hasher>& table)
 {
-    gn_assert_with_message(new_capacity > table.capacity, "Table can't be resized to be smaller than before! (new_capacity: %, old_capacity: %)", new_capacity, table.capacity);
-
-    using HashTable = HashTable<KeyType, ValueType, Hasher>;
-    using State     = HashTable::State;
+    if (table.capacity == 0)
+        return;
 
-    HashTable new_table;
-    new_table.capacity = new_capacity;
-    new_table.filled   = table.filled;
+    platform_set_memory(table.controls, HashTableInternal::CONTROL_EMPTY, table.capacity * sizeof(u8));
+    table.filled      = 0;
+    table.growth_left = HashTableInternal::max_filled_for_capacity(table.capacity);
+}
 
-    const u64 size_in_bytes = new_table.capacity * (sizeof(State) + sizeof(Hash) + sizeof(KeyType) + sizeof(ValueType));
-    void* allocation = platform_allocate(size_in_bytes);
-    gn_assert_with_message(allocation, "Could not allocate data for resizing hash table!");
+HASH_TABLE_TEMPLATE
+void resize(HashTable<KeyType, ValueType, Hasher>& table, u32 new_capacity)
+{
+    using namespace HashTableInternal;
 
-    new_table.states = (State*)     (allocation);
-    new_table.hashes = (Hash*)      (new_table.states + new_table.capacity);
-    new_table.keys   = (KeyType*)   (new_table.hashes + new_table.capacity);
-    new_table.values = (ValueType*) (new_table.keys   + new_table.capacity);
+    new_capacity = next_power_of_2(max(new_capacity, MIN_CAPACITY));
+    gn_assert_with_message(new_capacity > table.capacity, "Table can't be resized to be smaller than before! (new_capacity: %, old_capacity: %)", new_capacity, table.capacity);
 
-    platform_set_memory(new_table.states, (int) State::EMPTY, new_table.capacity * sizeof(State));
+    HashTable<KeyType, ValueType, Hasher> new_table = {};
+    new_table.hasher    = table.hasher;
+    new_table.allocator = table.allocator;
+    hash_table_allocate(new_table, new_capacity);
 
+    // The new table doesn't have tombstones so the first non alive slot is always empty
     u32 elements_to_copy = table.filled;
     for (u32 old_index = 0; elements_to_copy > 0 && old_index < table.capacity; old_index++)
     {
-        if (table.states[old_index] != State::ALIVE)
+        if (!is_alive(table.controls[old_index]))
             continue;
 
-        // Need to copy element
         elements_to_copy--;
 
-        const Hash hash = table.hashes[old_index];
-        const u32 end_index   = hash % new_table.capacity;
-        const u32 start_index = (end_index + 1) % new_table.capacity;
+        const Hash hash = new_table.hasher(table.keys[old_index]);
+        const u32 index = find_first_non_alive(new_table.controls, new_table.capacity, hash);
 
-        for (u32 i = start_index; i != end_index; i = (i + 1) % new_table.capacity)
-        {
-            if (new_table.states[i] == State::EMPTY)
-            {
-                new_table.states[i] = State::ALIVE;
-                new_table.hashes[i] = hash;
-                new_table.keys[i]   = table.keys[old_index];
-                new_table.values[i] = table.values[old_index];
-
-                break;
-            }
-        }
+        new_table.controls[index] = hash_fragment(hash);
+        new_table.keys[index]     = table.keys[old_index];
+        new_table.values[index]   = table.values[old_index];
     }
 
     gn_assert_with_message(elements_to_copy == 0, "Not all elements were copied when resizing hash table! (elements left to copy: %)", elements_to_copy);
 
-    free(table.states);
+    new_table.filled       = table.filled;
+    new_table.growth_left -= table.filled;
+
+    allocator_free(table.allocator, table.controls, hash_table_alignment<KeyType, ValueType>());
     table = new_table;
 }
 
+// Gets rid of all the tombstones without allocating. Elements are moved to the
+// earliest group in their probe sequence so lookups get short again.
 HASH_TABLE_TEMPLATE
-HashTableElement<KeyType, ValueType, Hasher> find(const HashTable<KeyType, ValueType, Hasher>& table, const KeyType& key)
+void rehash_in_place(HashTable<KeyType, ValueType, Hasher>& table)
 {
-    using HashTable        = HashTable<KeyType, ValueType, Hasher>;
-    using HashTableElement = HashTableElement<KeyType, ValueType, Hasher>;
-    using State            = HashTable::State;
+    using namespace HashTableInternal;
 
-    const Hash hash = table.hasher(key);
-    const u32 end_index   = hash % table.capacity;
-    const u32 start_index = (end_index + 1) % table.capacity;
+    // Turn tombstones into empty slots and mark alive slots as needing a rehash
+    // (tombstone control byte is reused as the marker since there are none left)
+    for (u32 i = 0; i < table.capacity; i++)
+        table.controls[i] = is_alive(table.controls[i]) ? CONTROL_TOMBSTONE : CONTROL_EMPTY;
 
-    for (u32 i = start_index; i != end_index; i = (i + 1) % table.capacity)
+    for (u32 i = 0; i < table.capacity; i++)
     {
-        switch (table.states[i])
+        if (table.controls[i] != CONTROL_TOMBSTONE)
+            continue;
+
+        const Hash hash = table.hasher(table.keys[i]);
+        const u32 target = find_first_non_alive(table.controls, table.capacity, hash);
+
+        // Already in the earliest group it could be in
+        if (target / GROUP_WIDTH == i / GROUP_WIDTH)
+        {
+            table.controls[i] = hash_fragment(hash);
+            continue;
+        }
+
+        if (table.controls[target] == CONTROL_EMPTY)
         {
-            case State::EMPTY:
-                return HashTableElement { &table, table.capacity };
-            
-            case State::ALIVE:
-            {
-                if (hash == table.hashes[i] &&
-                    key  == table.keys[i])
-                {
-                    return HashTableElement { &table, i };
-                }
-            } break;
+            table.controls[target] = hash_fragment(hash);
+            table.keys[target]     = table.keys[i];
+            table.values[target]   = table.values[i];
+            table.controls[i]      = CONTROL_EMPTY;
+            continue;
         }
+
+        // Target still needs to be rehashed, swap and process the current slot again
+        table.controls[target] = hash_fragment(hash);
+        swap(table.keys[target],   table.keys[i]);
+        swap(table.values[target], table.values[i]);
+        i--;
     }
 
-    gn_assert_with_message(false, "Reached end of hash table without finding an empty or valid element!");
-    return HashTableElement { &table, table.capacity };
+    table.growth_left = max_filled_for_capacity(table.capacity) - table.filled;
+}
+
+// Returns the index of the key in the table or the capacity if the key wasn't found
+HASH_TABLE_TEMPLATE
+u32 find_index(const HashTable<KeyType, ValueType, Hasher>& table, const KeyType& key, const Hash hash)
+{
+    using namespace HashTableInternal;
+
+    const u8 fragment = hash_fragment(hash);
+
+    ProbeSequence seq = probe_start(hash, table.capacity);
+    for (u32 probes = 0; probes <= seq.group_mask; probes++)
+    {
+        const Group group = Group::load(table.controls + seq.offset());
+
+        u32 mask = group.match(fragment);
+        while (mask)
+        {
+            const u32 index = seq.offset() + count_trailing_zeros(mask);
+            if (key == table.keys[index])
+                return index;
+
+            mask &= mask - 1;
+        }
+
+        // Key would've been placed in this group if it was in the table
+        if (group.match_empty())
+            return table.capacity;
+
+        seq.next();
+    }
+
+    return table.capacity;
+}
+
+HASH_TABLE_TEMPLATE
+HashTableElement<KeyType, ValueType, Hasher> find(const HashTable<KeyType, ValueType, Hasher>& table, const KeyType& key)
+{
+    using HashTableElement = HashTableElement<KeyType, ValueType, Hasher>;
+
+    // Zero initialized tables don't have any memory
+    if (table.capacity == 0)
+        return HashTableElement { &table, 0 };
+
+    return HashTableElement { &table, find_index(table, key, table.hasher(key)) };
 }
 
 HASH_TABLE_TEMPLATE
 HashTableElement<KeyType, ValueType, Hasher> put(HashTable<KeyType, ValueType, Hasher>& table, const KeyType& key, const ValueType& value)
 {
-    using HashTable        = HashTable<KeyType, ValueType, Hasher>;
+    using namespace HashTableInternal;
     using HashTableElement = HashTableElement<KeyType, ValueType, Hasher>;
-    using State            = HashTable::State;
 
-    const float load = (float) table.filled / (float) table.capacity;
-    if (load >= HASH_TABLE_MAX_LOAD_FACTOR)
-        resize(table, table.capacity * 2);
+    if (table.capacity == 0)
+        hash_table_allocate(table, 2 * MIN_CAPACITY);
 
     const Hash hash = table.hasher(key);
-    const u32 end_index   = hash % table.capacity;
-    const u32 start_index = (end_index + 1) % table.capacity;
 
-    for (u32 i = start_index; i != end_index; i = (i + 1) % table.capacity)
-    {
-        switch (table.states[i])
+    {   // Replace value if key already exists
+        const u32 existing = find_index(table, key, hash);
+        if (existing < table.capacity)
         {
-            case State::EMPTY:
-            case State::TOMBSTONE:
-            {
-                table.filled++;
-
-                table.states[i] = State::ALIVE;
-                table.hashes[i] = hash;
-                table.keys[i]   = key;
-                table.values[i] = value;
-                return HashTableElement { &table, i };
-            }
-            
-            case State::ALIVE:
-            {
-                if (hash == table.hashes[i] &&
-                    key  == table.keys[i])
-                {
-                    table.values[i] = value;
-                    return HashTableElement { &table, i };
-                }
-            } break;
+            table.values[existing] = value;
+            return HashTableElement { &table, existing };
         }
     }
 
-    // Never reached
-    gn_assert_with_message(false, "Ran out of entries in hash table to place element!");
-    return HashTableElement { &table, table.capacity };
+    u32 index = find_first_non_alive(table.controls, table.capacity, hash);
+
+    // Tombstones can be reused without affecting the load
+    if (table.growth_left == 0 && table.controls[index] != CONTROL_TOMBSTONE)
+    {
+        // Reclaim tombstones if they take up a big chunk of the table, grow otherwise
+        if (table.capacity > GROUP_WIDTH && (u64) table.filled * 32 <= (u64) table.capacity * 25)
+            rehash_in_place(table);
+        else
+            resize(table, table.capacity * 2);
+
+        index = find_first_non_alive(table.controls, table.capacity, hash);
+    }
+
+    table.growth_left -= (table.controls[index] == CONTROL_EMPTY);
+    table.filled++;
+
+    table.controls[index] = hash_fragment(hash);
+    table.keys[index]     = key;
+    table.values[index]   = value;
+
+    return HashTableElement { &table, index };
 }
 
 HASH_TABLE_TEMPLATE
 inline void remove(HashTableElement<KeyType, ValueType, Hasher>& element)
 {
-    using HashTable        = HashTable<KeyType, ValueType, Hasher>;
-    using HashTableElement = HashTableElement<KeyType, ValueType, Hasher>;
-    using State            = HashTable::State;
+    using namespace HashTableInternal;
+    using HashTable = HashTable<KeyType, ValueType, Hasher>;
 
     HashTable& table = *(HashTable*)element.table;
 
-    if (element.index >= table.capacity || table.states[element.index] != State::ALIVE)
+    if (element.index >= table.capacity || !is_alive(table.controls[element.index]))
     {
         gn_assert_with_message(false, "Trying to delete a non existing element in hash table! (table index: %)", element.index);
         return;
     }
-    
-    table.states[element.index] = State::TOMBSTONE;
+
+    // If the group still has an empty slot then no probe sequence could've gone
+    // past it, so the slot can be marked empty instead of leaving a tombstone
+    const u32 group_offset = element.index & ~(GROUP_WIDTH - 1);
+    if (Group::load(table.controls + group_offset).match_empty())
+    {
+        table.controls[element.index] = CONTROL_EMPTY;
+        table.growth_left++;
+    }
+    else
+    {
+        table.controls[element.index] = CONTROL_TOMBSTONE;
+    }
+
     table.filled--;
-    
+
     element.index = table.capacity;
 }
 
-#undef HASH_TABLE_MAX_LOAD_FACTOR
 #undef HASH_TABLE_TEMPLATE
\ No newline at end of file
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "core/common.h"
+#include "core/allocator.h"
+#include "core/bit_utils.h"
+#include "core/logger.h"
+#include "core/types.h"
+#include "math/common.h"
+#include "platform/platform.h"
+#include "darray.h"
+
+// Array made of fixed size chunks (a power of 2 elements each). Growing only adds a
+// chunk, existing elements are never moved, so pointers and references to them stay
+// valid until the array is freed. Indexing is a shift and a mask into the chunk table.
+// Chunks are kept around when the array shrinks and get reused by later appends.
+
+constexpr u32 SEGMENTED_ARRAY_DEFAULT_CHUNK_SHIFT = 8;   // 256 elements per chunk
+
+template <typename T>
+struct SegmentedArray
+{
+    DynamicArray<T*> chunks;    // Only the chunk pointers move when this grows
+    u64 size;
+
+    u32 chunk_shift;            // log2 of elements per chunk, 0 means the default (zero initialized arrays work)
+    Allocator* allocator;       // Null means the platform heap
+
+    T& operator[](const u64 index)
+    {
+        gn_assert_with_message(index < size, "Index out of bounds! (index: %, array size: %)", index, size);
+        return chunks.data[index >> chunk_shift][index & ((1ui64 << chunk_shift) - 1)];
+    }
+
+    const T& operator[](const u64 index) const
+    {
+        gn_assert_with_message(index < size, "Index out of bounds! (index: %, array size: %)", index, size);
+        return chunks.data[index >> chunk_shift][index & ((1ui64 << chunk_shift) - 1)];
+    }
+};
+
+// Chunk size has to be a power of 2
+template <typename T>
+inline SegmentedArray<T> make(Type<SegmentedArray<T>>, u64 chunk_size = (1ui64 << SEGMENTED_ARRAY_DEFAULT_CHUNK_SHIFT), Allocator* allocator = nullptr)
+{
+    gn_assert_with_message(chunk_size > 1 && is_power_of_2(chunk_size), "Chunk size needs to be a power of 2! (chunk size: %)", chunk_size);
+
+    SegmentedArray<T> arr = {};
+
+    arr.chunk_shift = count_trailing_zeros(chunk_size);
+    arr.allocator = allocator;
+    arr.chunks = make<DynamicArray<T*>>(16ui64, allocator);
+
+    return arr;
+}
+
+template <typename T>
+inline u64 segmented_array_chunk_size(const SegmentedArray<T>& arr)
+{
+    return 1ui64 << arr.chunk_shift;
+}
+
+template <typename T>
+inline u64 segmented_array_capacity(const SegmentedArray<T>& arr)
+{
+    return arr.chunks.size << arr.chunk_shift;
+}
+
+template <typename T>
+inline void free(SegmentedArray<T>& arr)
+{
+    for (u64 i = 0; i < arr.chunks.size; i++)
+        allocator_free(arr.allocator, arr.chunks.data[i], darray_alignment<T>());
+
+    free(arr.chunks);
+    arr.size = 0;
+}
+
+template <typename T>
+inline void free_all(SegmentedArray<T>& arr)
+{
+    for (u64 i = 0; i < arr.size; i++)
+        free(arr[i]);
+
+    free(arr);
+}
+
+// Chunks are kept for reuse
+template <typename T>
+inline void clear(SegmentedArray<T>& arr)
+{
+    arr.size = 0;
+}
+
+// Allocates chunks until at least capacity elements fit
+template <typename T>
+inline void reserve(SegmentedArray<T>& arr, u64 capacity)
+{
+    if (arr.chunk_shift == 0)
+    {
+        arr.chunk_shift = SEGMENTED_ARRAY_DEFAULT_CHUNK_SHIFT;
+        arr.chunks.allocator = arr.allocator;
+    }
+
+    const u64 chunk_size = segmented_array_chunk_size(arr);
+    while (segmented_array_capacity(arr) < capacity)
+    {
+        T* chunk = (T*) allocator_allocate(arr.allocator, chunk_size * sizeof(T), darray_alignment<T>());
+        gn_assert_with_message(chunk, "Could not allocate chunk for segmented array! (chunk size: %)", chunk_size);
+
+        append(arr.chunks, chunk);
+    }
+}
+
+// Frees the chunks that aren't holding any elements
+template <typename T>
+inline void shrink_to_fit(SegmentedArray<T>& arr)
+{
+    const u64 used_chunks = (arr.size + segmented_array_chunk_size(arr) - 1) >> arr.chunk_shift;
+
+    while (arr.chunks.size > used_chunks)
+        allocator_free(arr.allocator, pop(arr.chunks), darray_alignment<T>());
+}
+
+// Unlike the other arrays this returns the new element, it stays valid until the array is freed
+template <typename T>
+inline T& append(SegmentedArray<T>& arr, const T& elem)
+{
+    if (arr.size >= segmented_array_capacity(arr))
+        reserve(arr, arr.size + 1);
+
+    T& slot = arr.chunks.data[arr.size >> arr.chunk_shift][arr.size & (segmented_array_chunk_size(arr) - 1)];
+    slot = elem;
+    arr.size++;
+
+    return slot;
+}
+
+template <typename T>
+inline void append_many(SegmentedArray<T>& arr, const T* elems, u64 count)
+{
+    reserve(arr, arr.size + count);
+
+    // Copy a chunk at a time
+    const u64 chunk_size = segmented_array_chunk_size(arr);
+    while (count > 0)
+    {
+        const u64 offset = arr.size & (chunk_size - 1);
+        const u64 copy_count = min(count, chunk_size - offset);
+
+        platform_copy_memory(arr.chunks.data[arr.size >> arr.chunk_shift] + offset, elems, copy_count * sizeof(T));
+
+        arr.size += copy_count;
+        elems += copy_count;
+        count -= copy_count;
+    }
+}
+
+template <typename T>
+inline T pop(SegmentedArray<T>& arr)
+{
+    gn_assert_with_message(arr.size > 0, "Trying to pop elements from an array that has 0 elements!");
+
+    const T elem = arr[arr.size - 1];
+    arr.size--;
+
+    return elem;
+}
+
+template <typename T>
+inline T remove_swap(SegmentedArray<T>& arr, u64 index)
+{
+    gn_assert_with_message(index < arr.size,  "Trying to remove from an out of bounds index! (index: %, array size: %)", index, arr.size);
+
+    T removed = arr[index];
+    arr[index] = arr[arr.size - 1];
+    arr.size--;
+
+    return removed;
+}
+
+template <typename T>
+inline u64 find(const SegmentedArray<T>& arr, const T& needle)
+{
+    for (u64 i = 0; i < arr.size; i++)
+    {
+        if (arr[i] == needle)
+            return i;
+    }
+
+    return arr.size;
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "core/common.h"
+#include "core/logger.h"
+#include "core/types.h"
+#include "darray.h"
+
+// Table of values addressed by handles instead of raw indices or pointers.
+// Values are kept packed in one array (erasing moves the last value into the hole),
+// and every handle goes through a slot that knows where its value currently lives.
+// Slots are reused after an erase with their generation bumped, so a handle to an
+// erased value is detected instead of silently pointing at whatever took its place.
+// Insert, erase and lookup are all O(1).
+
+namespace SlotMapInternal
+{
+    // 20 bits of index (about a million live values) and 12 bits of generation
+    constexpr u32 INDEX_BITS      = 20;
+    constexpr u32 INDEX_MASK      = (1u << INDEX_BITS) - 1;
+    constexpr u32 GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+    constexpr u32 MAX_SLOTS       = INDEX_MASK + 1;
+
+    constexpr u32 FREE_LIST_END = ~0u;
+
+    struct Slot
+    {
+        u32 value_index;    // Index into the values if alive, next free slot otherwise
+        u32 generation;     // Never 0 so zero initialized handles are never valid
+    };
+}
+
+// The type is only there so handles to different tables can't be mixed up
+template <typename T>
+struct Handle
+{
+    u32 value;  // 0 is the null handle
+
+    operator bool() const
+    {
+        return value != 0;
+    }
+};
+
+template <typename T>
+inline bool operator==(const Handle<T>& a, const Handle<T>& b)
+{
+    return a.value == b.value;
+}
+
+template <typename T>
+inline bool operator!=(const Handle<T>& a, const Handle<T>& b)
+{
+    return a.value != b.value;
+}
+
+template <typename T>
+inline u32 handle_get_index(const Handle<T> handle)
+{
+    return handle.value & SlotMapInternal::INDEX_MASK;
+}
+
+template <typename T>
+inline u32 handle_get_generation(const Handle<T> handle)
+{
+    return handle.value >> SlotMapInternal::INDEX_BITS;
+}
+
+template <typename T>
+struct SlotMap
+{
+    // Live values, packed, in no particular order. Iterate over these directly.
+    DynamicArray<T>   values;
+    DynamicArray<u32> value_slots;  // Slot of each value, used to fix up the slot when a value is moved
+
+    DynamicArray<SlotMapInternal::Slot> slots;
+    u32 free_head;
+};
+
+template <typename T>
+inline SlotMap<T> make(Type<SlotMap<T>>, u64 start_cap = 16, Allocator* allocator = nullptr)
+{
+    SlotMap<T> map;
+
+    map.values      = make<DynamicArray<T>>(start_cap, allocator);
+    map.value_slots = make<DynamicArray<u32>>(start_cap, allocator);
+    map.slots       = make<DynamicArray<SlotMapInternal::Slot>>(start_cap, allocator);
+    map.free_head   = SlotMapInternal::FREE_LIST_END;
+
+    return map;
+}
+
+template <typename T>
+inline void free(SlotMap<T>& map)
+{
+    free(map.values);
+    free(map.value_slots);
+    free(map.slots);
+    map.free_head = SlotMapInternal::FREE_LIST_END;
+}
+
+// Every handle given out before this becomes stale
+template <typename T>
+inline void clear(SlotMap<T>& map)
+{
+    using namespace SlotMapInternal;
+
+    for (u64 i = 0; i < map.value_slots.size; i++)
+    {
+        Slot& slot = map.slots[map.value_slots[i]];
+        slot.generation = ((slot.generation + 1) & GENERATION_MASK) ? slot.generation + 1 : 1;
+        slot.value_index = map.free_head;
+        map.free_head = map.value_slots[i];
+    }
+
+    clear(map.values);
+    clear(map.value_slots);
+}
+
+template <typename T>
+inline Handle<T> insert(SlotMap<T>& map, const T& value)
+{
+    using namespace SlotMapInternal;
+
+    u32 slot_index;
+    if (map.free_head != FREE_LIST_END)
+    {
+        slot_index = map.free_head;
+        map.free_head = map.slots[slot_index].value_index;
+    }
+    else
+    {
+        gn_assert_with_message(map.slots.size < MAX_SLOTS, "Slot map is full! (max slots: %)", MAX_SLOTS);
+
+        slot_index = (u32) map.slots.size;
+        append(map.slots, Slot { 0, 1 });
+    }
+
+    Slot& slot = map.slots[slot_index];
+    slot.value_index = (u32) map.values.size;
+
+    append(map.values, value);
+    append(map.value_slots, slot_index);
+
+    return Handle<T> { (slot.generation << INDEX_BITS) | slot_index };
+}
+
+// Returns null if the handle is null or its value has been erased
+template <typename T>
+inline T* get(SlotMap<T>& map, const Handle<T> handle)
+{
+    const u32 slot_index = handle_get_index(handle);
+    if (slot_index >= map.slots.size || map.slots[slot_index].generation != handle_get_generation(handle))
+        return nullptr;
+
+    return &map.values[map.slots[slot_index].value_index];
+}
+
+template <typename T>
+inline const T* get(const SlotMap<T>& map, const Handle<T> handle)
+{
+    return get(const_cast<SlotMap<T>&>(map), handle);
+}
+
+template <typename T>
+inline bool contains(const SlotMap<T>& map, const Handle<T> handle)
+{
+    return get(map, handle) != nullptr;
+}
+
+// Returns false if the handle was already stale
+template <typename T>
+inline bool erase(SlotMap<T>& map, const Handle<T> handle)
+{
+    using namespace SlotMapInternal;
+
+    const u32 slot_index = handle_get_index(handle);
+    if (slot_index >= map.slots.size || map.slots[slot_index].generation != handle_get_generation(handle))
+        return false;
+
+    Slot& slot = map.slots[slot_index];
+
+    // Move the last value into the hole
+    const u32 value_index = slot.value_index;
+    remove_swap(map.values, value_index);
+    remove_swap(map.value_slots, value_index);
+
+    if (value_index < map.value_slots.size)
+        map.slots[map.value_slots[value_index]].value_index = value_index;
+
+    // Generations wrap around but skip 0
+    slot.generation = ((slot.generation + 1) & GENERATION_MASK) ? slot.generation + 1 : 1;
+    slot.value_index = map.free_head;
+    map.free_head = slot_index;
+
+    return true;
+}
+
+// Handle to the value at a position in the packed values array
+template <typename T>
+inline Handle<T> slot_map_get_handle(const SlotMap<T>& map, u64 value_index)
+{
+    const u32 slot_index = map.value_slots[value_index];
+    return Handle<T> { (map.slots[slot_index].generation << SlotMapInternal::INDEX_BITS) | slot_index };
+}
\ No newline at end of file
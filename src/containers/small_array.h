@@ -0,0 +1,211 @@
+#pragma once
+
+#include "core/common.h"
+#include "core/allocator.h"
+#include "core/logger.h"
+#include "core/types.h"
+#include "math/common.h"
+#include "platform/platform.h"
+#include "darray.h"
+
+// Array that keeps up to N elements inside the struct and only goes to the heap when
+// it grows past that. Meant for collections that are almost always tiny (json arrays,
+// stacks that are a couple of levels deep), where a DynamicArray would cost an
+// allocation each. Works with the same free functions as DynamicArray.
+// There's no pointer into the inline storage, so the array can be copied around with
+// memcpy like the other containers. Zero initialized arrays are valid and empty.
+
+template <typename T, u64 N>
+struct SmallArray
+{
+    static_assert(N > 0, "Small array needs room for at least one element inline!");
+
+    union
+    {
+        T  storage[N];  // Used while capacity <= N
+        T* heap;
+    };
+
+    u64 size;
+    u64 capacity;       // 0 or N while the elements are inline
+
+    Allocator* allocator;   // Null means the platform heap
+
+    T& operator[](const u64 index)
+    {
+        gn_assert_with_message(index < size, "Index out of bounds! (index: %, array size: %)", index, size);
+        return (capacity > N) ? heap[index] : storage[index];
+    }
+
+    const T& operator[](const u64 index) const
+    {
+        gn_assert_with_message(index < size, "Index out of bounds! (index: %, array size: %)", index, size);
+        return (capacity > N) ? heap[index] : storage[index];
+    }
+};
+
+// Nothing is allocated until the array outgrows its inline storage
+template <typename T, u64 N>
+inline SmallArray<T, N> make(Type<SmallArray<T, N>>, Allocator* allocator = nullptr)
+{
+    SmallArray<T, N> arr = {};
+
+    arr.capacity = N;
+    arr.allocator = allocator;
+
+    return arr;
+}
+
+template <typename T, u64 N>
+inline bool small_array_is_inline(const SmallArray<T, N>& arr)
+{
+    return arr.capacity <= N;
+}
+
+template <typename T, u64 N>
+inline T* small_array_data(SmallArray<T, N>& arr)
+{
+    return small_array_is_inline(arr) ? arr.storage : arr.heap;
+}
+
+template <typename T, u64 N>
+inline const T* small_array_data(const SmallArray<T, N>& arr)
+{
+    return small_array_is_inline(arr) ? arr.storage : arr.heap;
+}
+
+template <typename T, u64 N>
+inline void free(SmallArray<T, N>& arr)
+{
+    if (!small_array_is_inline(arr))
+        allocator_free(arr.allocator, arr.heap, darray_alignment<T>());
+
+    arr.size = 0;
+    arr.capacity = N;
+}
+
+template <typename T, u64 N>
+inline void free_all(SmallArray<T, N>& arr)
+{
+    T* data = small_array_data(arr);
+    for (u64 i = 0; i < arr.size; i++)
+        free(data[i]);
+
+    free(arr);
+}
+
+// Heap storage (if any) is kept for reuse
+template <typename T, u64 N>
+inline void clear(SmallArray<T, N>& arr)
+{
+    arr.size = 0;
+}
+
+// Makes room for at least new_capacity elements, moves the elements to the heap the first time
+template <typename T, u64 N>
+inline void reserve(SmallArray<T, N>& arr, u64 new_capacity)
+{
+    if (new_capacity <= max(arr.capacity, N))
+        return;
+
+    if (small_array_is_inline(arr))
+    {
+        T* new_data = (T*) allocator_allocate(arr.allocator, new_capacity * sizeof(T), darray_alignment<T>());
+        gn_assert_with_message(new_data, "Could not allocate data for small array!");
+
+        // Storage and the heap pointer overlap, so copy out before setting it
+        platform_copy_memory(new_data, arr.storage, arr.size * sizeof(T));
+        arr.heap = new_data;
+    }
+    else
+    {
+        T* new_data = (T*) allocator_reallocate(arr.allocator, arr.heap, arr.capacity * sizeof(T), new_capacity * sizeof(T), darray_alignment<T>());
+        gn_assert_with_message(new_data, "Could not reallocate data for small array!");
+
+        arr.heap = new_data;
+    }
+
+    arr.capacity = new_capacity;
+}
+
+template <typename T, u64 N>
+inline SmallArray<T, N>& append(SmallArray<T, N>& arr, const T& elem)
+{
+    if (arr.size >= max(arr.capacity, N))
+    {
+        // Copy first since elem could be pointing into the array
+        const T copied = elem;
+        reserve(arr, max(2 * arr.size, 2 * N));
+
+        small_array_data(arr)[arr.size++] = copied;
+        return arr;
+    }
+
+    small_array_data(arr)[arr.size++] = elem;
+    return arr;
+}
+
+template <typename T, u64 N>
+inline SmallArray<T, N>& append_many(SmallArray<T, N>& arr, const T* elems, u64 count)
+{
+    if (arr.size + count > max(arr.capacity, N))
+        reserve(arr, max(2 * arr.capacity, arr.size + count));
+
+    platform_copy_memory(small_array_data(arr) + arr.size, elems, count * sizeof(T));
+    arr.size += count;
+
+    return arr;
+}
+
+template <typename T, u64 N>
+inline T pop(SmallArray<T, N>& arr)
+{
+    gn_assert_with_message(arr.size > 0, "Trying to pop elements from an array that has 0 elements!");
+    return small_array_data(arr)[--arr.size];
+}
+
+template <typename T, u64 N>
+inline T remove(SmallArray<T, N>& arr, u64 index)
+{
+    gn_assert_with_message(arr.size > 0, "Trying to remove elements from an array that has 0 elements!");
+    gn_assert_with_message(index < arr.size,  "Trying to remove from an out of bounds index! (index: %, array size: %)", index, arr.size);
+
+    T* data = small_array_data(arr);
+    T removed = data[index];
+
+    // Move all values back by 1 index
+    for (u64 i = index; i < arr.size - 1; i++)
+        data[i] = data[i + 1];
+
+    arr.size--;
+
+    return removed;
+}
+
+template <typename T, u64 N>
+inline T remove_swap(SmallArray<T, N>& arr, u64 index)
+{
+    gn_assert_with_message(arr.size > 0, "Trying to remove elements from an array that has 0 elements!");
+    gn_assert_with_message(index < arr.size,  "Trying to remove from an out of bounds index! (index: %, array size: %)", index, arr.size);
+
+    T* data = small_array_data(arr);
+    T removed = data[index];
+
+    arr.size--;
+    data[index] = data[arr.size];
+
+    return removed;
+}
+
+template <typename T, u64 N>
+inline u64 find(const SmallArray<T, N>& arr, const T& needle)
+{
+    const T* data = small_array_data(arr);
+    for (u64 i = 0; i < arr.size; i++)
+    {
+        if (data[i] == needle)
+            return i;
+    }
+
+    return arr.size;
+}
\ No newline at end of file
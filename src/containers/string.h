@@ -5,6 +5,7 @@
 #include <cstring>
 #include "core/types.h"
 #include "core/common.h"
+#include "core/allocator.h"
 #include "core/logger.h"
 #include "math/common.h"
 #include "platform/platform.h"
@@ -74,14 +75,15 @@ inline String ref(char* cstr)
     return String { cstr, strlen(cstr) };
 }
 
-inline String copy(const String& other)
+// Strings don't keep track of their allocator, the same one has to be passed when freeing
+inline String copy(const String& other, Allocator* allocator = nullptr)
 {
     String str;
 
     str.size = other.size;
 
     const u64 data_size = str.size * sizeof(char);
-    str.data = (char*) platform_allocate(data_size);
+    str.data = (char*) allocator_allocate(allocator, data_size, alignof(char));
     gn_assert_with_message(str.data, "Could not allocate data for string!");
 
     platform_copy_memory(str.data, other.data, data_size);
@@ -97,19 +99,19 @@ inline void string_copy_into(String& dest, const String& src)
     dest.data[dest.size] = '\0';
 }
 
-inline void free(String& str)
+inline void free(String& str, Allocator* allocator = nullptr)
 {
-    platform_free(str.data);
+    allocator_free(allocator, str.data);
 
     str.data = nullptr;
     str.size = 0;
 }
 
 // Reallocates
-inline void resize(String& str, u64 size)
+inline void resize(String& str, u64 size, Allocator* allocator = nullptr)
 {
+    str.data = (char*) allocator_reallocate(allocator, str.data, str.size * sizeof(char), size * sizeof(char), alignof(char));
     str.size = size;
-    str.data = (char*) platform_reallocate(str.data, str.size * sizeof(char));
     gn_assert_with_message(str.data, "Could not reallocate data for string!");
 }
 
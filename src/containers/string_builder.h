@@ -1,31 +1,221 @@
 #pragma once
 
-#include <cstdlib>
 #include "core/types.h"
-#include "darray.h"
+#include "core/common.h"
+#include "core/allocator.h"
+#include "core/logger.h"
+#include "core/number_conversion.h"
+#include "math/common.h"
 #include "string.h"
 #include "platform/platform.h"
 
-using StringBuilder = DynamicArray<String>;
+// Contiguous growable byte buffer. Appends copy the bytes in, so the pieces don't need
+// to outlive the builder, and the result can be handed out as a String without copying.
+// A builder can also write into a caller owned buffer, in which case it never grows
+// and anything that doesn't fit is dropped (check truncated).
 
-inline String build_string(const StringBuilder& builder)
+struct StringBuilder
 {
-    u64 total_size = 0;
-    for (u64 i = 0; i < builder.size; i++)
-        total_size += builder[i].size;
-    
-    // Initialize new string
-    String str;
-    str.size = total_size;
-    str.data = (char*) platform_allocate(str.size * sizeof(char));
+    char* data;
+    u64 size;
+    u64 capacity;
 
-    // Copy strings to new string
-    u64 offset = 0;
-    for (u64 i = 0; i < builder.size; i++)
+    Allocator* allocator;   // Null means the platform heap
+    bool fixed;             // Caller owned buffer, never reallocated or freed
+    bool truncated;         // A fixed builder ran out of space
+};
+
+inline StringBuilder make(Type<StringBuilder>, u64 start_cap = 64, Allocator* allocator = nullptr)
+{
+    StringBuilder builder = {};
+
+    builder.capacity = start_cap;
+    builder.allocator = allocator;
+    builder.data = (char*) allocator_allocate(builder.allocator, builder.capacity * sizeof(char), alignof(char));
+    gn_assert_with_message(builder.data, "Could not allocate data for string builder!");
+
+    return builder;
+}
+
+// Writes into the buffer, useful for formatting on the stack
+inline StringBuilder make(Type<StringBuilder>, char* buffer, u64 capacity)
+{
+    StringBuilder builder = {};
+
+    builder.data = buffer;
+    builder.capacity = capacity;
+    builder.fixed = true;
+
+    return builder;
+}
+
+inline void free(StringBuilder& builder)
+{
+    if (!builder.fixed)
+        allocator_free(builder.allocator, builder.data, alignof(char));
+
+    builder.data = nullptr;
+    builder.size = 0;
+    builder.capacity = 0;
+}
+
+inline void clear(StringBuilder& builder)
+{
+    builder.size = 0;
+    builder.truncated = false;
+}
+
+// Makes room for count more bytes, returns how many of them can actually be written
+inline u64 reserve(StringBuilder& builder, u64 count)
+{
+    const u64 required = builder.size + count;
+    if (required <= builder.capacity)
+        return count;
+
+    if (builder.fixed)
+    {
+        builder.truncated = true;
+        return builder.capacity - builder.size;
+    }
+
+    const u64 new_capacity = max(max(builder.capacity * 2, required), 16ui64);
+    builder.data = (char*) allocator_reallocate(builder.allocator, builder.data, builder.capacity * sizeof(char), new_capacity * sizeof(char), alignof(char));
+    gn_assert_with_message(builder.data, "Could not reallocate data for string builder! (new capacity: %)", new_capacity);
+
+    builder.capacity = new_capacity;
+    return count;
+}
+
+inline void append(StringBuilder& builder, const String str)
+{
+    const u64 count = reserve(builder, str.size);
+    platform_copy_memory(builder.data + builder.size, str.data, count);
+    builder.size += count;
+}
+
+inline void append(StringBuilder& builder, const char* cstring)
+{
+    append(builder, ref((char*) cstring));
+}
+
+inline void append(StringBuilder& builder, char c)
+{
+    if (reserve(builder, 1) == 1)
+        builder.data[builder.size++] = c;
+}
+
+inline void append(StringBuilder& builder, bool boolean)
+{
+    append(builder, (boolean) ? "true" : "false");
+}
+
+inline void append_repeated(StringBuilder& builder, char c, u64 count)
+{
+    count = reserve(builder, count);
+    for (u64 i = 0; i < count; i++)
+        builder.data[builder.size + i] = c;
+
+    builder.size += count;
+}
+
+inline void append(StringBuilder& builder, s64 number)
+{
+    char temp_buffer[MAX_INTEGER_CHARS];
+    append(builder, ref(temp_buffer, format_s64(temp_buffer, number)));
+}
+
+inline void append(StringBuilder& builder, u64 number)
+{
+    char temp_buffer[MAX_INTEGER_CHARS];
+    append(builder, ref(temp_buffer, format_u64(temp_buffer, number)));
+}
+
+inline void append(StringBuilder& builder, f64 number)
+{
+    char temp_buffer[MAX_FLOAT_CHARS];
+    append(builder, ref(temp_buffer, format_f64(temp_buffer, number)));
+}
+
+inline void append(StringBuilder& builder, f32 number)
+{
+    char temp_buffer[MAX_FLOAT_CHARS];
+    append(builder, ref(temp_buffer, format_f32(temp_buffer, number)));
+}
+
+inline void append(StringBuilder& builder, s32 number) { append(builder, (s64) number); }
+inline void append(StringBuilder& builder, u32 number) { append(builder, (u64) number); }
+
+// Appends the format string up to the next placeholder and returns a pointer to it
+// (or to the terminator). "\%" is written out as a plain '%'.
+inline const char* string_builder_append_until_placeholder(StringBuilder& builder, const char* format)
+{
+    const char* start = format;
+    while (*format != '\0')
+    {
+        if (*format == '%')
+            break;
+
+        if (format[0] == '\\' && format[1] == '%')
+        {
+            append(builder, ref((char*) start, (u64) (format - start)));
+            append(builder, '%');
+
+            format += 2;
+            start = format;
+            continue;
+        }
+
+        format++;
+    }
+
+    append(builder, ref((char*) start, (u64) (format - start)));
+    return format;
+}
+
+// Same placeholder syntax as the logger, each % is replaced by the next argument
+inline void append_format(StringBuilder& builder, const char* format)
+{
+    // Placeholders without an argument are kept as they are
+    while (*(format = string_builder_append_until_placeholder(builder, format)) == '%')
     {
-        platform_copy_memory(str.data + offset, builder[i].data, builder[i].size * sizeof(char));
-        offset += builder[i].size;
+        append(builder, '%');
+        format++;
     }
+}
+
+template <typename T, typename... Types>
+void append_format(StringBuilder& builder, const char* format, const T& item, Types... args)
+{
+    format = string_builder_append_until_placeholder(builder, format);
+    if (*format != '%')
+        return;
+
+    append(builder, item);
+    append_format(builder, format + 1, args...);
+}
+
+// View into the builder, only valid until the next append
+inline String get_string(const StringBuilder& builder)
+{
+    return String { builder.data, builder.size };
+}
+
+// Copies the contents, the builder can be reused or freed afterwards
+inline String build_string(const StringBuilder& builder, Allocator* allocator = nullptr)
+{
+    return copy(get_string(builder), allocator);
+}
+
+// Formats into memory from the arena, the builder's storage becomes the string
+template <typename... Types>
+inline String arena_format(Arena& arena, const char* format, Types... args)
+{
+    StringBuilder builder = make<StringBuilder>(64ui64, arena_allocator(arena));
+    append_format(builder, format, args...);
+
+    // Give back the unused part
+    if (builder.data == arena.last_allocation)
+        arena_reallocate(arena, builder.data, builder.capacity, builder.size, alignof(char));
 
-    return str;
+    return get_string(builder);
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "allocator.h"
+
+#include "math/common.h"
+
+static inline u64 arena_min_block_size(const Arena& arena)
+{
+    return (arena.block_size != 0) ? arena.block_size : ARENA_DEFAULT_BLOCK_SIZE;
+}
+
+// Every new block is at least twice the size of the last one (up to a point), so a big
+// arena is made of a handful of blocks instead of thousands of minimum sized ones
+static inline u64 arena_next_block_size(const Arena& arena)
+{
+    const u64 min_size = arena_min_block_size(arena);
+    if (!arena.current)
+        return min_size;
+
+    return max(min_size, min(2 * arena.current->capacity, ARENA_MAX_GROWN_BLOCK_SIZE));
+}
+
+static ArenaBlock* arena_push_block(Arena& arena, u64 capacity)
+{
+    ArenaBlock* block = (ArenaBlock*) platform_allocate(sizeof(ArenaBlock) + capacity);
+    gn_assert_with_message(block, "Could not allocate block for arena! (block size: %)", capacity);
+
+    block->previous = arena.current;
+    block->capacity = capacity;
+    block->used     = 0;
+
+    arena.current = block;
+    return block;
+}
+
+static void arena_pop_block(Arena& arena)
+{
+    ArenaBlock* block = arena.current;
+    arena.current = block->previous;
+    platform_free(block);
+}
+
+void free(Arena& arena)
+{
+    while (arena.current)
+        arena_pop_block(arena);
+
+    arena.last_allocation = nullptr;
+}
+
+void* arena_allocate_new_block(Arena& arena, u64 size, u64 alignment)
+{
+    // Leave room for aligning the start of the allocation
+    const u64 required = size + alignment - 1;
+    arena_push_block(arena, max(required, arena_next_block_size(arena)));
+
+    return arena_allocate(arena, size, alignment);
+}
+
+void* arena_reallocate(Arena& arena, void* block, u64 old_size, u64 new_size, u64 alignment)
+{
+    if (!block)
+        return arena_allocate(arena, new_size, alignment);
+
+    {   // Latest allocation can be resized in place if it still fits in the block
+        ArenaBlock* current = arena.current;
+        if (block == arena.last_allocation && ((u64) block & (alignment - 1)) == 0)
+        {
+            const u64 offset = (u8*) block - arena_block_data(current);
+            if (offset + new_size <= current->capacity)
+            {
+                current->used = offset + new_size;
+                return block;
+            }
+        }
+    }
+
+    void* new_block = arena_allocate(arena, new_size, alignment);
+    platform_copy_memory(new_block, block, min(old_size, new_size));
+
+    return new_block;
+}
+
+void arena_free(Arena& arena, void* block)
+{
+    if (!block || block != arena.last_allocation)
+        return;
+
+    arena.current->used = (u8*) block - arena_block_data(arena.current);
+    arena.last_allocation = nullptr;
+}
+
+void arena_reset(Arena& arena)
+{
+    arena.last_allocation = nullptr;
+
+    if (!arena.current)
+        return;
+
+    if (arena.current->previous)
+    {
+        // Merge all the blocks so the arena doesn't spill next time
+        u64 total_capacity = 0;
+        while (arena.current)
+        {
+            total_capacity += arena.current->capacity;
+            arena_pop_block(arena);
+        }
+
+        arena_push_block(arena, total_capacity);
+        return;
+    }
+
+    arena.current->used = 0;
+}
+
+void arena_restore(Arena& arena, ArenaMarker marker)
+{
+    arena.last_allocation = nullptr;
+
+    // Blocks taken before the marker can still be in use by an outer marker, so only the ones
+    // after it are freed and merging is left to arena_reset. A marker taken before the first
+    // block keeps that block around, no other marker can point past it.
+    ArenaBlock* stop = marker.block;
+    if (!stop)
+    {
+        if (!arena.current)
+            return;
+
+        while (arena.current->previous)
+            arena_pop_block(arena);
+
+        arena.current->used = 0;
+        return;
+    }
+
+    while (arena.current != stop)
+    {
+        gn_assert_with_message(arena.current, "Arena marker doesn't belong to this arena or was already restored!");
+        arena_pop_block(arena);
+    }
+
+    gn_assert_with_message(marker.used <= arena.current->used, "Arena marker was already restored! (marker: %, used: %)", marker.used, arena.current->used);
+
+    arena.current->used = marker.used;
+}
+
+static void* arena_allocate_proc(void* data, u64 size, u64 alignment)
+{
+    return arena_allocate(*(Arena*) data, size, alignment);
+}
+
+static void* arena_reallocate_proc(void* data, void* block, u64 old_size, u64 new_size, u64 alignment)
+{
+    return arena_reallocate(*(Arena*) data, block, old_size, new_size, alignment);
+}
+
+static void arena_free_proc(void* data, void* block)
+{
+    arena_free(*(Arena*) data, block);
+}
+
+Allocator* arena_allocator(Arena& arena)
+{
+    arena.allocator.allocate_proc   = arena_allocate_proc;
+    arena.allocator.reallocate_proc = arena_reallocate_proc;
+    arena.allocator.free_proc       = arena_free_proc;
+    arena.allocator.data            = &arena;
+
+    return &arena.allocator;
+}
+
+constexpr u64 FRAME_ARENA_BLOCK_SIZE   = 1024 * 1024;
+constexpr u64 SCRATCH_ARENA_BLOCK_SIZE = 256 * 1024;
+
+static Arena frame_arena = { nullptr, FRAME_ARENA_BLOCK_SIZE };
+static thread_local Arena scratch_arena = { nullptr, SCRATCH_ARENA_BLOCK_SIZE };
+
+Arena& get_frame_arena()
+{
+    return frame_arena;
+}
+
+Arena& get_scratch_arena()
+{
+    return scratch_arena;
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "core/types.h"
+#include "core/common.h"
+#include "core/logger.h"
+#include "platform/platform.h"
+
+// Containers carry a pointer to an Allocator, a null allocator means the memory
+// comes from platform_allocate. The allocator has to outlive every container using it.
+// Heap blocks with an alignment above the default go through the aligned platform
+// functions, so the same alignment has to be passed when reallocating and freeing.
+
+constexpr u64 DEFAULT_ALIGNMENT = 16;   // Same as what malloc guarantees on x64
+
+struct Allocator
+{
+    void* (*allocate_proc)(void* data, u64 size, u64 alignment);
+    void* (*reallocate_proc)(void* data, void* block, u64 old_size, u64 new_size, u64 alignment);
+    void  (*free_proc)(void* data, void* block);
+
+    void* data;
+};
+
+inline void* allocator_allocate(Allocator* allocator, u64 size, u64 alignment = DEFAULT_ALIGNMENT)
+{
+    if (!allocator)
+    {
+        if (alignment > DEFAULT_ALIGNMENT)
+            return platform_allocate_aligned(size, alignment);
+
+        return platform_allocate(size);
+    }
+
+    return allocator->allocate_proc(allocator->data, size, alignment);
+}
+
+// Old size is needed by allocators that can't look up the size of a block
+inline void* allocator_reallocate(Allocator* allocator, void* block, u64 old_size, u64 new_size, u64 alignment = DEFAULT_ALIGNMENT)
+{
+    if (!allocator)
+    {
+        if (alignment > DEFAULT_ALIGNMENT)
+            return platform_reallocate_aligned(block, new_size, alignment);
+
+        return platform_reallocate(block, new_size);
+    }
+
+    return allocator->reallocate_proc(allocator->data, block, old_size, new_size, alignment);
+}
+
+inline void allocator_free(Allocator* allocator, void* block, u64 alignment = DEFAULT_ALIGNMENT)
+{
+    if (!allocator)
+    {
+        if (alignment > DEFAULT_ALIGNMENT)
+            platform_free_aligned(block);
+        else
+            platform_free(block);
+
+        return;
+    }
+
+    allocator->free_proc(allocator->data, block);
+}
+
+// Bump allocator made of a chain of blocks. Individual allocations can't be freed
+// (except the latest one), the whole arena gets reset or rolled back to a marker instead.
+// A zero initialized arena is valid, the first block is allocated on first use.
+
+constexpr u64 ARENA_DEFAULT_BLOCK_SIZE = 64 * 1024;
+constexpr u64 ARENA_MAX_GROWN_BLOCK_SIZE = 64 * 1024 * 1024;    // Blocks stop doubling here
+
+struct ArenaBlock
+{
+    ArenaBlock* previous;
+    u64 capacity;
+    u64 used;
+
+    // Block data follows the header
+};
+
+struct Arena
+{
+    ArenaBlock* current;
+    u64 block_size;         // Minimum size for new blocks, 0 means ARENA_DEFAULT_BLOCK_SIZE (they grow from there)
+    void* last_allocation;  // Can be grown or freed in place
+
+    Allocator allocator;
+};
+
+struct ArenaMarker
+{
+    ArenaBlock* block;
+    u64 used;
+};
+
+template<>
+inline Arena make(Type<Arena>, u64 block_size)
+{
+    Arena arena = {};
+    arena.block_size = block_size;
+    return arena;
+}
+
+void free(Arena& arena);
+
+void* arena_allocate_new_block(Arena& arena, u64 size, u64 alignment);
+
+inline u8* arena_block_data(ArenaBlock* block)
+{
+    return (u8*) (block + 1);
+}
+
+inline void* arena_allocate(Arena& arena, u64 size, u64 alignment = DEFAULT_ALIGNMENT)
+{
+    gn_assert_with_message(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2! (alignment: %)", alignment);
+
+    ArenaBlock* block = arena.current;
+    if (block)
+    {
+        const u64 address = (u64) (arena_block_data(block) + block->used);
+        const u64 aligned = (address + alignment - 1) & ~(alignment - 1);
+        const u64 new_used = block->used + (aligned - address) + size;
+
+        if (new_used <= block->capacity)
+        {
+            block->used = new_used;
+            arena.last_allocation = (void*) aligned;
+            return (void*) aligned;
+        }
+    }
+
+    return arena_allocate_new_block(arena, size, alignment);
+}
+
+void* arena_reallocate(Arena& arena, void* block, u64 old_size, u64 new_size, u64 alignment = DEFAULT_ALIGNMENT);
+
+// Only reclaims memory if the block was the latest allocation
+void arena_free(Arena& arena, void* block);
+
+// Keeps the memory around. If the arena spilled into multiple blocks they're
+// merged into a single one so the next round doesn't need to allocate.
+void arena_reset(Arena& arena);
+
+inline ArenaMarker arena_get_marker(const Arena& arena)
+{
+    return ArenaMarker { arena.current, arena.current ? arena.current->used : 0 };
+}
+
+// Frees everything allocated after the marker was taken, blocks added since then are freed.
+// Doesn't merge blocks, call arena_reset where nothing is using the arena (like between frames) for that.
+void arena_restore(Arena& arena, ArenaMarker marker);
+
+// The returned allocator points to the arena, so the arena must not be moved while it's in use
+Allocator* arena_allocator(Arena& arena);
+
+// Reset at the start of every frame, use it for data that doesn't need to live longer than a frame
+Arena& get_frame_arena();
+
+// Thread local arena for temporary allocations. Take a marker before using it
+// and restore the marker when done so nested users don't step on each other.
+// The main thread's one gets reset every frame, so it doesn't keep spilling.
+Arena& get_scratch_arena();
\ No newline at end of file
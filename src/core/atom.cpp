@@ -0,0 +1,122 @@
+#include "atom.h"
+
+#include <atomic>
+#include <emmintrin.h>
+#include "core/logger.h"
+#include "core/allocator.h"
+#include "containers/hash_table.h"
+
+// Strings are stored in chunks that never move, so looking up the string for
+// an atom doesn't need the lock. Chunks are published before the atom count is
+// bumped, so any id a thread has seen points to initialized memory.
+
+constexpr u32 ATOM_CHUNK_SIZE = 4096;
+constexpr u32 MAX_ATOM_CHUNKS = 1024;   // ~4 million atoms
+
+struct AtomTable
+{
+    std::atomic<String*> chunks[MAX_ATOM_CHUNKS];
+    std::atomic<u32>     count;
+
+    // Everything below is protected by the lock
+    std::atomic<bool>     locked;
+    Arena                 storage;      // String bytes and chunks
+    HashTable<String, Atom> lookup;     // Keys point into storage
+};
+
+static AtomTable atom_table;
+
+static inline void lock_atom_table()
+{
+    while (atom_table.locked.exchange(true, std::memory_order_acquire))
+    {
+        while (atom_table.locked.load(std::memory_order_relaxed))
+            _mm_pause();
+    }
+}
+
+static inline void unlock_atom_table()
+{
+    atom_table.locked.store(false, std::memory_order_release);
+}
+
+static inline String* get_chunk(u32 id)
+{
+    return atom_table.chunks[id / ATOM_CHUNK_SIZE].load(std::memory_order_acquire);
+}
+
+Atom atom_intern(const String str)
+{
+    lock_atom_table();
+
+    {   // Already interned
+        auto elem = find(atom_table.lookup, str);
+        if (elem)
+        {
+            const Atom atom = elem.value();
+            unlock_atom_table();
+            return atom;
+        }
+    }
+
+    // Id 0 is reserved for ATOM_NONE
+    const u32 id = max(atom_table.count.load(std::memory_order_relaxed), 1u);
+    gn_assert_with_message(id < ATOM_CHUNK_SIZE * MAX_ATOM_CHUNKS, "Ran out of atoms! (string: '%')", str);
+
+    String* chunk = get_chunk(id);
+    if (!chunk)
+    {
+        chunk = (String*) arena_allocate(atom_table.storage, ATOM_CHUNK_SIZE * sizeof(String), alignof(String));
+        platform_zero_memory(chunk, ATOM_CHUNK_SIZE * sizeof(String));
+        atom_table.chunks[id / ATOM_CHUNK_SIZE].store(chunk, std::memory_order_release);
+    }
+
+    String stored;
+    stored.size = str.size;
+    stored.data = (char*) arena_allocate(atom_table.storage, str.size + 1, alignof(char));
+    platform_copy_memory(stored.data, str.data, str.size);
+    stored.data[stored.size] = '\0';
+
+    chunk[id % ATOM_CHUNK_SIZE] = stored;
+    atom_table.count.store(id + 1, std::memory_order_release);
+
+    const Atom atom = Atom { id };
+    put(atom_table.lookup, stored, atom);
+
+    unlock_atom_table();
+    return atom;
+}
+
+bool atom_find(const String str, Atom& out_atom)
+{
+    lock_atom_table();
+
+    auto elem = find(atom_table.lookup, str);
+    if (elem)
+        out_atom = elem.value();
+
+    unlock_atom_table();
+    return (bool) elem;
+}
+
+String atom_get_string(const Atom atom)
+{
+    if (atom.id == 0)
+        return ref((char*) "", 0ui64);
+
+    gn_assert_with_message(atom.id < atom_table.count.load(std::memory_order_acquire), "Invalid atom! (id: %)", atom.id);
+    return get_chunk(atom.id)[atom.id % ATOM_CHUNK_SIZE];
+}
+
+u32 atom_get_count()
+{
+    // Doesn't count ATOM_NONE
+    const u32 count = atom_table.count.load(std::memory_order_acquire);
+    return (count > 0) ? count - 1 : 0;
+}
+
+template <>
+void print_to_file(FILE* file, const Atom& atom)
+{
+    print_to_file(file, atom_get_string(atom));
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/types.h"
+#include "containers/string.h"
+#include "containers/hash.h"
+
+// Interned strings. Every unique byte string maps to a stable 32 bit id so atoms
+// can be compared and hashed as integers. Interned strings are never freed, are
+// null terminated, and can be used from multiple threads.
+
+struct Atom
+{
+    u32 id;     // 0 means no atom (zero initialized)
+};
+
+constexpr Atom ATOM_NONE = { 0 };
+
+inline bool operator==(const Atom a, const Atom b)
+{
+    return a.id == b.id;
+}
+
+inline bool operator!=(const Atom a, const Atom b)
+{
+    return a.id != b.id;
+}
+
+template <>
+struct Hasher<Atom>
+{
+    inline Hash operator()(Atom const& key) const
+    {
+        return Hashing::hash_u32(key.id);
+    }
+};
+
+// Returns the existing atom if the string was interned before
+Atom atom_intern(const String str);
+
+// Doesn't intern the string, returns false if it was never interned
+bool atom_find(const String str, Atom& out_atom);
+
+// Lock free, returns an empty string for ATOM_NONE
+String atom_get_string(const Atom atom);
+
+u32 atom_get_count();
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/types.h"
+#include "core/compiler_utils.h"
+
+#if defined(GN_COMPILER_MSVC)
+#include <intrin.h>
+#endif
+
+// Compiler agnostic wrappers for bit manipulation intrinsics.
+// Counting functions expect a non-zero value unless stated otherwise.
+
+GN_FORCE_INLINE u32 count_trailing_zeros(u32 value)
+{
+#if defined(GN_COMPILER_MSVC)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return (u32) index;
+#else
+    return (u32) __builtin_ctz(value);
+#endif
+}
+
+GN_FORCE_INLINE u32 count_trailing_zeros(u64 value)
+{
+#if defined(GN_COMPILER_MSVC)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (u32) index;
+#else
+    return (u32) __builtin_ctzll(value);
+#endif
+}
+
+GN_FORCE_INLINE u32 count_leading_zeros(u32 value)
+{
+#if defined(GN_COMPILER_MSVC)
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return 31 - (u32) index;
+#else
+    return (u32) __builtin_clz(value);
+#endif
+}
+
+GN_FORCE_INLINE u32 count_leading_zeros(u64 value)
+{
+#if defined(GN_COMPILER_MSVC)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - (u32) index;
+#else
+    return (u32) __builtin_clzll(value);
+#endif
+}
+
+// Works with 0 as well
+GN_FORCE_INLINE u32 pop_count(u32 value)
+{
+#if defined(GN_COMPILER_MSVC)
+    return (u32) __popcnt(value);
+#else
+    return (u32) __builtin_popcount(value);
+#endif
+}
+
+// Works with 0 as well
+GN_FORCE_INLINE u32 pop_count(u64 value)
+{
+#if defined(GN_COMPILER_MSVC)
+    return (u32) __popcnt64(value);
+#else
+    return (u32) __builtin_popcountll(value);
+#endif
+}
+
+GN_FORCE_INLINE u32 rotate_left(u32 value, u32 shift)
+{
+#if defined(GN_COMPILER_MSVC)
+    return _rotl(value, (int) shift);
+#else
+    return (value << (shift & 31)) | (value >> ((32 - shift) & 31));
+#endif
+}
+
+GN_FORCE_INLINE u64 rotate_left(u64 value, u32 shift)
+{
+#if defined(GN_COMPILER_MSVC)
+    return _rotl64(value, (int) shift);
+#else
+    return (value << (shift & 63)) | (value >> ((64 - shift) & 63));
+#endif
+}
+
+GN_FORCE_INLINE bool is_power_of_2(u64 value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+// Returns the smallest power of 2 that is >= value (1 for 0)
+GN_FORCE_INLINE u32 next_power_of_2(u32 value)
+{
+    return (value <= 1) ? 1 : (1u << (32 - count_leading_zeros(value - 1)));
+}
+
+// Returns the smallest power of 2 that is >= value (1 for 0)
+GN_FORCE_INLINE u64 next_power_of_2(u64 value)
+{
+    return (value <= 1) ? 1 : (1ull << (64 - count_leading_zeros(value - 1)));
+}
\ No newline at end of file
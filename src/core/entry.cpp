@@ -2,6 +2,7 @@
 
 #include "core/types.h"
 #include "core/logger.h"
+#include "core/allocator.h"
 #include "application/application.h"
 #include "graphics/graphics.h"
 #include "core/input_processing.h"
@@ -73,6 +74,9 @@ int main()
     f32 prev_time = platform_get_time();
     while (app.is_running)
     {
+        arena_reset(get_frame_arena());
+        arena_reset(get_scratch_arena());
+
         app.time = platform_get_time();
         app.delta_time = min(app.time - prev_time, 0.2f);   // Max frame time is 0.2 secs
         prev_time = app.time;
@@ -98,6 +102,9 @@ int main()
     Audio::shutdown();
     Imgui::shutdown();
 
+    free(get_frame_arena());
+    free(get_scratch_arena());
+
     // Shutdown engine stuff
 
     platform_window_shutdown(pstate);
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "application/application.h"
-#include "containers/function.h"
+#include "containers/delegate.h"
 #include "math/vecs/vector2.h"
 
 enum struct MouseButton
@@ -147,8 +147,8 @@ enum struct Key
 };
 
 // Event Callback Types
-using KeyDownCallback     = Function<void(Application&, Key)>;
-using MouseScrollCallback = Function<void(Application&, s32)>;
+using KeyDownCallback     = Delegate<void(Application&, Key)>;
+using MouseScrollCallback = Delegate<void(Application&, s32)>;
 
 namespace Input
 {
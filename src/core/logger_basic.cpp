@@ -17,15 +17,13 @@ void print_to_file(FILE* file, const bool& boolean)
 template <>
 void print_to_file(FILE* file, const String& str)
 {
-    for (u64 i = 0; i < str.size; i++)
-        print_to_file(file, str.data[i]);
+    fwrite(str.data, sizeof(char), str.size, file);
 }
 
 template <>
 void print_to_file(FILE* file, const Bytes& bytes)
 {
-    for (u64 i = 0; i < bytes.size; i++)
-        print_to_file(file, (char) bytes.data[i]);
+    fwrite(bytes.data, sizeof(u8), bytes.size, file);
 }
 
 template <>
@@ -0,0 +1,1292 @@
+#include "number_conversion.h"
+
+#include <cstring>
+#include "core/types.h"
+#include "core/bit_utils.h"
+#include "core/compiler_utils.h"
+#include "core/logger.h"
+#include "containers/string.h"
+
+#include "number_conversion_tables.inl"
+
+struct U128
+{
+    u64 low;
+    u64 high;
+};
+
+static GN_FORCE_INLINE U128 multiply_full(u64 a, u64 b)
+{
+    U128 result;
+
+#if defined(GN_COMPILER_MSVC)
+    result.low = _umul128(a, b, &result.high);
+#else
+    const unsigned __int128 product = (unsigned __int128) a * b;
+    result.low  = (u64) product;
+    result.high = (u64) (product >> 64);
+#endif
+
+    return result;
+}
+
+static GN_FORCE_INLINE u64 read_u64(const char* ptr)
+{
+    u64 value;
+    memcpy(&value, ptr, sizeof(u64));
+    return value;
+}
+
+static GN_FORCE_INLINE u64 f64_to_bits(f64 value)
+{
+    u64 bits;
+    memcpy(&bits, &value, sizeof(u64));
+    return bits;
+}
+
+static GN_FORCE_INLINE f64 f64_from_bits(u64 bits)
+{
+    f64 value;
+    memcpy(&value, &bits, sizeof(u64));
+    return value;
+}
+
+static GN_FORCE_INLINE u32 f32_to_bits(f32 value)
+{
+    u32 bits;
+    memcpy(&bits, &value, sizeof(u32));
+    return bits;
+}
+
+static const u64 POWERS_OF_10[20] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull
+};
+
+static const char DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static GN_FORCE_INLINE u32 count_digits(u64 value)
+{
+    // Approximate log10 from the bit length (1233 / 4096 ~ log10(2)), then correct by one
+    const u32 guess = ((64 - count_leading_zeros(value | 1)) * 1233) >> 12;
+    return guess + (value >= POWERS_OF_10[guess]) + (value == 0);
+}
+
+// Writes the digits backwards, ending right before end
+static GN_FORCE_INLINE void write_digits_backwards(char* end, u64 value)
+{
+    while (value >= 100)
+    {
+        const u64 quotient = value / 100;
+        const u64 pair = value - quotient * 100;
+
+        end -= 2;
+        memcpy(end, DIGIT_PAIRS + pair * 2, 2);
+        value = quotient;
+    }
+
+    if (value >= 10)
+    {
+        end -= 2;
+        memcpy(end, DIGIT_PAIRS + value * 2, 2);
+    }
+    else
+    {
+        *--end = (char) ('0' + value);
+    }
+}
+
+u64 format_u64(char* buffer, u64 value)
+{
+    const u32 length = count_digits(value);
+    write_digits_backwards(buffer + length, value);
+    return length;
+}
+
+u64 format_s64(char* buffer, s64 value)
+{
+    if (value >= 0)
+        return format_u64(buffer, (u64) value);
+
+    buffer[0] = '-';
+    return 1 + format_u64(buffer + 1, 0ull - (u64) value);
+}
+
+u64 format_u64_radix(char* buffer, u64 value, u32 radix)
+{
+    gn_assert_with_message(radix >= 2 && radix <= 16, "Radix value for converting number to string is not valid! (radix: %)", radix);
+
+    if (radix == 10)
+        return format_u64(buffer, value);
+
+    constexpr char digits[] = "0123456789abcdef";
+
+    u64 length = 0;
+    for (u64 temp = value; temp; temp /= radix)
+        length++;
+
+    if (length == 0)
+        length = 1;
+
+    for (u64 i = length; i > 0; i--)
+    {
+        buffer[i - 1] = digits[value % radix];
+        value /= radix;
+    }
+
+    return length;
+}
+
+// Float formatting (Ryu by Ulf Adams)
+
+constexpr s32 DOUBLE_MANTISSA_BITS     = 52;
+constexpr s32 DOUBLE_EXPONENT_BITS     = 11;
+constexpr s32 DOUBLE_BIAS              = 1023;
+constexpr s32 DOUBLE_POW5_INV_BITCOUNT = 125;
+constexpr s32 DOUBLE_POW5_BITCOUNT     = 125;
+
+constexpr s32 FLOAT_MANTISSA_BITS     = 23;
+constexpr s32 FLOAT_EXPONENT_BITS     = 8;
+constexpr s32 FLOAT_BIAS              = 127;
+constexpr s32 FLOAT_POW5_INV_BITCOUNT = 59;
+constexpr s32 FLOAT_POW5_BITCOUNT     = 61;
+
+// Number of bits in 5^e, for 0 <= e <= 3528
+static GN_FORCE_INLINE s32 pow5_bits(s32 e)
+{
+    return (s32) (((u32) e * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2^e)), for 0 <= e <= 1650
+static GN_FORCE_INLINE u32 log10_pow2(s32 e)
+{
+    return ((u32) e * 78913) >> 18;
+}
+
+// floor(log10(5^e)), for 0 <= e <= 2620
+static GN_FORCE_INLINE u32 log10_pow5(s32 e)
+{
+    return ((u32) e * 732923) >> 20;
+}
+
+static GN_FORCE_INLINE u32 pow5_factor(u64 value)
+{
+    u32 count = 0;
+    while (value % 5 == 0)
+    {
+        value /= 5;
+        count++;
+    }
+
+    return count;
+}
+
+static GN_FORCE_INLINE bool is_multiple_of_pow5(u64 value, u32 p)
+{
+    return pow5_factor(value) >= p;
+}
+
+static GN_FORCE_INLINE bool is_multiple_of_pow2(u64 value, u32 p)
+{
+    return (value & ((1ull << p) - 1)) == 0;
+}
+
+// (m * mul) >> j, where mul is 128 bits and j >= 64
+static GN_FORCE_INLINE u64 multiply_shift_64(u64 m, const u64* mul, s32 j)
+{
+    const U128 b0 = multiply_full(m, mul[0]);
+    const U128 b2 = multiply_full(m, mul[1]);
+
+    // (b0 >> 64) + b2, then shift the 128 bit sum right by j - 64
+    const u64 low  = b2.low + b0.high;
+    const u64 high = b2.high + (low < b2.low);
+    const s32 shift = j - 64;
+
+    return (shift == 0) ? low : ((high << (64 - shift)) | (low >> shift));
+}
+
+static GN_FORCE_INLINE u32 multiply_shift_32(u32 m, u64 factor, s32 shift)
+{
+    const u64 bits0 = (u64) m * (u32) factor;
+    const u64 bits1 = (u64) m * (factor >> 32);
+    const u64 sum = (bits0 >> 32) + bits1;
+    return (u32) (sum >> (shift - 32));
+}
+
+struct DecimalFloat
+{
+    u64 digits;
+    s32 exponent;   // value = digits * 10^exponent
+};
+
+static DecimalFloat shortest_f64(u64 ieee_mantissa, u32 ieee_exponent)
+{
+    s32 e2;
+    u64 m2;
+    if (ieee_exponent == 0)
+    {
+        e2 = 1 - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    }
+    else
+    {
+        e2 = (s32) ieee_exponent - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = (1ull << DOUBLE_MANTISSA_BITS) | ieee_mantissa;
+    }
+
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    // Interval of values that round to this float is [mm, mp] (scaled by 4)
+    const u64 mv = 4 * m2;
+    const u32 mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    u64 vr, vp, vm;
+    s32 e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+
+    if (e2 >= 0)
+    {
+        const u32 q = log10_pow2(e2) - (e2 > 3);
+        e10 = (s32) q;
+        const s32 k = DOUBLE_POW5_INV_BITCOUNT + pow5_bits((s32) q) - 1;
+        const s32 i = -e2 + (s32) q + k;
+
+        vr = multiply_shift_64(4 * m2,                DOUBLE_POW5_INV_SPLIT[q], i);
+        vp = multiply_shift_64(4 * m2 + 2,            DOUBLE_POW5_INV_SPLIT[q], i);
+        vm = multiply_shift_64(4 * m2 - 1 - mm_shift, DOUBLE_POW5_INV_SPLIT[q], i);
+
+        // Only the smaller values can be exact multiples of 5^q
+        if (q <= 21)
+        {
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = is_multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = is_multiple_of_pow5(mv - 1 - mm_shift, q);
+            else
+                vp -= is_multiple_of_pow5(mv + 2, q);
+        }
+    }
+    else
+    {
+        const u32 q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = (s32) q + e2;
+        const s32 i = -e2 - (s32) q;
+        const s32 k = pow5_bits(i) - DOUBLE_POW5_BITCOUNT;
+        const s32 j = (s32) q - k;
+
+        vr = multiply_shift_64(4 * m2,                DOUBLE_POW5_SPLIT[i], j);
+        vp = multiply_shift_64(4 * m2 + 2,            DOUBLE_POW5_SPLIT[i], j);
+        vm = multiply_shift_64(4 * m2 - 1 - mm_shift, DOUBLE_POW5_SPLIT[i], j);
+
+        if (q <= 1)
+        {
+            // mv has at least q trailing zero bits when q <= 1
+            vr_is_trailing_zeros = true;
+            if (accept_bounds)
+                vm_is_trailing_zeros = mm_shift == 1;
+            else
+                vp--;
+        }
+        else if (q < 63)
+        {
+            vr_is_trailing_zeros = is_multiple_of_pow2(mv, q);
+        }
+    }
+
+    // Remove digits while the interval still contains a shorter number
+    s32 removed = 0;
+    u8 last_removed_digit = 0;
+    u64 output;
+
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros)
+    {
+        // Rare, exact ties need to be tracked
+        while (vp / 10 > vm / 10)
+        {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = (u8) (vr % 10);
+
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        if (vm_is_trailing_zeros)
+        {
+            while (vm % 10 == 0)
+            {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = (u8) (vr % 10);
+
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+
+        // Round half to even
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4;
+
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    }
+    else
+    {
+        bool round_up = false;
+
+        // Most numbers lose a lot of digits, try removing two at a time first
+        if (vp / 100 > vm / 100)
+        {
+            round_up = vr % 100 >= 50;
+
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+
+        while (vp / 10 > vm / 10)
+        {
+            round_up = vr % 10 >= 5;
+
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        output = vr + (vr == vm || round_up);
+    }
+
+    return DecimalFloat { output, e10 + removed };
+}
+
+static DecimalFloat shortest_f32(u32 ieee_mantissa, u32 ieee_exponent)
+{
+    s32 e2;
+    u32 m2;
+    if (ieee_exponent == 0)
+    {
+        e2 = 1 - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    }
+    else
+    {
+        e2 = (s32) ieee_exponent - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+        m2 = (1u << FLOAT_MANTISSA_BITS) | ieee_mantissa;
+    }
+
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    const u32 mv = 4 * m2;
+    const u32 mp = 4 * m2 + 2;
+    const u32 mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    const u32 mm = 4 * m2 - 1 - mm_shift;
+
+    u32 vr, vp, vm;
+    s32 e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    u8 last_removed_digit = 0;
+
+    if (e2 >= 0)
+    {
+        const u32 q = log10_pow2(e2);
+        e10 = (s32) q;
+        const s32 k = FLOAT_POW5_INV_BITCOUNT + pow5_bits((s32) q) - 1;
+        const s32 i = -e2 + (s32) q + k;
+
+        vr = multiply_shift_32(mv, FLOAT_POW5_INV_SPLIT[q], i);
+        vp = multiply_shift_32(mp, FLOAT_POW5_INV_SPLIT[q], i);
+        vm = multiply_shift_32(mm, FLOAT_POW5_INV_SPLIT[q], i);
+
+        if (q != 0 && (vp - 1) / 10 <= vm / 10)
+        {
+            // Only one digit will be removed, so the digit below vr has to be computed separately
+            const s32 l = FLOAT_POW5_INV_BITCOUNT + pow5_bits((s32) q - 1) - 1;
+            last_removed_digit = (u8) (multiply_shift_32(mv, FLOAT_POW5_INV_SPLIT[q - 1], -e2 + (s32) q - 1 + l) % 10);
+        }
+
+        if (q <= 9)
+        {
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = is_multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = is_multiple_of_pow5(mm, q);
+            else
+                vp -= is_multiple_of_pow5(mp, q);
+        }
+    }
+    else
+    {
+        const u32 q = log10_pow5(-e2);
+        e10 = (s32) q + e2;
+        const s32 i = -e2 - (s32) q;
+        const s32 k = pow5_bits(i) - FLOAT_POW5_BITCOUNT;
+        s32 j = (s32) q - k;
+
+        vr = multiply_shift_32(mv, FLOAT_POW5_SPLIT[i], j);
+        vp = multiply_shift_32(mp, FLOAT_POW5_SPLIT[i], j);
+        vm = multiply_shift_32(mm, FLOAT_POW5_SPLIT[i], j);
+
+        if (q != 0 && (vp - 1) / 10 <= vm / 10)
+        {
+            j = (s32) q - 1 - (pow5_bits(i + 1) - FLOAT_POW5_BITCOUNT);
+            last_removed_digit = (u8) (multiply_shift_32(mv, FLOAT_POW5_SPLIT[i + 1], j) % 10);
+        }
+
+        if (q <= 1)
+        {
+            vr_is_trailing_zeros = true;
+            if (accept_bounds)
+                vm_is_trailing_zeros = mm_shift == 1;
+            else
+                vp--;
+        }
+        else if (q < 31)
+        {
+            vr_is_trailing_zeros = is_multiple_of_pow2(mv, q - 1);
+        }
+    }
+
+    s32 removed = 0;
+    u32 output;
+
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros)
+    {
+        while (vp / 10 > vm / 10)
+        {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = (u8) (vr % 10);
+
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        if (vm_is_trailing_zeros)
+        {
+            while (vm % 10 == 0)
+            {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = (u8) (vr % 10);
+
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4;
+
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    }
+    else
+    {
+        while (vp / 10 > vm / 10)
+        {
+            last_removed_digit = (u8) (vr % 10);
+
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        output = vr + (vr == vm || last_removed_digit >= 5);
+    }
+
+    return DecimalFloat { output, e10 + removed };
+}
+
+static u64 write_special(char* buffer, bool negative, const char* text)
+{
+    u64 length = 0;
+    if (negative)
+        buffer[length++] = '-';
+
+    const u64 text_length = strlen(text);
+    memcpy(buffer + length, text, text_length);
+
+    return length + text_length;
+}
+
+// Same layout as JavaScript: plain notation when the decimal point is close
+// to the digits, exponent notation otherwise
+static u64 write_decimal(char* buffer, bool negative, DecimalFloat decimal)
+{
+    char digits[MAX_INTEGER_CHARS];
+    const s32 digit_count = (s32) format_u64(digits, decimal.digits);
+    const s32 point = digit_count + decimal.exponent;
+
+    char* ptr = buffer;
+    if (negative)
+        *ptr++ = '-';
+
+    if (point > 21 || point < -5)
+    {
+        *ptr++ = digits[0];
+        if (digit_count > 1)
+        {
+            *ptr++ = '.';
+            memcpy(ptr, digits + 1, digit_count - 1);
+            ptr += digit_count - 1;
+        }
+
+        *ptr++ = 'e';
+        ptr += format_s64(ptr, (s64) point - 1);
+    }
+    else if (point <= 0)
+    {
+        *ptr++ = '0';
+        *ptr++ = '.';
+        memset(ptr, '0', -point);
+        ptr += -point;
+
+        memcpy(ptr, digits, digit_count);
+        ptr += digit_count;
+    }
+    else if (point >= digit_count)
+    {
+        memcpy(ptr, digits, digit_count);
+        ptr += digit_count;
+
+        memset(ptr, '0', point - digit_count);
+        ptr += point - digit_count;
+
+        *ptr++ = '.';
+        *ptr++ = '0';
+    }
+    else
+    {
+        memcpy(ptr, digits, point);
+        ptr += point;
+
+        *ptr++ = '.';
+
+        memcpy(ptr, digits + point, digit_count - point);
+        ptr += digit_count - point;
+    }
+
+    return (u64) (ptr - buffer);
+}
+
+u64 format_f64(char* buffer, f64 value)
+{
+    const u64 bits = f64_to_bits(value);
+    const bool negative = (bits >> 63) != 0;
+    const u64 ieee_mantissa = bits & ((1ull << DOUBLE_MANTISSA_BITS) - 1);
+    const u32 ieee_exponent = (u32) ((bits >> DOUBLE_MANTISSA_BITS) & ((1u << DOUBLE_EXPONENT_BITS) - 1));
+
+    if (ieee_exponent == (1u << DOUBLE_EXPONENT_BITS) - 1)
+        return (ieee_mantissa) ? write_special(buffer, false, "nan") : write_special(buffer, negative, "inf");
+
+    if (ieee_exponent == 0 && ieee_mantissa == 0)
+        return write_special(buffer, negative, "0.0");
+
+    return write_decimal(buffer, negative, shortest_f64(ieee_mantissa, ieee_exponent));
+}
+
+u64 format_f32(char* buffer, f32 value)
+{
+    const u32 bits = f32_to_bits(value);
+    const bool negative = (bits >> 31) != 0;
+    const u32 ieee_mantissa = bits & ((1u << FLOAT_MANTISSA_BITS) - 1);
+    const u32 ieee_exponent = (bits >> FLOAT_MANTISSA_BITS) & ((1u << FLOAT_EXPONENT_BITS) - 1);
+
+    if (ieee_exponent == (1u << FLOAT_EXPONENT_BITS) - 1)
+        return (ieee_mantissa) ? write_special(buffer, false, "nan") : write_special(buffer, negative, "inf");
+
+    if (ieee_exponent == 0 && ieee_mantissa == 0)
+        return write_special(buffer, negative, "0.0");
+
+    return write_decimal(buffer, negative, shortest_f32(ieee_mantissa, ieee_exponent));
+}
+
+// Integer parsing
+
+// Checks 8 ASCII characters for digits at once
+static GN_FORCE_INLINE bool is_eight_digits(u64 chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+// Converts 8 ASCII digits (first digit in the lowest byte) with 3 multiplies
+static GN_FORCE_INLINE u32 parse_eight_digits(u64 chunk)
+{
+    constexpr u64 mask = 0x000000FF000000FFull;
+    constexpr u64 mul1 = 0x000F424000000064ull;    // 100 + (1000000 << 32)
+    constexpr u64 mul2 = 0x0000271000000001ull;    // 1 + (10000 << 32)
+
+    chunk -= 0x3030303030303030ull;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+
+    return (u32) chunk;
+}
+
+static GN_FORCE_INLINE bool is_digit_char(char c)
+{
+    return (u8) (c - '0') < 10;
+}
+
+// Parses digits till the first non digit, wraps around on overflow
+static GN_FORCE_INLINE const char* parse_digits(const char* ptr, const char* end, u64& value)
+{
+    while (end - ptr >= 8)
+    {
+        const u64 chunk = read_u64(ptr);
+        if (!is_eight_digits(chunk))
+            break;
+
+        value = value * 100000000ull + parse_eight_digits(chunk);
+        ptr += 8;
+    }
+
+    while (ptr < end && is_digit_char(*ptr))
+    {
+        value = value * 10 + (u64) (*ptr - '0');
+        ptr++;
+    }
+
+    return ptr;
+}
+
+static bool parse_magnitude(const char* ptr, const char* end, u64& out_value)
+{
+    if (ptr == end)
+        return false;
+
+    // Leading zeros don't count towards the 20 digit limit
+    const char* start = ptr;
+    while (ptr < end && *ptr == '0')
+        ptr++;
+
+    const char* significant = ptr;
+
+    u64 value = 0;
+    ptr = parse_digits(ptr, end, value);
+
+    if (ptr != end)
+        return false;
+
+    const u64 digit_count = (u64) (ptr - significant);
+    if (digit_count > 20)
+        return false;
+
+    if (digit_count == 20)
+    {
+        // Wrapped around if the value is smaller than the smallest 20 digit number
+        if (value < POWERS_OF_10[19])
+            return false;
+    }
+
+    out_value = value;
+    return ptr > start;
+}
+
+bool parse_u64(const String str, u64& out_value)
+{
+    const char* ptr = str.data;
+    const char* end = str.data + str.size;
+
+    if (ptr < end && *ptr == '+')
+        ptr++;
+
+    return parse_magnitude(ptr, end, out_value);
+}
+
+bool parse_s64(const String str, s64& out_value)
+{
+    const char* ptr = str.data;
+    const char* end = str.data + str.size;
+
+    bool negative = false;
+    if (ptr < end && (*ptr == '-' || *ptr == '+'))
+    {
+        negative = *ptr == '-';
+        ptr++;
+    }
+
+    u64 magnitude;
+    if (!parse_magnitude(ptr, end, magnitude))
+        return false;
+
+    const u64 limit = 0x7FFFFFFFFFFFFFFFull + negative;
+    if (magnitude > limit)
+        return false;
+
+    out_value = negative ? (s64) (0ull - magnitude) : (s64) magnitude;
+    return true;
+}
+
+// Float parsing
+
+struct ParsedNumber
+{
+    u64 mantissa;       // First 19 significant digits
+    s64 exponent;       // value = mantissa * 10^exponent (if not truncated)
+    bool negative;
+    bool truncated;     // There were more than 19 significant digits
+
+    const char* integer_start;
+    const char* integer_end;
+    const char* fraction_start;
+    const char* fraction_end;
+    s64 explicit_exponent;
+};
+
+static bool parse_number_string(const char* ptr, const char* end, ParsedNumber& number)
+{
+    number = {};
+
+    if (ptr < end && (*ptr == '-' || *ptr == '+'))
+    {
+        number.negative = *ptr == '-';
+        ptr++;
+    }
+
+    u64 mantissa = 0;
+
+    number.integer_start = ptr;
+    ptr = parse_digits(ptr, end, mantissa);
+    number.integer_end = ptr;
+
+    s64 digit_count = ptr - number.integer_start;
+    s64 exponent = 0;
+
+    number.fraction_start = number.fraction_end = ptr;
+    if (ptr < end && *ptr == '.')
+    {
+        ptr++;
+
+        number.fraction_start = ptr;
+        ptr = parse_digits(ptr, end, mantissa);
+        number.fraction_end = ptr;
+
+        exponent = number.fraction_start - ptr;
+        digit_count -= exponent;
+    }
+
+    if (digit_count == 0)
+        return false;
+
+    if (ptr < end && (*ptr == 'e' || *ptr == 'E'))
+    {
+        ptr++;
+
+        bool negative_exponent = false;
+        if (ptr < end && (*ptr == '-' || *ptr == '+'))
+        {
+            negative_exponent = *ptr == '-';
+            ptr++;
+        }
+
+        if (ptr == end || !is_digit_char(*ptr))
+            return false;
+
+        s64 explicit_exponent = 0;
+        while (ptr < end && is_digit_char(*ptr))
+        {
+            // Anything this big is already 0 or infinity
+            if (explicit_exponent < 0x10000)
+                explicit_exponent = explicit_exponent * 10 + (*ptr - '0');
+
+            ptr++;
+        }
+
+        number.explicit_exponent = negative_exponent ? -explicit_exponent : explicit_exponent;
+        exponent += number.explicit_exponent;
+    }
+
+    if (ptr != end)
+        return false;
+
+    if (digit_count > 19)
+    {
+        // Leading zeros aren't significant
+        const char* start = number.integer_start;
+        while (start < end && (*start == '0' || *start == '.'))
+        {
+            if (*start == '0')
+                digit_count--;
+
+            start++;
+        }
+
+        if (digit_count > 19)
+        {
+            number.truncated = true;
+
+            // Keep the first 19 significant digits
+            constexpr u64 MIN_NINETEEN_DIGIT_INTEGER = 1000000000000000000ull;
+
+            mantissa = 0;
+            const char* digit = number.integer_start;
+            while (mantissa < MIN_NINETEEN_DIGIT_INTEGER && digit != number.integer_end)
+                mantissa = mantissa * 10 + (u64) (*digit++ - '0');
+
+            if (mantissa >= MIN_NINETEEN_DIGIT_INTEGER)
+            {
+                exponent = (number.integer_end - digit) + number.explicit_exponent;
+            }
+            else
+            {
+                digit = number.fraction_start;
+                while (mantissa < MIN_NINETEEN_DIGIT_INTEGER && digit != number.fraction_end)
+                    mantissa = mantissa * 10 + (u64) (*digit++ - '0');
+
+                exponent = (number.fraction_start - digit) + number.explicit_exponent;
+            }
+        }
+    }
+
+    number.mantissa = mantissa;
+    number.exponent = exponent;
+    return true;
+}
+
+// Eisel-Lemire, computes the binary exponent and 53 bit mantissa for w * 10^q.
+// The 128 bit product is always precise enough when w is exact (Mushtak and Lemire, 2023).
+
+constexpr s64 SMALLEST_POWER_OF_TEN = -342;
+constexpr s64 LARGEST_POWER_OF_TEN  = 308;
+
+struct BinaryFloat
+{
+    u64 mantissa;
+    s32 power2;     // Biased exponent
+};
+
+static BinaryFloat compute_float(s64 q, u64 w)
+{
+    constexpr s32 INFINITE_POWER   = 0x7FF;
+    constexpr s32 MINIMUM_EXPONENT = -1023;
+
+    if (w == 0 || q < SMALLEST_POWER_OF_TEN)
+        return BinaryFloat { 0, 0 };
+
+    if (q > LARGEST_POWER_OF_TEN)
+        return BinaryFloat { 0, INFINITE_POWER };
+
+    const u32 leading_zeros = count_leading_zeros(w);
+    w <<= leading_zeros;
+
+    // Only the upper 55 bits are needed, the second half of the power is only used when the lower bits are all ones
+    const u64 index = 2 * (u64) (q - SMALLEST_POWER_OF_TEN);
+    U128 product = multiply_full(w, POWERS_OF_FIVE_128[index]);
+
+    constexpr u64 precision_mask = 0xFFFFFFFFFFFFFFFFull >> (DOUBLE_MANTISSA_BITS + 3);
+    if ((product.high & precision_mask) == precision_mask)
+    {
+        const U128 second = multiply_full(w, POWERS_OF_FIVE_128[index + 1]);
+        product.low += second.high;
+        if (second.high > product.low)
+            product.high++;
+    }
+
+    const u32 upper_bit = (u32) (product.high >> 63);
+    const u32 shift = upper_bit + 64 - DOUBLE_MANTISSA_BITS - 3;
+
+    BinaryFloat answer;
+    answer.mantissa = product.high >> shift;
+
+    // floor(log2(10^q)) + 63 from the power table normalization
+    const s32 power = (s32) ((((152170 + 65536) * q) >> 16) + 63);
+    answer.power2 = power + (s32) upper_bit - (s32) leading_zeros - MINIMUM_EXPONENT;
+
+    if (answer.power2 <= 0)
+    {
+        // Subnormal
+        if (-answer.power2 + 1 >= 64)
+            return BinaryFloat { 0, 0 };
+
+        answer.mantissa >>= -answer.power2 + 1;
+        answer.mantissa += (answer.mantissa & 1);
+        answer.mantissa >>= 1;
+
+        // Rounding up can turn a subnormal into the smallest normal number
+        answer.power2 = (answer.mantissa < (1ull << DOUBLE_MANTISSA_BITS)) ? 0 : 1;
+        return answer;
+    }
+
+    // Exactly halfway between two floats, which can only happen for small powers of 10
+    if (product.low <= 1 && q >= -4 && q <= 23 && (answer.mantissa & 3) == 1)
+    {
+        if ((answer.mantissa << shift) == product.high)
+            answer.mantissa &= ~1ull;
+    }
+
+    answer.mantissa += (answer.mantissa & 1);
+    answer.mantissa >>= 1;
+
+    if (answer.mantissa >= (2ull << DOUBLE_MANTISSA_BITS))
+    {
+        answer.mantissa = 1ull << DOUBLE_MANTISSA_BITS;
+        answer.power2++;
+    }
+
+    answer.mantissa &= ~(1ull << DOUBLE_MANTISSA_BITS);
+
+    if (answer.power2 >= INFINITE_POWER)
+        return BinaryFloat { 0, INFINITE_POWER };
+
+    return answer;
+}
+
+// Slow path, arbitrary precision decimal that gets shifted by powers of 2 until it's
+// in the range of the mantissa (same approach as Go's strconv). Only used when there are
+// more than 19 significant digits and the fast path can't tell which way to round.
+
+constexpr s32 DECIMAL_MAX_DIGITS = 800;
+constexpr s32 DECIMAL_MAX_SHIFT  = 60;
+
+struct Decimal
+{
+    u8 digits[DECIMAL_MAX_DIGITS];  // Values, not characters
+    s32 count;
+    s32 decimal_point;              // Position of the point relative to the first digit
+    bool truncated;                 // Non zero digits were dropped
+};
+
+static void decimal_push_digit(Decimal& decimal, char c)
+{
+    if (decimal.count < DECIMAL_MAX_DIGITS)
+        decimal.digits[decimal.count++] = (u8) (c - '0');
+    else if (c != '0')
+        decimal.truncated = true;
+}
+
+static void decimal_trim(Decimal& decimal)
+{
+    while (decimal.count > 0 && decimal.digits[decimal.count - 1] == 0)
+        decimal.count--;
+
+    if (decimal.count == 0)
+        decimal.decimal_point = 0;
+}
+
+static void decimal_from_number(Decimal& decimal, const ParsedNumber& number)
+{
+    decimal.count = 0;
+    decimal.decimal_point = 0;
+    decimal.truncated = false;
+
+    bool seen_non_zero = false;
+    for (const char* c = number.integer_start; c != number.integer_end; c++)
+    {
+        if (!seen_non_zero && *c == '0')
+            continue;
+
+        seen_non_zero = true;
+        decimal_push_digit(decimal, *c);
+        decimal.decimal_point++;
+    }
+
+    for (const char* c = number.fraction_start; c != number.fraction_end; c++)
+    {
+        if (!seen_non_zero && *c == '0')
+        {
+            decimal.decimal_point--;
+            continue;
+        }
+
+        seen_non_zero = true;
+        decimal_push_digit(decimal, *c);
+    }
+
+    decimal.decimal_point += (s32) number.explicit_exponent;
+    decimal_trim(decimal);
+}
+
+static void decimal_shift_left(Decimal& decimal, s32 shift)
+{
+    // Multiply from the last digit, the result comes out backwards
+    u8 result[DECIMAL_MAX_DIGITS + 20];
+    s32 result_count = 0;
+
+    u64 carry = 0;
+    for (s32 i = decimal.count - 1; i >= 0; i--)
+    {
+        const u64 value = ((u64) decimal.digits[i] << shift) + carry;
+        result[result_count++] = (u8) (value % 10);
+        carry = value / 10;
+    }
+
+    while (carry)
+    {
+        result[result_count++] = (u8) (carry % 10);
+        carry /= 10;
+    }
+
+    decimal.decimal_point += result_count - decimal.count;
+
+    // Drop the lowest digits if it doesn't fit
+    s32 first_kept = 0;
+    if (result_count > DECIMAL_MAX_DIGITS)
+    {
+        first_kept = result_count - DECIMAL_MAX_DIGITS;
+        for (s32 i = 0; i < first_kept; i++)
+        {
+            if (result[i] != 0)
+                decimal.truncated = true;
+        }
+    }
+
+    decimal.count = result_count - first_kept;
+    for (s32 i = 0; i < decimal.count; i++)
+        decimal.digits[i] = result[result_count - 1 - i];
+
+    decimal_trim(decimal);
+}
+
+static void decimal_shift_right(Decimal& decimal, s32 shift)
+{
+    s32 read = 0;
+    s32 write = 0;
+    u64 n = 0;
+
+    // Pick up enough leading digits to cover the first shift
+    for (; (n >> shift) == 0; read++)
+    {
+        if (read >= decimal.count)
+        {
+            if (n == 0)
+            {
+                decimal.count = 0;
+                return;
+            }
+
+            while ((n >> shift) == 0)
+            {
+                n *= 10;
+                read++;
+            }
+
+            break;
+        }
+
+        n = n * 10 + decimal.digits[read];
+    }
+
+    decimal.decimal_point -= read - 1;
+
+    const u64 mask = (1ull << shift) - 1;
+
+    // Pick up a digit, put down a digit
+    for (; read < decimal.count; read++)
+    {
+        const u64 digit = n >> shift;
+        n &= mask;
+        decimal.digits[write++] = (u8) digit;
+        n = n * 10 + decimal.digits[read];
+    }
+
+    // Put down the remaining digits
+    while (n > 0)
+    {
+        const u64 digit = n >> shift;
+        n &= mask;
+
+        if (write < DECIMAL_MAX_DIGITS)
+            decimal.digits[write++] = (u8) digit;
+        else if (digit > 0)
+            decimal.truncated = true;
+
+        n *= 10;
+    }
+
+    decimal.count = write;
+    decimal_trim(decimal);
+}
+
+// Positive shifts multiply, negative shifts divide
+static void decimal_shift(Decimal& decimal, s32 shift)
+{
+    if (decimal.count == 0)
+        return;
+
+    while (shift > DECIMAL_MAX_SHIFT)
+    {
+        decimal_shift_left(decimal, DECIMAL_MAX_SHIFT);
+        shift -= DECIMAL_MAX_SHIFT;
+    }
+
+    while (shift < -DECIMAL_MAX_SHIFT)
+    {
+        decimal_shift_right(decimal, DECIMAL_MAX_SHIFT);
+        shift += DECIMAL_MAX_SHIFT;
+    }
+
+    if (shift > 0)
+        decimal_shift_left(decimal, shift);
+    else if (shift < 0)
+        decimal_shift_right(decimal, -shift);
+}
+
+static bool decimal_should_round_up(const Decimal& decimal, s32 index)
+{
+    if (index < 0 || index >= decimal.count)
+        return false;
+
+    if (decimal.digits[index] == 5 && index + 1 == decimal.count)
+    {
+        // Exactly halfway unless digits were dropped, round to even
+        if (decimal.truncated)
+            return true;
+
+        return index > 0 && (decimal.digits[index - 1] % 2) == 1;
+    }
+
+    return decimal.digits[index] >= 5;
+}
+
+static u64 decimal_rounded_integer(const Decimal& decimal)
+{
+    if (decimal.decimal_point > 20)
+        return _UI64_MAX;
+
+    u64 n = 0;
+    s32 i = 0;
+    for (; i < decimal.decimal_point && i < decimal.count; i++)
+        n = n * 10 + decimal.digits[i];
+
+    for (; i < decimal.decimal_point; i++)
+        n *= 10;
+
+    if (decimal_should_round_up(decimal, decimal.decimal_point))
+        n++;
+
+    return n;
+}
+
+static BinaryFloat decimal_to_binary(Decimal& decimal)
+{
+    constexpr s32 INFINITE_POWER = 0x7FF;
+    constexpr s32 BIAS = -DOUBLE_BIAS;
+
+    // Bits needed to shift by 10^n
+    static const s32 powers[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    constexpr s32 powers_count = sizeof(powers) / sizeof(powers[0]);
+
+    if (decimal.count == 0 || decimal.decimal_point < -330)
+        return BinaryFloat { 0, 0 };
+
+    if (decimal.decimal_point > 310)
+        return BinaryFloat { 0, INFINITE_POWER };
+
+    // Scale by powers of 2 until the value is in [0.5, 1)
+    s32 exponent = 0;
+    while (decimal.decimal_point > 0)
+    {
+        const s32 n = (decimal.decimal_point >= powers_count) ? 27 : powers[decimal.decimal_point];
+        decimal_shift(decimal, -n);
+        exponent += n;
+    }
+
+    while (decimal.decimal_point < 0 || (decimal.decimal_point == 0 && decimal.digits[0] < 5))
+    {
+        const s32 n = (-decimal.decimal_point >= powers_count) ? 27 : powers[-decimal.decimal_point];
+        decimal_shift(decimal, n);
+        exponent -= n;
+    }
+
+    // Floats are in [1, 2)
+    exponent--;
+
+    // Smallest exponent is for subnormals
+    if (exponent < BIAS + 1)
+    {
+        const s32 n = BIAS + 1 - exponent;
+        decimal_shift(decimal, -n);
+        exponent += n;
+    }
+
+    if (exponent - BIAS >= INFINITE_POWER)
+        return BinaryFloat { 0, INFINITE_POWER };
+
+    decimal_shift(decimal, DOUBLE_MANTISSA_BITS + 1);
+    u64 mantissa = decimal_rounded_integer(decimal);
+
+    // Rounding added a bit
+    if (mantissa == (2ull << DOUBLE_MANTISSA_BITS))
+    {
+        mantissa >>= 1;
+        exponent++;
+
+        if (exponent - BIAS >= INFINITE_POWER)
+            return BinaryFloat { 0, INFINITE_POWER };
+    }
+
+    // Subnormal
+    if ((mantissa & (1ull << DOUBLE_MANTISSA_BITS)) == 0)
+        exponent = BIAS;
+
+    return BinaryFloat { mantissa & ((1ull << DOUBLE_MANTISSA_BITS) - 1), exponent - BIAS };
+}
+
+bool parse_f64(const String str, f64& out_value)
+{
+    ParsedNumber number;
+    if (!parse_number_string(str.data, str.data + str.size, number))
+        return false;
+
+    // Clinger's fast path, both the mantissa and the power of 10 are exact doubles
+    if (!number.truncated && number.exponent >= -22 && number.exponent <= 22 && number.mantissa <= (1ull << 53))
+    {
+        static const f64 exact_powers[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        f64 value = (f64) number.mantissa;
+        if (number.exponent < 0)
+            value /= exact_powers[-number.exponent];
+        else
+            value *= exact_powers[number.exponent];
+
+        out_value = number.negative ? -value : value;
+        return true;
+    }
+
+    BinaryFloat binary = compute_float(number.exponent, number.mantissa);
+
+    if (number.truncated)
+    {
+        // The real mantissa is somewhere between mantissa and mantissa + 1
+        const BinaryFloat upper = compute_float(number.exponent, number.mantissa + 1);
+        if (upper.mantissa != binary.mantissa || upper.power2 != binary.power2)
+        {
+            Decimal decimal;
+            decimal_from_number(decimal, number);
+            binary = decimal_to_binary(decimal);
+        }
+    }
+
+    if (binary.power2 == 0x7FF)
+        return false;
+
+    const u64 bits = binary.mantissa | ((u64) binary.power2 << DOUBLE_MANTISSA_BITS) | ((u64) number.negative << 63);
+    out_value = f64_from_bits(bits);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/types.h"
+
+struct String;
+
+// Number <-> text conversion that doesn't depend on the C runtime or the locale.
+// Floats are written with the fewest digits that read back to the exact same value
+// (Ryu) and read with correct rounding (Clinger and Eisel-Lemire fast paths, with an
+// arbitrary precision fallback). Nothing needs to be null terminated.
+
+// Formatting functions write into the buffer and return the number of characters
+// written, the buffer has to be at least this big
+constexpr u64 MAX_INTEGER_CHARS = 20;   // -9223372036854775808 and 18446744073709551615
+constexpr u64 MAX_FLOAT_CHARS   = 32;
+
+u64 format_u64(char* buffer, u64 value);
+u64 format_s64(char* buffer, s64 value);
+
+// Radix between 2 and 16, digits after 9 are lowercase letters (MAX_INTEGER_CHARS isn't enough below base 10)
+u64 format_u64_radix(char* buffer, u64 value, u32 radix);
+
+// Shortest representation that round trips. Integral values keep a ".0" so they
+// read back as floats, very large and very small values use an exponent (1.5e-7).
+u64 format_f64(char* buffer, f64 value);
+u64 format_f32(char* buffer, f32 value);
+
+// The whole string has to be a number, returns false if it isn't or if it doesn't fit.
+// Integers are an optional sign followed by decimal digits.
+bool parse_u64(const String str, u64& out_value);
+bool parse_s64(const String str, s64& out_value);
+
+// Optional sign, digits with an optional '.' (either side can be empty, not both)
+// and an optional exponent. Values too large for a double are reported as errors,
+// values too small round to 0.
+bool parse_f64(const String str, f64& out_value);
\ No newline at end of file
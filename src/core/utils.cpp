@@ -1,198 +1,52 @@
 #include "utils.h"
 
-#include <cstdlib>
-#include <cstring>
 #include "core/logger.h"
 #include "core/types.h"
+#include "core/number_conversion.h"
 #include "containers/string.h"
 
 void to_string(String& str, s32 integer, u32 radix)
 {
-    gn_assert_with_message(str.data, "Destination string for integer to string conversion points to null!");
-    gn_assert_with_message(radix >= 2 && radix <= 16, "Radix value for converting number to string is not valid! (radix: %)", radix);
-
-    constexpr char digits[] = "0123456789abcdef";
-
-    if (integer == 0)
-    {
-        str.data[0] = '0';
-        str.size = 1;
-        return;
-    }
-
-    s32 num = abs(integer);
-    u64 num_digits = (log(num) / log(radix)) + 1;
-
-    u64 i = 0;
-    while (num)
-    {
-        s32 index = num % radix;
-        str.data[i++] = digits[index];
-        num /= radix;
-    }
-
-    if (integer < 0)
-        str.data[i++] = '-';
-    
-    str.size = i;
-    reverse(str);
+    to_string(str, (s64) integer, radix);
 }
 
 void to_string(String& str, s64 integer, u32 radix)
 {
     gn_assert_with_message(str.data, "Destination string for integer to string conversion points to null!");
-    gn_assert_with_message(radix >= 2 && radix <= 16, "Radix value for converting number to string is not valid! (radix: %)", radix);
 
-    constexpr char digits[] = "0123456789abcdef";
-
-    if (integer == 0)
+    if (radix == 10)
     {
-        str.data[0] = '0';
-        str.size = 1;
+        str.size = format_s64(str.data, integer);
         return;
     }
 
-    s64 num = abs(integer);
-    u64 num_digits = (log(num) / log(radix)) + 1;
-
-    u64 i = 0;
-    while (num)
-    {
-        s64 index = num % radix;
-        str.data[i++] = digits[index];
-        num /= radix;
-    }
-
+    u64 offset = 0;
     if (integer < 0)
-        str.data[i++] = '-';
-    
-    str.size = i;
-    reverse(str);
+        str.data[offset++] = '-';
+
+    const u64 magnitude = (integer < 0) ? 0ull - (u64) integer : (u64) integer;
+    str.size = offset + format_u64_radix(str.data + offset, magnitude, radix);
 }
 
 void to_string(String& str, u32 integer, u32 radix)
 {
-    gn_assert_with_message(str.data, "Destination string for integer to string conversion points to null!");
-    gn_assert_with_message(radix >= 2 && radix <= 16, "Radix value for converting number to string is not valid! (radix: %)", radix);
-
-    constexpr char digits[] = "0123456789abcdef";
-
-    if (integer == 0)
-    {
-        str.data[0] = '0';
-        str.size = 1;
-        return;
-    }
-
-    u32 num = integer;
-    u64 num_digits = (log(num) / log(radix)) + 1;
-
-    u64 i = 0;
-    while (num)
-    {
-        u32 index = num % radix;
-        str.data[i++] = digits[index];
-        num /= radix;
-    }
-
-    str.size = i;
-    reverse(str);
+    to_string(str, (u64) integer, radix);
 }
 
 void to_string(String& str, u64 integer, u32 radix)
 {
     gn_assert_with_message(str.data, "Destination string for integer to string conversion points to null!");
-    gn_assert_with_message(radix >= 2 && radix <= 16, "Radix value for converting number to string is not valid! (radix: %)", radix);
-
-    constexpr char digits[] = "0123456789abcdef";
-
-    if (integer == 0)
-    {
-        str.data[0] = '0';
-        str.size = 1;
-        return;
-    }
-
-    u64 num = integer;
-    u64 num_digits = (log(num) / log(radix)) + 1;
-
-    u64 i = 0;
-    while (num)
-    {
-        u64 index = num % radix;
-        str.data[i++] = digits[index];
-        num /= radix;
-    }
-
-    str.size = i;
-    reverse(str);
+    str.size = format_u64_radix(str.data, integer, radix);
 }
 
-void to_string(String& str, f32 number, u32 after_decimal)
+void to_string(String& str, f32 number)
 {
     gn_assert_with_message(str.data, "Destination string for float to string conversion points to null!");
-
-    u64 old_size = str.size;
-
-    s32 integer = (s32) number;
-    f32 fractional = number - (f32) integer;
-
-    to_string(str, integer);
-
-    if (after_decimal > 0)
-    {
-        str.data[str.size] = '.';
-
-        String fraction_string = { str.data + str.size + 1, 0 };
-
-        constexpr char digits[] = "0123456789abcdef";
-        while (after_decimal)
-        {
-            fractional *= 10;
-            s32 index = ((s32) fractional) % 10;
-            fraction_string.data[fraction_string.size++] = digits[index];
-            after_decimal--;
-        }
-
-        str.size += fraction_string.size + 1;
-    }
+    str.size = format_f32(str.data, number);
 }
-void to_string(String& str, f64 number, u32 after_decimal)
-{
-    gn_assert_with_message(str.data, "Destination string for float to string conversion points to null!");
-
-    u64 old_size = str.size;
-
-    s64 integer = (s64) number;
-    f64 fractional = number - (f64) integer;
-
-    to_string(str, integer);
-
-    if (after_decimal > 0)
-    {
-        str.data[str.size] = '.';
 
-        String fraction_string = { str.data + str.size + 1, 0 };
-
-        constexpr char digits[] = "0123456789abcdef";
-        while (after_decimal)
-        {
-            fractional *= 10;
-            s32 index = ((s32) fractional) % 10;
-            fraction_string.data[fraction_string.size++] = digits[index];
-            after_decimal--;
-        }
-
-        str.size += fraction_string.size + 1;
-    }
-}
-
-s64 int64_from_string(const String& str)
+void to_string(String& str, f64 number)
 {
-    gn_assert_with_message(str.size <= 127, "Only strings smaller <= 127 characters in length can be converted to ints! (length: %)", str.size);
-
-    // Make string c-string compatible
-    char buffer[128] = {};
-    platform_copy_memory(buffer, str.data, str.size);   // WARNING! This can end up reading outside the allocated memory
-    return _atoi64(buffer);
+    gn_assert_with_message(str.data, "Destination string for float to string conversion points to null!");
+    str.size = format_f64(str.data, number);
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 
 struct String;
 
+// Write into the string's buffer and set its size, see core/number_conversion.h
+// for how big the buffer needs to be
+
 // Signed
 void to_string(String& str, s32 integer, u32 radix = 10);
 void to_string(String& str, s64 integer, u32 radix = 10);
@@ -13,11 +16,9 @@ void to_string(String& str, s64 integer, u32 radix = 10);
 void to_string(String& str, u32 integer, u32 radix = 10);
 void to_string(String& str, u64 integer, u32 radix = 10);
 
-// Floats
-void to_string(String& str, f32 number, u32 after_decimal = 4);
-void to_string(String& str, f64 number, u32 after_decimal = 4);
-
-s64 int64_from_string(const String& str);
+// Floats, shortest representation that reads back to the same value
+void to_string(String& str, f32 number);
+void to_string(String& str, f64 number);
 
 inline bool is_alphabet(char ch)
 {
@@ -3,15 +3,19 @@
 #include "application/application.h"
 #include "core/types.h"
 #include "core/logger.h"
+#include "core/atom.h"
 #include "core/input.h"
 #include "platform/platform.h"
 #include "containers/bytes.h"
 #include "containers/darray.h"
+#include "containers/frozen_map.h"
 #include "containers/hash_table.h"
+#include "containers/small_array.h"
 #include "graphics/texture.h"
 #include "graphics/shader.h"
 #include "math/math.h"
 #include "serialization/slz/slz_document.h"
+#include "serialization/slz/slz_schema.h"
 #include "serialization/binary.h"
 #include "batch.h"
 #include "rect.h"
@@ -61,12 +65,14 @@ static struct
 
     Vector4 offset_v2;  // x,z and y,w are the same
     Vector4 scale_v2;   // x,z and y,w are the same
-    DynamicArray<Rect> window_rects;
+    SmallArray<Rect, 8> window_rects;   // Nesting rarely goes past a few levels
 
     Vertex* batch_shared_buffer = nullptr;
 
     DynamicArray<Callback> button_callbacks;
     bool batch_begun = false;
+
+    Atom u_textures;
 } ui_data;
 
 static void init_white_texture(int width, int height)
@@ -91,6 +97,8 @@ static void init_batches()
     constexpr size_t batch_size = 4 * max_quad_count;
     ui_data.batch_shared_buffer = (Vertex*) platform_allocate(2 * batch_size * sizeof(Vertex));
 
+    ui_data.u_textures = atom_intern(ref("u_textures"));
+
     {   // Init Quad Batch
         ui_data.quad_batch.elem_vertices_buffer = ui_data.batch_shared_buffer;
 
@@ -183,7 +191,7 @@ void init(const Application& app)
     set_offset(0, 0);
     set_scale(1, 1);
 
-    ui_data.window_rects = make<DynamicArray<Rect>>();
+    ui_data.window_rects = make<SmallArray<Rect, 8>>();
     ui_data.button_callbacks = make<DynamicArray<Callback>>();
 }
 
@@ -192,6 +200,7 @@ void shutdown()
     gn_assert_with_message(active_app, "Imgui was never initialized!");
 
     free(ui_data.white_texture);
+    free(ui_data.window_rects);
 
     platform_free(ui_data.batch_shared_buffer);
 
@@ -221,7 +230,7 @@ static void flush_batch(ImguiBatchData& batch)
     for (u32 i = 0; i < batch.next_active_tex_slot; i++)
         texture_bind(batch.textures[i], i);
     
-    shader_set_uniform_1iv(batch.shader, ref("u_textures"), batch.next_active_tex_slot, active_tex_slots);
+    shader_set_uniform_1iv(batch.shader, ui_data.u_textures, batch.next_active_tex_slot, active_tex_slots);
     
     // Bind and Update Data
     GLsizeiptr size = (u8*) batch.elem_vertices_ptr - (u8*) batch.elem_vertices_buffer;
@@ -280,6 +289,12 @@ static inline s32 get_kerning_index(s32 a, s32 b)
     return ((a << 8) | b);
 }
 
+// Glyphs are only stored for printable ascii
+static inline bool has_glyph_slot(s32 unicode)
+{
+    return unicode >= ' ' && unicode - ' ' < (s32) (sizeof(Font::glyphs) / sizeof(Font::GlyphData));
+}
+
 static inline Font::Type get_font_type(const String type_string)
 {
     if (type_string == ref("hardmask"))
@@ -296,6 +311,54 @@ static inline Font::Type get_font_type(const String type_string)
     return Font::Type::SDF;
 }
 
+// Glyphs and kerning pairs as they are in the font json
+struct GlyphRecord
+{
+    s32 unicode;
+    Font::GlyphData data;
+};
+
+struct KerningRecord
+{
+    s32 unicode1;
+    s32 unicode2;
+    f32 advance;
+};
+
+static Slz::Field plane_bounds_fields[] = {
+    SLZ_FIELD(Vector4, x, "left",   F32),
+    SLZ_FIELD(Vector4, y, "bottom", F32),
+    SLZ_FIELD(Vector4, z, "right",  F32),
+    SLZ_FIELD(Vector4, w, "top",    F32),
+};
+
+// Texture coordinates go from the top
+static Slz::Field atlas_bounds_fields[] = {
+    SLZ_FIELD(Vector4, x, "left",   F32),
+    SLZ_FIELD(Vector4, y, "top",    F32),
+    SLZ_FIELD(Vector4, z, "right",  F32),
+    SLZ_FIELD(Vector4, w, "bottom", F32),
+};
+
+static Slz::Schema plane_bounds_schema = make<Slz::Schema>("planeBounds", plane_bounds_fields, 4u);
+static Slz::Schema atlas_bounds_schema = make<Slz::Schema>("atlasBounds", atlas_bounds_fields, 4u);
+
+static Slz::Field glyph_fields[] = {
+    SLZ_FIELD(GlyphRecord, unicode,      "unicode", S32),
+    SLZ_FIELD(GlyphRecord, data.advance, "advance", F32),
+    SLZ_OBJECT_FIELD(GlyphRecord, data.plane_bounds, "planeBounds", plane_bounds_schema, true),
+    SLZ_OBJECT_FIELD(GlyphRecord, data.atlas_bounds, "atlasBounds", atlas_bounds_schema, true),
+};
+
+static Slz::Field kerning_fields[] = {
+    SLZ_FIELD(KerningRecord, unicode1, "unicode1", S32),
+    SLZ_FIELD(KerningRecord, unicode2, "unicode2", S32),
+    SLZ_FIELD(KerningRecord, advance,  "advance",  F32),
+};
+
+static Slz::Schema glyph_schema   = make<Slz::Schema>("glyph",   glyph_fields,   4u);
+static Slz::Schema kerning_schema = make<Slz::Schema>("kerning", kerning_fields, 3u);
+
 Font font_load_from_document(const Slz::Document& document, const String atlas_path)
 {
     Font font = {};
@@ -314,52 +377,66 @@ Font font_load_from_document(const Slz::Document& document, const String atlas_p
     font.ascender    = metrics[ref("ascender")].float64();
     font.descender   = metrics[ref("descender")].float64();
 
-    const Slz::Array& glyphs = data[ref("glyphs")].array();
-    for (u64 i = 0; i < glyphs.size(); i++)
-    {
-        const u32 unicode = glyphs[i][ref("unicode")].int64();
-        
-        Font::GlyphData& glyph_data = font.glyphs[unicode - ' '];
+    Arena& scratch = get_scratch_arena();
+    const ArenaMarker marker = arena_get_marker(scratch);
 
-        glyph_data.advance = glyphs[i][ref("advance")].float64();
+    {   // Glyphs, bounds are optional so the records start out zeroed
+        const Slz::Value glyphs = data[ref("glyphs")];
+        const u64 glyph_count = glyphs.array().size();
 
-        {   // Plane bounds
-            const Slz::Value& plane_bounds = glyphs[i][ref("planeBounds")];
+        GlyphRecord* records = (GlyphRecord*) arena_allocate(scratch, glyph_count * sizeof(GlyphRecord), alignof(GlyphRecord));
+        platform_set_memory(records, 0, glyph_count * sizeof(GlyphRecord));
 
-            if (plane_bounds.type() != Slz::Type::NONE)
+        gn_warn_if(!Slz::deserialize_array(glyphs, glyph_schema, records, sizeof(GlyphRecord)), "Font glyphs don't match the expected layout!");
+
+        // Records that failed to load are left zeroed, unicode 0 doesn't have a slot so they get skipped too
+        for (u64 i = 0; i < glyph_count; i++)
+        {
+            if (!has_glyph_slot(records[i].unicode))
             {
-                glyph_data.plane_bounds = Vector4 {
-                    (f32) plane_bounds[ref("left")].float64(),
-                    (f32) plane_bounds[ref("bottom")].float64(),
-                    (f32) plane_bounds[ref("right")].float64(),
-                    (f32) plane_bounds[ref("top")].float64()
-                };
+                gn_warn("Skipping glyph that isn't printable ascii! (unicode: %, glyph: %)", records[i].unicode, i);
+                continue;
             }
+
+            Font::GlyphData& glyph_data = font.glyphs[records[i].unicode - ' '];
+            glyph_data = records[i].data;
+
+            glyph_data.atlas_bounds.x /= texture_width;
+            glyph_data.atlas_bounds.y /= texture_height;
+            glyph_data.atlas_bounds.z /= texture_width;
+            glyph_data.atlas_bounds.w /= texture_height;
         }
+    }
+
+    {   // Kerning, collected in a hash table first so repeated pairs keep the last value
+        const Slz::Value kerning = data[ref("kerning")];
+        const u64 pair_count = kerning.array().size();
+
+        KerningRecord* records = (KerningRecord*) arena_allocate(scratch, pair_count * sizeof(KerningRecord), alignof(KerningRecord));
+        platform_set_memory(records, 0, pair_count * sizeof(KerningRecord));
 
-        {   // Atlas bounds
-            const Slz::Value& atlas_bounds = glyphs[i][ref("atlasBounds")];
+        gn_warn_if(!Slz::deserialize_array(kerning, kerning_schema, records, sizeof(KerningRecord)), "Font kerning doesn't match the expected layout!");
 
-            if (atlas_bounds.type() != Slz::Type::NONE)
+        HashTable<s32, f32> kerning_pairs = make<HashTable<s32, f32>>((u32) (pair_count * 2), arena_allocator(scratch));
+
+        // Same as the glyphs, pairs that failed to load are zeroed and skipped
+        for (u64 i = 0; i < pair_count; i++)
+        {
+            if (!has_glyph_slot(records[i].unicode1) || !has_glyph_slot(records[i].unicode2))
             {
-                glyph_data.atlas_bounds = Vector4 {
-                    (f32) atlas_bounds[ref("left")].float64()   / texture_width,
-                    (f32) atlas_bounds[ref("top")].float64()    / texture_height,
-                    (f32) atlas_bounds[ref("right")].float64()  / texture_width,
-                    (f32) atlas_bounds[ref("bottom")].float64() / texture_height
-                };
+                gn_warn("Skipping kerning pair that isn't printable ascii! (unicodes: %, %, pair: %)", records[i].unicode1, records[i].unicode2, i);
+                continue;
             }
+
+            put(kerning_pairs, get_kerning_index(records[i].unicode1, records[i].unicode2), records[i].advance);
         }
-    }
 
-    const Slz::Array& kerning = data[ref("kerning")].array();
-    font.kerning_table = make<Font::KerningTable>();
-    for (u64 i = 0; i < kerning.size(); i++)
-    {
-        s32 k_index = get_kerning_index(kerning[i][(ref("unicode1"))].int64(), kerning[i][(ref("unicode2"))].int64());
-        put(font.kerning_table, k_index, (f32) kerning[i][ref("advance")].float64());
+        font.kerning_table = freeze(kerning_pairs);
+        gn_warn_if(font.kerning_table.count != kerning_pairs.filled, "Could not build the kerning table, font won't have kerning! (pair count: %)", kerning_pairs.filled);
     }
 
+    arena_restore(scratch, marker);
+
     {   // Load font altas
         TextureSettings settings = TextureSettings::default();
         settings.min_filter = settings.max_filter = (font.type == Font::Type::HARDMASK) ? TextureSettings::Filter::NEAREST : TextureSettings::Filter::LINEAR;
@@ -392,17 +469,24 @@ Font font_load_from_bytes(const Bytes& bytes)
     }
 
     {   // Kerning Data
-        u32 num_kernings = Binary::get_next_uint(bytes, offset) / 2;
+        const u32 num_kernings = Binary::get_next_uint(bytes, offset) / 2;
+
+        // The file could repeat pairs, which can't go in a frozen map, so they go through a table first
+        Arena& scratch = get_scratch_arena();
+        const ArenaMarker marker = arena_get_marker(scratch);
 
-        const u32 kerning_table_size = 1.5f * (num_kernings);
-        font.kerning_table = make<Font::KerningTable>(kerning_table_size);
+        HashTable<s32, f32> kerning_pairs = make<HashTable<s32, f32>>(num_kernings * 2, arena_allocator(scratch));
 
-        while (num_kernings--)
+        for (u32 i = 0; i < num_kernings; i++)
         {
-            s32 key = Binary::get<s32>(bytes, offset);
-            f32 advance = Binary::get<f32>(bytes, offset);
-            put(font.kerning_table, key, advance);
+            const s32 key = Binary::get<s32>(bytes, offset);
+            put(kerning_pairs, key, Binary::get<f32>(bytes, offset));
         }
+
+        font.kerning_table = freeze(kerning_pairs);
+        gn_warn_if(font.kerning_table.count != kerning_pairs.filled, "Could not build the kerning table, font won't have kerning! (pair count: %)", kerning_pairs.filled);
+
+        arena_restore(scratch, marker);
     }
 
     {   // Texture Data
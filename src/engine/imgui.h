@@ -4,7 +4,8 @@
 #include "core/types.h"
 #include "containers/bytes.h"
 #include "containers/hash_table.h"
-#include "containers/function.h"
+#include "containers/delegate.h"
+#include "containers/frozen_map.h"
 #include "graphics/texture.h"
 #include "math/math.h"
 #include "serialization/slz/slz_document.h"
@@ -43,7 +44,7 @@ struct ID
     }
 };
 
-using Callback = Function<void(ID)>;
+using Callback = Delegate<void(ID)>;
 using Image = Texture;
 
 struct Font
@@ -62,7 +63,7 @@ struct Font
         SDF
     };
 
-    using KerningTable = HashTable<s32, f32>;
+    using KerningTable = FrozenMap<s32, f32>;   // Built once when the font is loaded
 
     Texture atlas;
     Type type;
@@ -60,22 +60,17 @@ Bytes font_encode_to_bytes(const Font& font)
     }
 
     {   // Kerning
-        u32 count = font.kerning_table.filled;
+        const u32 count = font.kerning_table.count;
         append(bytes, Binary::ARRAY_2_BYTE);
         Binary::append_integer(bytes, (u16) (count * 2));
 
-        for (u32 i = 0; count > 0 && i < font.kerning_table.capacity; i++)
+        for (u32 i = 0; i < count; i++)
         {
-            if (font.kerning_table.states[i] == Font::KerningTable::State::ALIVE)
-            {
-                append(bytes, Binary::INTEGER_S32);
-                Binary::append_integer(bytes, font.kerning_table.keys[i]);
-                
-                append(bytes, Binary::FLOAT_32);
-                Binary::append_float(bytes, font.kerning_table.values[i]);
-
-                count--;
-            }
+            append(bytes, Binary::INTEGER_S32);
+            Binary::append_integer(bytes, font.kerning_table.entries[i].key);
+            
+            append(bytes, Binary::FLOAT_32);
+            Binary::append_float(bytes, font.kerning_table.entries[i].value);
         }
     }
 
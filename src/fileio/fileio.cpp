@@ -4,6 +4,7 @@
 #include "containers/string.h"
 #include "containers/bytes.h"
 #include "containers/darray.h"
+#include "platform/platform.h"
 
 String file_load_string(const String& filepath)
 {
@@ -44,6 +45,24 @@ Bytes file_load_bytes(const String& filepath)
     return Bytes { output.data, output.capacity };
 }
 
+Bytes file_map_bytes(const String& filepath)
+{
+    // TODO: Strings are not always null terminated. Do something about that!
+    u64 size;
+    const void* data = platform_map_file(filepath.data, size);
+    gn_assert_with_message(data, "Error mapping file! (filepath: \"%\")", filepath);
+
+    return Bytes { (u8*) data, size };
+}
+
+void file_unmap_bytes(Bytes& bytes)
+{
+    platform_unmap_file(bytes.data);
+
+    bytes.data = nullptr;
+    bytes.size = 0;
+}
+
 void file_write_string(const String& filepath, const String& string)
 {
     // TODO: Strings are not always null terminated. Do something about that!
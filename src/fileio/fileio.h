@@ -7,5 +7,9 @@
 String file_load_string(const String& filepath);
 Bytes  file_load_bytes(const String& filepath);
 
+// Maps the file instead of reading it, the bytes are read only and stay valid until file_unmap_bytes
+Bytes file_map_bytes(const String& filepath);
+void  file_unmap_bytes(Bytes& bytes);
+
 void file_write_string(const String& filepath, const String& string);
 void file_write_bytes(const String& filepath, const Bytes& bytes);
\ No newline at end of file
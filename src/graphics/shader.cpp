@@ -2,7 +2,8 @@
 
 #include "core/types.h"
 #include "containers/string.h"
-#include "containers/hash_table.h"
+#include "containers/frozen_map.h"
+#include "core/allocator.h"
 #include "math/mats/matrix4.h"
 #include "core/logger.h"
 #include "fileio/fileio.h"
@@ -74,7 +75,44 @@ bool shader_link(Shader& shader)
     glDeleteShader(shader.ids[0]);
     glDeleteShader(shader.ids[1]);
 
-    shader.uniforms = make<HashTable<String, s32>>();
+    {   // Look up all the uniform locations once, the set of uniforms can't change after linking
+        GLint uniform_count = 0;
+        glGetProgramiv(shader.program, GL_ACTIVE_UNIFORMS, &uniform_count);
+
+        Arena& scratch = get_scratch_arena();
+        const ArenaMarker marker = arena_get_marker(scratch);
+
+        Atom* names    = (Atom*) arena_allocate(scratch, max(uniform_count, 1) * sizeof(Atom));
+        s32* locations = (s32*)  arena_allocate(scratch, max(uniform_count, 1) * sizeof(s32));
+
+        for (GLint i = 0; i < uniform_count; i++)
+        {
+            GLchar name[256];
+            GLsizei length = 0;
+            GLint size;
+            GLenum type;
+            glGetActiveUniform(shader.program, (GLuint) i, sizeof(name), &length, &size, &type, name);
+
+            // Arrays are reported as "name[0]" but they're set using just the name
+            if (length > 3 && name[length - 3] == '[' && name[length - 2] == '0' && name[length - 1] == ']')
+                length -= 3;
+
+            name[length] = '\0';
+
+            names[i]     = atom_intern(ref(name, length));
+            locations[i] = glGetUniformLocation(shader.program, name);
+        }
+
+        shader.uniforms = make<FrozenMap<Atom, s32>>(names, locations, (u32) uniform_count);
+        arena_restore(scratch, marker);
+
+        // Only happens if two uniforms end up with the same name
+        if (shader.uniforms.count != (u32) uniform_count)
+        {
+            print("Shader Error: Could not build the uniform table! (uniform count: %)\n", uniform_count);
+            return false;
+        }
+    }
 
     return true;
 }
@@ -84,70 +122,65 @@ void shader_bind(const Shader& shader)
     glUseProgram(shader.program);
 }
 
-static inline s32 get_uniform_location(Shader& shader, String uniform_name)
+static inline s32 get_uniform_location(const Shader& shader, const Atom uniform_name)
 {
     auto elem = find(shader.uniforms, uniform_name);
-    if (elem)
-        return elem.value();
-
-    s32 uniform_location = glGetUniformLocation(shader.program, uniform_name.data);
-    gn_assert_with_message(uniform_location >= 0, "Uniform not found in shader! (name: %)", uniform_name);
+    gn_assert_with_message(elem, "Uniform not found in shader! (name: %)", atom_get_string(uniform_name));
 
-    put(shader.uniforms, uniform_name, uniform_location);
-    return uniform_location;
+    return (elem) ? elem.value() : -1;
 }
 
-void shader_set_uniform_1i(Shader& shader, String uniform_name, s32 v0)
+void shader_set_uniform_1i(Shader& shader, const Atom uniform_name, s32 v0)
 {
     glUniform1i(get_uniform_location(shader, uniform_name), v0);
 }
 
-void shader_set_uniform_1iv(Shader& shader, String uniform_name, u32 count, s32* vs)
+void shader_set_uniform_1iv(Shader& shader, const Atom uniform_name, u32 count, s32* vs)
 {
     glUniform1iv(get_uniform_location(shader, uniform_name), count, vs);
 }
 
-void shader_set_uniform_1f(Shader& shader, String uniform_name, f32 v0)
+void shader_set_uniform_1f(Shader& shader, const Atom uniform_name, f32 v0)
 {
     glUniform1f(get_uniform_location(shader, uniform_name), v0);
 }
 
-void shader_set_uniform_1fv(Shader& shader, String uniform_name, u32 count, f32* vs)
+void shader_set_uniform_1fv(Shader& shader, const Atom uniform_name, u32 count, f32* vs)
 {
     glUniform1fv(get_uniform_location(shader, uniform_name), count, vs);
 }
 
-void shader_set_uniform_2f(Shader& shader, String uniform_name, f32 v0, f32 v1)
+void shader_set_uniform_2f(Shader& shader, const Atom uniform_name, f32 v0, f32 v1)
 {
     glUniform2f(get_uniform_location(shader, uniform_name), v0, v1);
 }
 
-void shader_set_uniform_2fv(Shader& shader, String uniform_name, u32 count, f32* vs)
+void shader_set_uniform_2fv(Shader& shader, const Atom uniform_name, u32 count, f32* vs)
 {
     glUniform2fv(get_uniform_location(shader, uniform_name), count, vs);
 }
 
-void shader_set_uniform_3f(Shader& shader, String uniform_name, f32 v0, f32 v1, f32 v2)
+void shader_set_uniform_3f(Shader& shader, const Atom uniform_name, f32 v0, f32 v1, f32 v2)
 {
     glUniform3f(get_uniform_location(shader, uniform_name), v0, v1, v2);
 }
 
-void shader_set_uniform_3fv(Shader& shader, String uniform_name, u32 count, f32* vs)
+void shader_set_uniform_3fv(Shader& shader, const Atom uniform_name, u32 count, f32* vs)
 {
     glUniform3fv(get_uniform_location(shader, uniform_name), count, vs);
 }
 
-void shader_set_uniform_4f(Shader& shader, String uniform_name, f32 v0, f32 v1, f32 v2, f32 v3)
+void shader_set_uniform_4f(Shader& shader, const Atom uniform_name, f32 v0, f32 v1, f32 v2, f32 v3)
 {
     glUniform4f(get_uniform_location(shader, uniform_name), v0, v1, v2, v3);
 }
 
-void shader_set_uniform_4fv(Shader& shader, String uniform_name, u32 count, f32* vs)
+void shader_set_uniform_4fv(Shader& shader, const Atom uniform_name, u32 count, f32* vs)
 {
     glUniform4fv(get_uniform_location(shader, uniform_name), count, vs);
 }
 
-void shader_set_uniform_mat4(Shader& shader, String uniform_name, const Matrix4& mat)
+void shader_set_uniform_mat4(Shader& shader, const Atom uniform_name, const Matrix4& mat)
 {
     glUniformMatrix4fv(get_uniform_location(shader, uniform_name), 1, false, (f32*) mat.data);
 }
\ No newline at end of file
@@ -1,31 +1,67 @@
 #include "texture.h"
 
 #include "core/types.h"
+#include "core/atom.h"
 #include "containers/string.h"
-#include "containers/hash_table.h"
+#include "containers/concurrent_hash_map.h"
+#include "containers/slot_map.h"
 
+#include <atomic>
+#include <emmintrin.h>
 #include <stb_image.h>
 #include <glad/glad.h>
 
-static HashTable<String, Texture> loaded_textures = make<HashTable<String, Texture>>();
-
-// OpenGL generates textureIDs sequentially so
-// this way extra data about the texture can be accessed
-// by using them as an index into an array rather than
-// copying them everywhere.
+// Shared cache so textures can be looked up, and loads deduplicated, from any thread.
+// Loading and freeing still make GL calls, so they need the thread the GL context is current on.
+static ConcurrentHashMap<Atom, Texture> loaded_textures = make<ConcurrentHashMap<Atom, Texture>>();
 
+// Extra data about every loaded texture, textures only carry a handle to it
 struct TextureData
 {
     s32 width, height, bytes_pp;
-    String name;
+    Atom name;
 };
 
-constexpr u32 max_loaded_textures = 10;
-static TextureData texture_data_table[max_loaded_textures] = {};
+static SlotMap<TextureData> texture_data_table = make<SlotMap<TextureData>>();
+
+// SlotMap isn't thread safe and moves its values when it grows, so the table is only
+// touched with this held and data is copied out. It's never held for longer than that.
+static std::atomic<bool> texture_data_locked(false);
+
+static inline void lock_texture_data()
+{
+    while (texture_data_locked.exchange(true, std::memory_order_acquire))
+    {
+        while (texture_data_locked.load(std::memory_order_relaxed))
+            _mm_pause();
+    }
+}
+
+static inline void unlock_texture_data()
+{
+    texture_data_locked.store(false, std::memory_order_release);
+}
+
+static inline TextureData internal_get_texture_data(const Texture& texture)
+{
+    // Null textures read as empty, same as before they're loaded
+    if (!texture.data)
+        return TextureData {};
+
+    lock_texture_data();
+
+    const TextureData* data = get(texture_data_table, texture.data);
+    const TextureData copy = data ? *data : TextureData {};
+
+    unlock_texture_data();
+
+    gn_assert_with_message(data, "Texture handle is stale, the texture was freed! (texture id: %)", texture.id);
+    return copy;
+}
 
 static inline Texture internal_create_texture()
 {
-    Texture texture;
+    Texture texture = {};
     glGenTextures(1, &texture.id);
     return texture;
 }
@@ -70,12 +106,18 @@ static inline void internal_set_pixels(Texture& texture, const u8* pixels, s32 w
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLint) settings.wrap_t);
 }
 
-static inline void internal_set_texture_data(const Texture& texture, const String name, s32 width, s32 height, s32 bytes_pp)
+static inline void internal_set_texture_data(Texture& texture, const Atom name, s32 width, s32 height, s32 bytes_pp)
 {
-    texture_data_table[texture.id].width    = width;
-    texture_data_table[texture.id].height   = height;
-    texture_data_table[texture.id].bytes_pp = bytes_pp;
-    texture_data_table[texture.id].name     = name;
+    const TextureData data = { width, height, bytes_pp, name };
+
+    lock_texture_data();
+
+    if (TextureData* existing = get(texture_data_table, texture.data))
+        *existing = data;
+    else
+        texture.data = insert(texture_data_table, data);
+
+    unlock_texture_data();
 }
 
 Texture texture_load_file(const String filepath, const TextureSettings& settings, s32 desired_channels)
@@ -85,38 +127,39 @@ Texture texture_load_file(const String filepath, const TextureSettings& settings
 
 Texture texture_load_file_with_name(const String name, const String filepath, const TextureSettings& settings, s32 desired_channels)
 {
-    auto tex = find(loaded_textures, filepath);
-    if (tex)
-        return tex.value();
+    // Textures are stored by name so that's what needs to be looked up
+    const Atom name_atom = atom_intern(name);
 
-    s32 width, height, bytes_pp;
-    u8* pixels = stbi_load(filepath.data, &width, &height, &bytes_pp, desired_channels);
-    gn_assert_with_message(pixels, "Couldn't load image data! (filepath: \"%\")", filepath);
+    return find_or_insert(loaded_textures, name_atom, [&](const Atom)
+    {
+        s32 width, height, bytes_pp;
+        u8* pixels = stbi_load(filepath.data, &width, &height, &bytes_pp, desired_channels);
+        gn_assert_with_message(pixels, "Couldn't load image data! (filepath: \"%\")", filepath);
 
-    if (desired_channels != 0)
-        bytes_pp = desired_channels;
+        if (desired_channels != 0)
+            bytes_pp = desired_channels;
 
-    Texture texture = internal_create_texture();
-    internal_set_pixels(texture, pixels, width, height, bytes_pp, settings);
-    internal_set_texture_data(texture, name, width, height, bytes_pp);
-    put(loaded_textures, name, texture);
+        Texture texture = internal_create_texture();
+        internal_set_pixels(texture, pixels, width, height, bytes_pp, settings);
+        internal_set_texture_data(texture, name_atom, width, height, bytes_pp);
 
-    stbi_image_free(pixels);
-    return texture;    
+        stbi_image_free(pixels);
+        return texture;
+    });
 }
 
 Texture texture_load_pixels(const String name, const u8* pixels, s32 width, s32 height, s32 bytes_pp, const TextureSettings& settings)
 {
-    auto tex = find(loaded_textures, name);
-    if (tex)
-        return tex.value();
+    const Atom name_atom = atom_intern(name);
 
-    Texture texture = internal_create_texture();
-    internal_set_pixels(texture, pixels, width, height, bytes_pp, settings);
-    internal_set_texture_data(texture, name, width, height, bytes_pp);
-    put(loaded_textures, name, texture);   
+    return find_or_insert(loaded_textures, name_atom, [&](const Atom)
+    {
+        Texture texture = internal_create_texture();
+        internal_set_pixels(texture, pixels, width, height, bytes_pp, settings);
+        internal_set_texture_data(texture, name_atom, width, height, bytes_pp);
 
-    return texture;
+        return texture;
+    });
 }
 
 void texture_set_pixels_from_image(Texture& texture, const String filepath,  const TextureSettings& settings)
@@ -126,7 +169,7 @@ void texture_set_pixels_from_image(Texture& texture, const String filepath,  con
     gn_assert_with_message(pixels, "Couldn't load image data! (filepath: \"%\")", filepath);
 
     internal_set_pixels(texture, pixels, width, height, bytes_pp, settings);
-    internal_set_texture_data(texture, texture_get_name(texture), width, height, bytes_pp);
+    internal_set_texture_data(texture, internal_get_texture_data(texture).name, width, height, bytes_pp);
 
     stbi_image_free(pixels);
 }
@@ -134,7 +177,7 @@ void texture_set_pixels_from_image(Texture& texture, const String filepath,  con
 void texture_set_pixels(Texture& texture, const u8* pixels, s32 width, s32 height, s32 bytes_pp,  const TextureSettings& settings)
 {
     internal_set_pixels(texture, pixels, width, height, bytes_pp, settings);
-    internal_set_texture_data(texture, texture_get_name(texture), width, height, bytes_pp);
+    internal_set_texture_data(texture, internal_get_texture_data(texture).name, width, height, bytes_pp);
 }
 
 void free(Texture& texture)
@@ -142,12 +185,16 @@ void free(Texture& texture)
     if (!texture.id)
         return;
 
-    auto elem = find(loaded_textures, texture_data_table[texture.id].name);
-    gn_assert_with_message((bool) elem, "Texture id is not 0 but hasn't been loaded properly!");
-    remove(elem);
+    const bool removed = remove(loaded_textures, internal_get_texture_data(texture).name);
+    gn_assert_with_message(removed, "Texture id is not 0 but hasn't been loaded properly!");
+
+    lock_texture_data();
+    erase(texture_data_table, texture.data);
+    unlock_texture_data();
 
     glDeleteTextures(1, &texture.id);
     texture.id = 0;
+    texture.data = {};
 }
 
 // Assuming there are 32 texture slots in the GPU
@@ -167,32 +214,32 @@ void texture_bind(const Texture& texture, s32 slot)
 
 s32 texture_get_width(const Texture& texture)
 {
-    return texture_data_table[texture.id].width;
+    return internal_get_texture_data(texture).width;
 }
 
 s32 texture_get_height(const Texture& texture)
 {
-    return texture_data_table[texture.id].height;
+    return internal_get_texture_data(texture).height;
 }
 
 s32 texture_get_bytes_pp(const Texture& texture)
 {
-    return texture_data_table[texture.id].bytes_pp;
+    return internal_get_texture_data(texture).bytes_pp;
 }
 
 const String texture_get_name(const Texture& texture)
 {
-    return texture_data_table[texture.id].name;
+    return atom_get_string(internal_get_texture_data(texture).name);
 }
 
 bool texture_get_existing(const String name, Texture& out_texture)
 {
-    auto tex = find(loaded_textures, name);
-    if (!tex)
+    // Texture can't exist if its name was never interned
+    Atom name_atom;
+    if (!atom_find(name, name_atom))
         return false;
 
-    out_texture = tex.value();
-    return true;
+    return find(loaded_textures, name_atom, out_texture);
 }
 
 bool texture_is_valid(const Texture& texture)
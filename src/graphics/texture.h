@@ -2,6 +2,7 @@
 
 #include "core/types.h"
 #include "containers/string.h"
+#include "containers/slot_map.h"
 
 #include <glad/glad.h>
 
@@ -31,9 +32,12 @@ struct TextureSettings
     static TextureSettings default() { return TextureSettings(); }
 };
 
+struct TextureData;
+
 struct Texture
 {
     u32 id;
+    Handle<TextureData> data;   // Size, format and name, kept by the texture module
 };
 
 Texture texture_load_file(const String filepath, const TextureSettings& settings, s32 desired_channels = 0);
@@ -1,5 +1,7 @@
 #include "application/application.h"
 #include "platform/platform.h"
+#include "core/allocator.h"
+#include "containers/string_builder.h"
 #include "sprite_editor/context.h"
 #include "core/input.h"
 #include "engine/rect.h"
@@ -13,7 +15,7 @@ bool on_init(Application& app)
 
     context_init(ctx, app);
 
-    Input::register_mouse_scroll_event_callback(on_mouse_scroll);
+    Input::register_mouse_scroll_event_callback([&ctx](Application&, s32 scroll) { on_mouse_scroll(ctx, scroll); });
 
     return true;
 }
@@ -81,6 +83,7 @@ void on_update(Application& app)
                 data.size = Vector2 { data.tex_coords.right - data.tex_coords.left, data.tex_coords.bottom - data.tex_coords.top };
 
                 append(ctx.sprite_sheet.sprites, data);
+                context_on_sprite_count_changed(ctx);
             }
 
             ctx.input_state = EditorInputState::NONE;
@@ -90,17 +93,15 @@ void on_update(Application& app)
     {   // Select all
         if (Input::get_key(Key::CONTROL) && Input::get_key_down(Key::A))
         {
-            clear(ctx.sprites_selected);
-            for (int i = 0; i < ctx.sprite_sheet.sprites.size; i++)
-                append(ctx.sprites_selected, i);
+            set_all(ctx.sprites_selected);
         }
     }
 
     {   // Controls for selected sprites
-        if (ctx.sprites_selected.size > 0 && Input::get_key_down(Key::DELETE))
+        if (any_set(ctx.sprites_selected) && Input::get_key_down(Key::DELETE))
         {
-            append_many(ctx.sprites_to_be_deleted, ctx.sprites_selected.data, ctx.sprites_selected.size);
-            clear(ctx.sprites_selected);
+            bitset_or(ctx.sprites_to_be_deleted, ctx.sprites_selected);
+            clear_all(ctx.sprites_selected);
         }
     }
 }
@@ -139,25 +140,21 @@ void on_render(Application& app)
     {   // Render the existing sprites
         for (int i = 0; i < ctx.sprite_sheet.sprites.size; i++)
         {
-            const u64 sprite_index_in_selection = find(ctx.sprites_selected, i);
-            const bool is_sprite_selected = sprite_index_in_selection != ctx.sprites_selected.size;
+            const bool is_sprite_selected = test_bit(ctx.sprites_selected, i);
 
             const Vector4 color = is_sprite_selected ? Vector4 { 1.0f, 1.0f, 0.2f, 0.25f } : Vector4 { 1.0f, 0.2f, 0.2f, 0.25f };
             if (Imgui::render_button(imgui_gen_id_with_secondary(i), ctx.sprite_sheet.sprites[i].tex_coords, z, color))
             {
                 if (Input::get_key(Key::SHIFT))
                 {
-                    if (is_sprite_selected)
-                        remove(ctx.sprites_selected, sprite_index_in_selection);
-                    else
-                        append(ctx.sprites_selected, i);
+                    toggle_bit(ctx.sprites_selected, i);
                 }
                 else
                 {
-                    clear(ctx.sprites_selected);
+                    clear_all(ctx.sprites_selected);
 
                     if (!is_sprite_selected)
-                        append(ctx.sprites_selected, i);
+                        set_bit(ctx.sprites_selected, i);
                 }
             }
 
@@ -174,10 +171,7 @@ void on_render(Application& app)
         Vector2 top_left = Vector2 { 10.0f, 10.0f };
 
         {   // File Name
-            char buffer[128];
-            sprintf(buffer, "File: %s", ctx.filename.data);
-
-            String text = ref(buffer);        
+            const String text = arena_format(get_frame_arena(), "File: %", ctx.filename);
             Imgui::render_text(text, ctx.ui_font, top_left, z);
             z -= 0.001f;
 
@@ -185,10 +179,7 @@ void on_render(Application& app)
         }
 
         {   // File Size
-            char buffer[128];
-            sprintf(buffer, "Size: %dx%d", texture_get_width(ctx.background_image), texture_get_height(ctx.background_image));
-
-            String text = ref(buffer);
+            const String text = arena_format(get_frame_arena(), "Size: %x%", texture_get_width(ctx.background_image), texture_get_height(ctx.background_image));
             Imgui::render_text(text, ctx.ui_font, top_left, z);
             z -= 0.001f;
 
@@ -21,12 +21,24 @@ void platform_set_window_style(WindowStyle style);
 
 // Memory Stuff
 
-void* platform_allocate(u64 size);                   // TODO: Option for aligned memory
-void* platform_reallocate(void* block, u64 size);    // TODO: Option for aligned memory
-void  platform_free(void* block);                    // TODO: Option for aligned memory
+constexpr u64 CACHE_LINE_SIZE = 64;
+
+// Blocks are 16 byte aligned
+void* platform_allocate(u64 size);
+void* platform_reallocate(void* block, u64 size);
+void  platform_free(void* block);
+
+// Alignment must be a power of 2 (16, 32, 64, page size, etc.)
+// Aligned blocks must only be reallocated or freed with the aligned functions.
+void* platform_allocate_aligned(u64 size, u64 alignment);
+void* platform_reallocate_aligned(void* block, u64 size, u64 alignment);
+void  platform_free_aligned(void* block);
+
+u64 platform_get_page_size();
 
 void* platform_zero_memory(void* block, u64 size);
 void* platform_copy_memory(void* dest, const void* source, u64 size);
+void* platform_move_memory(void* dest, const void* source, u64 size);   // Source and dest can overlap
 void* platform_set_memory(void* dest, s32 value, u64 size);
 
 bool platform_compare_memory(const void* ptr1, const void* ptr2, u64 size);
@@ -45,4 +57,9 @@ void platform_show_mouse_cursor(bool value);
 
 // File Stuff
 
-bool platform_dialogue_open_file(const char filter[], char* out_filepath, u32 max_path_size);
\ No newline at end of file
+bool platform_dialogue_open_file(const char filter[], char* out_filepath, u32 max_path_size);
+
+// Maps the whole file read only, pages are only loaded once they're touched.
+// Returns null if the file can't be opened or is empty, unmap it with platform_unmap_file.
+const void* platform_map_file(const char* filepath, u64& out_size);
+void        platform_unmap_file(const void* data);
\ No newline at end of file
@@ -3,6 +3,7 @@
 #ifdef GN_PLATFORM_WINDOWS
 
 #include "core/types.h"
+#include "core/logger.h"
 #include "core/input.h"
 #include "core/input_processing.h"
 #include "internal/internal_win32.h"
@@ -181,6 +182,37 @@ void platform_free(void* block)
     free(block);
 }
 
+void* platform_allocate_aligned(u64 size, u64 alignment)
+{
+    gn_assert_with_message(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2! (alignment: %)", alignment);
+    return _aligned_malloc(size, alignment);
+}
+
+void* platform_reallocate_aligned(void* block, u64 size, u64 alignment)
+{
+    gn_assert_with_message(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2! (alignment: %)", alignment);
+    return _aligned_realloc(block, size, alignment);
+}
+
+void platform_free_aligned(void* block)
+{
+    _aligned_free(block);
+}
+
+u64 platform_get_page_size()
+{
+    static u64 page_size = 0;
+
+    if (page_size == 0)
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        page_size = (u64) info.dwPageSize;
+    }
+
+    return page_size;
+}
+
 void* platform_zero_memory(void* dest, u64 size)
 {
     return memset(dest, 0, size);
@@ -191,6 +223,11 @@ void* platform_copy_memory(void* dest, const void* source, u64 size)
     return memcpy(dest, source, size);
 }
 
+void* platform_move_memory(void* dest, const void* source, u64 size)
+{
+    return memmove(dest, source, size);
+}
+
 void* platform_set_memory(void* dest, s32 value, u64 size)
 {
     return memset(dest, value, size);
@@ -385,4 +422,42 @@ bool platform_dialogue_open_file(const char filter[], char* out_filepath, u32 ma
     return false;
 }
 
+const void* platform_map_file(const char* filepath, u64& out_size)
+{
+    out_size = 0;
+
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    // Empty files can't be mapped
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    // The mapping keeps the file open and the view keeps the mapping alive
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping)
+        return nullptr;
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (!data)
+        return nullptr;
+
+    out_size = (u64) size.QuadPart;
+    return data;
+}
+
+void platform_unmap_file(const void* data)
+{
+    UnmapViewOfFile(data);
+}
+
 #endif // GN_PLATFORM_WINDOWS
\ No newline at end of file
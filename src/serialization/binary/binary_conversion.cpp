@@ -4,147 +4,657 @@
 
 #include "core/types.h"
 #include "core/logger.h"
+#include "core/allocator.h"
+#include "core/atom.h"
 #include "containers/darray.h"
 #include "containers/bytes.h"
 #include "containers/string.h"
+#include "containers/hash_table.h"
 #include "serialization/slz.h"
 #include "binary_types.h"
 #include "binary_utils.h"
 
+#define decode_error(decoder, fmt, ...) { print_error("Binary Error[offset %]: " fmt "\n", decoder.offset, ##__VA_ARGS__); decoder.failed = true; gn_break_point(); }
+
 namespace Binary
 {
 
-static void encode_slz_value_to_binary(DynamicArray<u8>& bytes, Slz::Value value)
+namespace ConversionInternal
 {
-    switch (value.type())
+    // Nesting past this is reported as an error instead of recursing deeper
+    constexpr u32 MAX_NESTING_DEPTH = 1024;
+
+    struct Encoder
     {
-        case Slz::Type::NONE:
+        DynamicArray<u8> values;
+
+        // Every distinct key and string value gets an index into the string table
+        HashTable<String, u32> string_ids;
+        DynamicArray<String>   strings;
+        u64 string_bytes;
+
+        u64 value_count;
+        u64 tape_words;
+    };
+
+    // Size id is in the low bits of the type, so the wider types come right after the 1 byte one
+    static void append_sized(DynamicArray<u8>& bytes, u8 type_1_byte, u64 value)
+    {
+        if (value <= 0xffu)
+        {
+            append(bytes, type_1_byte);
+            append_integer(bytes, (u8) value);
+        }
+        else if (value <= 0xffffu)
         {
-            append(bytes, NIL);
-        } break;
-        
-        case Slz::Type::BOOLEAN:
+            append(bytes, (u8) (type_1_byte + 1));
+            append_integer(bytes, (u16) value);
+        }
+        else if (value <= 0xffffffffu)
         {
-            append(bytes, value.boolean() ? BOOLEAN_TRUE : BOOLEAN_FALSE);
-        } break;
+            append(bytes, (u8) (type_1_byte + 2));
+            append_integer(bytes, (u32) value);
+        }
+        else
+        {
+            gn_assert_with_message(type_1_byte != STRING_REF_1_BYTE, "String table index doesn't fit in 32 bits! (index: %)", value);
+
+            append(bytes, (u8) (type_1_byte + 3));
+            append_integer(bytes, value);
+        }
+    }
 
-        case Slz::Type::INTEGER:
+    static void append_string_ref(Encoder& encoder, const String str)
+    {
+        u32 id = (u32) encoder.strings.size;
+
+        auto element = find(encoder.string_ids, str);
+        if (element)
+        {
+            id = element.value();
+        }
+        else
         {
-            const s64 int_value = value.int64();
+            put(encoder.string_ids, str, id);
+            append(encoder.strings, str);
+            encoder.string_bytes += str.size;
+        }
 
-            // Encode in the least number of bytes required
-            if (int_value >= INT8_MIN && int_value <= INT8_MAX)
+        append_sized(encoder.values, STRING_REF_1_BYTE, id);
+    }
+
+    static void encode_value(Encoder& encoder, const Slz::Value value)
+    {
+        DynamicArray<u8>& bytes = encoder.values;
+        encoder.value_count++;
+
+        switch (value.type())
+        {
+            case Slz::Type::NONE:
             {
-                append(bytes, INTEGER_S8);
-                append_integer(bytes, (s8) int_value);
-            }
-            else if (int_value >= INT16_MIN && int_value <= INT16_MAX)
+                append(bytes, NIL);
+                encoder.tape_words += 1;
+            } break;
+
+            case Slz::Type::BOOLEAN:
             {
-                append(bytes, INTEGER_S16);
-                append_integer(bytes, (s16) int_value);
-            }
-            else if (int_value >= INT32_MIN && int_value <= INT32_MAX)
+                append(bytes, value.boolean() ? BOOLEAN_TRUE : BOOLEAN_FALSE);
+                encoder.tape_words += 1;
+            } break;
+
+            case Slz::Type::INTEGER:
             {
-                append(bytes, INTEGER_S32);
-                append_integer(bytes, (s32) int_value);
-            }
-            else
+                const s64 int_value = value.int64();
+                encoder.tape_words += 2;
+
+                // Encode in the least number of bytes required
+                if (int_value >= INT8_MIN && int_value <= INT8_MAX)
+                {
+                    append(bytes, INTEGER_S8);
+                    append_integer(bytes, (s8) int_value);
+                }
+                else if (int_value >= INT16_MIN && int_value <= INT16_MAX)
+                {
+                    append(bytes, INTEGER_S16);
+                    append_integer(bytes, (s16) int_value);
+                }
+                else if (int_value >= INT32_MIN && int_value <= INT32_MAX)
+                {
+                    append(bytes, INTEGER_S32);
+                    append_integer(bytes, (s32) int_value);
+                }
+                else
+                {
+                    append(bytes, INTEGER_S64);
+                    append_integer(bytes, int_value);
+                }
+            } break;
+
+            case Slz::Type::FLOAT:
             {
-                append(bytes, INTEGER_S64);
-                append_integer(bytes, int_value);
-            }
-        } break;
+                const f64 float_value = value.float64();
+                encoder.tape_words += 2;
 
-        case Slz::Type::FLOAT:
-        {
-            const f64 float_value = value.float64();
+                // Only floats that survive the round trip are shrunk, decoding has to give back the same values
+                if (float_value >= -FLT_MAX && float_value <= FLT_MAX && (f64) (f32) float_value == float_value)
+                {
+                    append(bytes, FLOAT_32);
+                    append_float(bytes, (f32) float_value);
+                }
+                else
+                {
+                    append(bytes, FLOAT_64);
+                    append_float(bytes, float_value);
+                }
+            } break;
 
-            // Encode as float 32 if value is small
-            if (float_value >= -FLT_MAX && float_value <= FLT_MAX)
+            case Slz::Type::STRING:
             {
-                append(bytes, FLOAT_32);
-                append_float(bytes, (f32) float_value);
-            }
-            else
+                encoder.tape_words += 2;
+                append_string_ref(encoder, value.string());
+            } break;
+
+            case Slz::Type::ARRAY:
             {
-                append(bytes, FLOAT_64);
-                append_float(bytes, float_value);
-            }
-        } break;
-        
-        case Slz::Type::STRING:
+                const Slz::Array array = value.array();
+                const u64 size = array.size();
+
+                append_sized(bytes, ARRAY_1_BYTE, size);
+                encoder.tape_words += 2 + Slz::tape_offset_words(size);
+
+                for (u64 i = 0; i < size; i++)
+                    encode_value(encoder, array[i]);
+            } break;
+
+            case Slz::Type::OBJECT:
+            {
+                const Slz::Object object = value.object();
+                const u32 count = object.filled();
+
+                append_sized(bytes, OBJECT_1_BYTE, count);
+                encoder.tape_words += 2 + Slz::tape_key_words(count) + Slz::tape_offset_words(count) + Slz::tape_index_words(count);
+
+                for (u32 i = 0; i < object.capacity(); i++)
+                {
+                    const Atom key = object.key_at(i);
+                    if (key == ATOM_NONE)
+                        continue;
+
+                    append_string_ref(encoder, atom_get_string(key));
+                    encode_value(encoder, object.value_at(i));
+                }
+            } break;
+        }
+    }
+
+    struct Decoder
+    {
+        const u8* data;
+        u64 size;
+        u64 offset;
+        u32 depth;
+        bool failed;
+
+        const u32*  string_ends;
+        const char* string_data;
+        u64         string_count;
+
+        // Strings are interned the first time they're used as a key, ATOM_NONE until then
+        Atom* key_atoms;
+
+        u64* tape;
+        u64  tape_size;
+        u64  tape_capacity;
+        u64  value_count;
+    };
+
+    static inline bool has_bytes(const Decoder& decoder, u64 count)
+    {
+        return count <= decoder.size - decoder.offset;
+    }
+
+    // Reads the number after a type id whose low bits are the size id
+    static u64 read_sized(Decoder& decoder)
+    {
+        const u8 size_id = decoder.data[decoder.offset] & 0b111;
+        const u64 size = 1ui64 << size_id;
+
+        if (size_id > 0b011 || !has_bytes(decoder, 1 + size))
         {
-            const String str = value.string();
-            append_string(bytes, str);
-        } break;
-        
-        case Slz::Type::ARRAY:
+            decode_error(decoder, "Ran out of data while reading a %!", get_type_name(decoder.data[decoder.offset]));
+            return 0;
+        }
+
+        const u8* at = decoder.data + decoder.offset + 1;
+        decoder.offset += 1 + size;
+
+        switch (size_id)
         {
-            const Slz::Array array = value.array();
+            case 0b000: return *(const u8*)  at;
+            case 0b001: return *(const u16*) at;
+            case 0b010: return *(const u32*) at;
+        }
 
-            // encode array length
-            if (array.size() <= 0xffu)
-            {
-                append(bytes, ARRAY_1_BYTE);
-                append_integer(bytes, (u8) array.size());
-            }
-            else if (array.size() <= 0xffffu)
+        return *(const u64*) at;
+    }
+
+    static inline bool is_string_ref(u8 type)
+    {
+        return type == STRING_REF_1_BYTE || type == STRING_REF_2_BYTE || type == STRING_REF_4_BYTE;
+    }
+
+    // Returns the index of the string in the table, or string_count if it's not valid
+    static u64 read_string_ref(Decoder& decoder)
+    {
+        if (!has_bytes(decoder, 1) || !is_string_ref(decoder.data[decoder.offset]))
+        {
+            decode_error(decoder, "Expected a string table index!");
+            return decoder.string_count;
+        }
+
+        const u64 id = read_sized(decoder);
+        if (!decoder.failed && id >= decoder.string_count)
+        {
+            decode_error(decoder, "String table index is out of bounds! (index: %, string count: %)", id, decoder.string_count);
+            return decoder.string_count;
+        }
+
+        return id;
+    }
+
+    static inline String get_table_string(const Decoder& decoder, u64 id)
+    {
+        const u32 start = (id == 0) ? 0 : decoder.string_ends[id - 1];
+        return ref((char*) decoder.string_data + start, (u64) (decoder.string_ends[id] - start));
+    }
+
+    // Takes words from the tape, which was sized from the header
+    static inline u64* take_words(Decoder& decoder, u64 count)
+    {
+        if (count > decoder.tape_capacity - decoder.tape_size)
+        {
+            decode_error(decoder, "Values take more space than the header says! (tape words: %)", decoder.tape_capacity);
+            return nullptr;
+        }
+
+        u64* words = decoder.tape + decoder.tape_size;
+        decoder.tape_size += count;
+
+        return words;
+    }
+
+    // Writes the value in the tape layout (see slz_tape.h), the same way document_compact does
+    static void decode_value(Decoder& decoder)
+    {
+        using namespace Slz;
+
+        if (!has_bytes(decoder, 1))
+        {
+            decode_error(decoder, "Ran out of data while expecting a value!");
+            return;
+        }
+
+        decoder.value_count++;
+
+        const u64 start = decoder.tape_size;
+        const u8 type = decoder.data[decoder.offset];
+
+        switch (type)
+        {
+            case NIL:
+            case BOOLEAN_FALSE:
+            case BOOLEAN_TRUE:
             {
-                append(bytes, ARRAY_2_BYTE);
-                append_integer(bytes, (u16) array.size());
-            }
-            else if (array.size() <= 0xffffffffu)
+                decoder.offset++;
+
+                u64* words = take_words(decoder, 1);
+                if (!words)
+                    return;
+
+                words[0] = (type == NIL) ? tape_word(Slz::Type::NONE, 0) : tape_word(Slz::Type::BOOLEAN, type == BOOLEAN_TRUE);
+            } break;
+
+            case INTEGER_S8:
+            case INTEGER_S16:
+            case INTEGER_S32:
+            case INTEGER_S64:
+            case INTEGER_U8:
+            case INTEGER_U16:
+            case INTEGER_U32:
+            case INTEGER_U64:
             {
-                append(bytes, ARRAY_4_BYTE);
-                append_integer(bytes, (u32) array.size());
-            }
-            else // (array.size() <= 0xffffffffffffffffu) // can't go bigger than this anyways
+                const bool is_signed = (type >= INTEGER_S8);
+                const u64 bits = 8 * (1ui64 << (type & 0b111));
+                const u64 raw  = read_sized(decoder);
+
+                if (!is_signed && raw > (u64) INT64_MAX)
+                {
+                    decode_error(decoder, "Unsigned integer doesn't fit in 64 bit signed integer! (value: %)", raw);
+                    return;
+                }
+
+                u64* words = take_words(decoder, 2);
+                if (!words)
+                    return;
+
+                // Sign extend from the encoded size
+                const s64 value = (is_signed && bits < 64) ? ((s64) (raw << (64 - bits)) >> (64 - bits)) : (s64) raw;
+
+                words[0] = tape_word(Slz::Type::INTEGER, 0);
+                words[1] = (u64) value;
+            } break;
+
+            case FLOAT_32:
+            case FLOAT_64:
             {
-                append(bytes, ARRAY_8_BYTE);
-                append_integer(bytes, (u64) array.size());
-            }
-            
-            // encode array data
-            for (u64 i = 0; i < array.size(); i++)
+                const u64 raw = read_sized(decoder);
+
+                u64* words = take_words(decoder, 2);
+                if (!words)
+                    return;
+
+                f64 value;
+                if (type == FLOAT_32)
+                {
+                    const u32 raw32 = (u32) raw;
+                    value = *(const f32*) &raw32;
+                }
+                else
+                {
+                    value = *(const f64*) &raw;
+                }
+
+                words[0] = tape_word(Slz::Type::FLOAT, 0);
+                platform_copy_memory(&words[1], &value, sizeof(value));
+            } break;
+
+            case STRING_REF_1_BYTE:
+            case STRING_REF_2_BYTE:
+            case STRING_REF_4_BYTE:
             {
-                encode_slz_value_to_binary(bytes, array[i]);
-            }
-        } break;
-        
-        case Slz::Type::OBJECT:
-        {
-            append(bytes, OBJECT_START);
+                const u64 id = read_string_ref(decoder);
+                if (decoder.failed)
+                    return;
+
+                u64* words = take_words(decoder, 2);
+                if (!words)
+                    return;
 
-            const Slz::Object object = value.object();
-            const Slz::Document* document = object.document;
-            const Slz::ObjectNode object_node = document->dependency_tree[object.tree_index].object;
+                const String str = get_table_string(decoder, id);
+                words[0] = tape_word(Slz::Type::STRING, str.size);
+                words[1] = (u64) str.data;
+            } break;
 
-            u32 encoded_count = 0;
-            for (u32 i = 0; encoded_count < object_node.filled && i < object_node.capacity; i++)
+            case ARRAY_1_BYTE:
+            case ARRAY_2_BYTE:
+            case ARRAY_4_BYTE:
+            case ARRAY_8_BYTE:
+            case OBJECT_1_BYTE:
+            case OBJECT_2_BYTE:
+            case OBJECT_4_BYTE:
+            case OBJECT_8_BYTE:
             {
-                if (object_node.states[i] == Slz::ObjectNode::State::ALIVE)
+                const bool is_object = (type >= OBJECT_1_BYTE);
+
+                const u64 count = read_sized(decoder);
+                if (decoder.failed)
+                    return;
+
+                // Every value takes at least a byte and every key 2, so bad counts are caught before anything is written
+                if (count > (decoder.size - decoder.offset) / (is_object ? 3 : 1))
                 {
-                    // append_string(bytes, object_node.keys[i]);
-                    Slz::Value property = { document, object_node.values[i] };
-                    encode_slz_value_to_binary(bytes, property);
-                    encoded_count++;
+                    decode_error(decoder, "% has more elements than there is data for! (count: %)", is_object ? "Object" : "Array", count);
+                    return;
                 }
+
+                if (decoder.depth >= MAX_NESTING_DEPTH)
+                {
+                    decode_error(decoder, "Document is nested too deeply! (max depth: %)", MAX_NESTING_DEPTH);
+                    return;
+                }
+
+                const u64 header_words = is_object ? 2 + tape_key_words(count) + tape_offset_words(count) + tape_index_words(count)
+                                                   : 2 + tape_offset_words(count);
+
+                u64* words = take_words(decoder, header_words);
+                if (!words)
+                    return;
+
+                // Padding and empty index slots have to be zero
+                platform_set_memory(words, 0, header_words * sizeof(u64));
+                words[0] = tape_word(is_object ? Slz::Type::OBJECT : Slz::Type::ARRAY, count);
+
+                decoder.depth++;
+
+                const u64* tape = decoder.tape;
+                u32* keys    = is_object ? (u32*) tape_object_keys(tape, start) : nullptr;
+                u32* offsets = is_object ? (u32*) tape_object_offsets(tape, start) : (u32*) tape_array_offsets(tape, start);
+                u32* index   = is_object ? (u32*) tape_object_index(tape, start) : nullptr;
+
+                for (u64 i = 0; i < count && !decoder.failed; i++)
+                {
+                    if (is_object)
+                    {
+                        const u64 id = read_string_ref(decoder);
+                        if (decoder.failed)
+                            break;
+
+                        Atom& key = decoder.key_atoms[id];
+                        if (key == ATOM_NONE)
+                            key = atom_intern(get_table_string(decoder, id));
+
+                        keys[i] = key.id;
+
+                        if (count > TAPE_LINEAR_SEARCH_MAX)
+                            tape_index_insert(index, tape_index_slot_count(count), key, (u32) i);
+                    }
+
+                    offsets[i] = (u32) (decoder.tape_size - start);
+                    decode_value(decoder);
+
+                    if (decoder.tape_size - start > 0xFFFFFFFFui64)
+                    {
+                        decode_error(decoder, "% is too big for the tape! (size in words: %)", is_object ? "Object" : "Array", decoder.tape_size - start);
+                        break;
+                    }
+                }
+
+                decoder.tape[start + 1] = decoder.tape_size - start;
+                decoder.depth--;
+            } break;
+
+            case OBJECT_START:
+            {
+                decode_error(decoder, "Objects without a size are from the first version, which didn't keep keys!");
+            } break;
+
+            case STRING_1_BYTE:
+            case STRING_2_BYTE:
+            case STRING_4_BYTE:
+            case STRING_8_BYTE:
+            case BYTE_ARRAY_1_BYTE:
+            case BYTE_ARRAY_2_BYTE:
+            case BYTE_ARRAY_4_BYTE:
+            case BYTE_ARRAY_8_BYTE:
+            case OBJECT_END:
+            {
+                decode_error(decoder, "Can't decode a % into a document!", get_type_name(type));
+            } break;
+
+            default:
+            {
+                decode_error(decoder, "Invalid type id! (byte value: %)", (u32) type);
+            } break;
+        }
+    }
+
+    static bool read_header(Decoder& decoder, DocumentHeader& out_header)
+    {
+        if (!has_bytes(decoder, sizeof(DocumentHeader)))
+        {
+            decode_error(decoder, "Not enough data for a document header! (size: %)", decoder.size);
+            return false;
+        }
+
+        platform_copy_memory(&out_header, decoder.data, sizeof(DocumentHeader));
+        decoder.offset += sizeof(DocumentHeader);
+
+        if (out_header.magic != DOCUMENT_MAGIC)
+        {
+            decode_error(decoder, "Data isn't a binary document!");
+            return false;
+        }
+
+        if (out_header.version != DOCUMENT_VERSION)
+        {
+            decode_error(decoder, "Unsupported binary document version! (version: %, supported: %)", out_header.version, DOCUMENT_VERSION);
+            return false;
+        }
+
+        const u64 remaining = decoder.size - decoder.offset;
+        if (out_header.string_count > remaining / sizeof(u32) || out_header.string_bytes > remaining - out_header.string_count * sizeof(u32))
+        {
+            decode_error(decoder, "String table is bigger than the data! (string count: %, string bytes: %)", out_header.string_count, out_header.string_bytes);
+            return false;
+        }
+
+        decoder.string_ends  = (const u32*) (decoder.data + decoder.offset);
+        decoder.string_data  = (const char*) (decoder.string_ends + out_header.string_count);
+        decoder.string_count = out_header.string_count;
+
+        u32 previous_end = 0;
+        for (u64 i = 0; i < out_header.string_count; i++)
+        {
+            if (decoder.string_ends[i] < previous_end || decoder.string_ends[i] > out_header.string_bytes)
+            {
+                decode_error(decoder, "String table is corrupted! (string: %, end: %)", i, decoder.string_ends[i]);
+                return false;
             }
 
-            append(bytes, OBJECT_END);
-        } break;
+            previous_end = decoder.string_ends[i];
+        }
+
+        decoder.offset += out_header.string_count * sizeof(u32) + out_header.string_bytes;
+
+        // Every value takes at least a byte, and no byte turns into more than 2 words
+        const u64 value_bytes = decoder.size - decoder.offset;
+        if (out_header.value_count > value_bytes || out_header.tape_words <= Slz::TAPE_ROOT_INDEX || out_header.tape_words > 2 * value_bytes + Slz::TAPE_ROOT_INDEX)
+        {
+            decode_error(decoder, "Header doesn't match the data! (value count: %, tape words: %)", out_header.value_count, out_header.tape_words);
+            return false;
+        }
+
+        return true;
     }
 }
 
 Bytes slz_document_to_binary(const Slz::Document& document)
 {
-    DynamicArray<u8> output = make<DynamicArray<u8>>(1024ui64);
+    using namespace ConversionInternal;
+
+    Encoder encoder = {};
+    encoder.tape_words = Slz::TAPE_ROOT_INDEX;
+    encoder.values     = make<DynamicArray<u8>>(1024ui64);
+    encoder.string_ids = make<HashTable<String, u32>>();
+    encoder.strings    = make<DynamicArray<String>>();
+
+    encode_value(encoder, document.start());
+
+    gn_assert_with_message(encoder.string_bytes <= 0xffffffffui64, "Strings don't fit in a string table! (string bytes: %)", encoder.string_bytes);
+
+    DocumentHeader header = {};
+    header.magic          = DOCUMENT_MAGIC;
+    header.version        = DOCUMENT_VERSION;
+    header.value_count    = encoder.value_count;
+    header.tape_words     = encoder.tape_words;
+    header.string_count   = encoder.strings.size;
+    header.string_bytes   = encoder.string_bytes;
+
+    const u64 total_size = sizeof(header) + encoder.strings.size * sizeof(u32) + encoder.string_bytes + encoder.values.size;
+    DynamicArray<u8> output = make<DynamicArray<u8>>(total_size);
+
+    append_many(output, (const u8*) &header, sizeof(header));
+
+    {   // String table
+        u32 end = 0;
+        for (u64 i = 0; i < encoder.strings.size; i++)
+        {
+            end += (u32) encoder.strings[i].size;
+            append_integer(output, end);
+        }
 
-    encode_slz_value_to_binary(output, document.start());
+        for (u64 i = 0; i < encoder.strings.size; i++)
+            append_many(output, (const u8*) encoder.strings[i].data, encoder.strings[i].size);
+    }
+
+    append_many(output, (const u8*) encoder.values.data, encoder.values.size);
 
-    resize(output, output.size);  // Shrink the array to free extra memory
+    free(encoder.values);
+    free(encoder.string_ids);
+    free(encoder.strings);
 
     return Bytes { output.data, output.size };
 }
 
+bool decode_to_document(const Bytes bytes, Slz::Document& out, Slz::StringStorage string_storage)
+{
+    using namespace ConversionInternal;
+
+    gn_assert_with_message(out.dependency_tree.size == 0 && out.tape.size == 0, "Output Slz::Document struct is not empty! (number of elements: %, tape size: %)", out.dependency_tree.size, out.tape.size);
+
+    Decoder decoder = {};
+    decoder.data = bytes.data;
+    decoder.size = bytes.size;
+
+    DocumentHeader header;
+    if (!read_header(decoder, header))
+        return false;
+
+    // Size is known up front, so the tape is allocated once
+    decoder.tape          = (u64*) arena_allocate(out.arena, header.tape_words * sizeof(u64), alignof(u64));
+    decoder.tape_capacity = header.tape_words;
+
+    // Word 0 is what missing values point to
+    u64* none_word = take_words(decoder, Slz::TAPE_ROOT_INDEX);
+    if (!none_word)
+        return false;
+
+    none_word[0] = Slz::tape_word(Slz::Type::NONE, 0);
+
+    // All the strings are copied at once, values point into the copy
+    if (string_storage == Slz::StringStorage::COPY && header.string_bytes)
+    {
+        char* strings = (char*) arena_allocate(out.arena, header.string_bytes, alignof(char));
+        platform_copy_memory(strings, decoder.string_data, header.string_bytes);
+
+        decoder.string_data = strings;
+    }
+
+    Arena& scratch = get_scratch_arena();
+    const ArenaMarker marker = arena_get_marker(scratch);
+
+    decoder.key_atoms = (Atom*) arena_allocate(scratch, max(header.string_count, 1ui64) * sizeof(Atom), alignof(Atom));
+    platform_set_memory(decoder.key_atoms, 0, header.string_count * sizeof(Atom));
+
+    decode_value(decoder);
+
+    arena_restore(scratch, marker);
+
+    if (!decoder.failed && decoder.offset != decoder.size)
+        decode_error(decoder, "Extra data after the document! (size: %)", decoder.size);
+
+    if (!decoder.failed && (decoder.value_count != header.value_count || decoder.tape_size != header.tape_words))
+        decode_error(decoder, "Document doesn't match the header! (values: % of %, tape words: % of %)", decoder.value_count, header.value_count, decoder.tape_size, header.tape_words);
+
+    if (decoder.failed)
+        return false;
+
+    out.tape.data      = decoder.tape;
+    out.tape.size      = decoder.tape_size;
+    out.tape.capacity  = decoder.tape_size;
+    out.tape.allocator = arena_allocator(out.arena);
+
+    return true;
+}
+
 } // namespace Binary
\ No newline at end of file
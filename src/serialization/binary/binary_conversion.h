@@ -6,6 +6,13 @@
 namespace Binary
 {
 
-Bytes json_document_to_binary(const Slz::Document& document);
+// Encodes the document with a header and a string table (see DocumentHeader), free the bytes when done
+Bytes slz_document_to_binary(const Slz::Document& document);
+
+// Rebuilds a document from bytes made by slz_document_to_binary, returns false and reports
+// the problem if they're not a valid document. The document comes out in the compact layout
+// (like after document_compact). With StringStorage::IN_SOURCE strings point into the bytes,
+// which then have to outlive the document.
+bool decode_to_document(const Bytes bytes, Slz::Document& out, Slz::StringStorage string_storage = Slz::StringStorage::COPY);
 
 } // namespace Binary
\ No newline at end of file
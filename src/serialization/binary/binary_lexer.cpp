@@ -10,7 +10,15 @@
 namespace Binary
 {
 
-static void pretty_print(const Bytes& bytes, u64& offset, u64 indent)
+// String table of a document, empty when printing bytes that don't have a header
+struct StringTable
+{
+    const u32*  ends;
+    const char* data;
+    u64         count;
+};
+
+static void pretty_print(const Bytes& bytes, u64& offset, u64 indent, const StringTable& table)
 {
     constexpr u64 MAX_TAB_COUNT = 128;
     char tab_data[2 * MAX_TAB_COUNT];
@@ -72,6 +80,24 @@ static void pretty_print(const Bytes& bytes, u64& offset, u64 indent)
             print("%: %\n", type_name, get<String>(bytes, offset));
         } break;
 
+        case STRING_REF_1_BYTE:
+        case STRING_REF_2_BYTE:
+        case STRING_REF_4_BYTE:
+        {
+            const char* type_name = get_type_name(bytes[offset]);
+            const u64 id = get_next_uint(bytes, offset);
+
+            if (id < table.count)
+            {
+                const u32 start = (id == 0) ? 0 : table.ends[id - 1];
+                print("%%: % (%)\n", tabs, type_name, id, ref((char*) table.data + start, (u64) (table.ends[id] - start)));
+            }
+            else
+            {
+                print("%%: % (not in string table)\n", tabs, type_name, id);
+            }
+        } break;
+
         case BYTE_ARRAY_1_BYTE:
         case BYTE_ARRAY_2_BYTE:
         case BYTE_ARRAY_4_BYTE:
@@ -92,7 +118,7 @@ static void pretty_print(const Bytes& bytes, u64& offset, u64 indent)
             print("%array start (size: %):\n", tabs, count);
 
             while (count--)
-                pretty_print(bytes, offset, indent + 1);
+                pretty_print(bytes, offset, indent + 1, table);
 
             print("%array end\n", tabs);
         } break;
@@ -104,12 +130,31 @@ static void pretty_print(const Bytes& bytes, u64& offset, u64 indent)
             print("%object start:\n", tabs);
 
             while (bytes[offset] != OBJECT_END)
-                pretty_print(bytes, offset, indent + 1);
+                pretty_print(bytes, offset, indent + 1, table);
 
             print("%object end\n", tabs);
             offset++;
         } break;
 
+        case OBJECT_1_BYTE:
+        case OBJECT_2_BYTE:
+        case OBJECT_4_BYTE:
+        case OBJECT_8_BYTE:
+        {
+            u64 count = get_next_uint(bytes, offset);
+
+            print("%object start (size: %):\n", tabs, count);
+
+            // Key then value
+            while (count--)
+            {
+                pretty_print(bytes, offset, indent + 1, table);
+                pretty_print(bytes, offset, indent + 2, table);
+            }
+
+            print("%object end\n", tabs);
+        } break;
+
         default:
         {
             print("Error byte! (byte: %, offset: %)\n", bytes[offset], offset);
@@ -121,8 +166,25 @@ static void pretty_print(const Bytes& bytes, u64& offset, u64 indent)
 void pretty_print(const Bytes& bytes)
 {
     print("file start:\n");
+
     u64 offset = 0;
-    pretty_print(bytes, offset, 1);
+    StringTable table = {};
+
+    DocumentHeader header;
+    if (bytes.size >= sizeof(header) && *(const u32*) bytes.data == DOCUMENT_MAGIC)
+    {
+        platform_copy_memory(&header, bytes.data, sizeof(header));
+        print("  document (version: %, values: %, tape words: %, strings: %, string bytes: %)\n",
+              header.version, header.value_count, header.tape_words, header.string_count, header.string_bytes);
+
+        table.ends  = (const u32*) (bytes.data + sizeof(header));
+        table.data  = (const char*) (table.ends + header.string_count);
+        table.count = header.string_count;
+
+        offset = sizeof(header) + header.string_count * sizeof(u32) + header.string_bytes;
+    }
+
+    pretty_print(bytes, offset, 1, table);
     print("file end\n");
 }
 
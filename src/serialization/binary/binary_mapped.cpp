@@ -0,0 +1,403 @@
+#include "binary_mapped.h"
+
+#include "core/types.h"
+#include "core/logger.h"
+#include "core/atom.h"
+#include "core/bit_utils.h"
+#include "containers/darray.h"
+#include "containers/bytes.h"
+#include "containers/string.h"
+#include "containers/hash_table.h"
+#include "containers/hash_functions.h"
+#include "platform/platform.h"
+#include "serialization/slz.h"
+
+namespace Binary
+{
+
+namespace MappedInternal
+{
+    constexpr u64 MIN_KEY_INDEX_SLOTS = 16;
+
+    struct Baker
+    {
+        DynamicArray<u64> tape;
+
+        // Key ids start at 1, the key with id n is keys[n - 1]
+        HashTable<Atom, u32> key_ids;
+        DynamicArray<String> keys;
+        u64 key_bytes;
+
+        // Equal strings share their data
+        HashTable<String, u64> string_offsets;
+        DynamicArray<char>     strings;
+    };
+
+    // Words are zeroed, so padding and empty index slots are already there. Returns where they start,
+    // pointers into the tape don't survive the next call.
+    static u64 take_words(Baker& baker, u64 count)
+    {
+        const u64 start = baker.tape.size;
+        if (start + count > baker.tape.capacity)
+            resize(baker.tape, max(2 * baker.tape.capacity, start + count));
+
+        platform_set_memory(baker.tape.data + start, 0, count * sizeof(u64));
+        baker.tape.size += count;
+
+        return start;
+    }
+
+    static u32 get_key_id(Baker& baker, Atom key)
+    {
+        auto element = find(baker.key_ids, key);
+        if (element)
+            return element.value();
+
+        const String str = atom_get_string(key);
+        append(baker.keys, str);
+        baker.key_bytes += str.size;
+
+        const u32 id = (u32) baker.keys.size;
+        put(baker.key_ids, key, id);
+
+        return id;
+    }
+
+    static u64 get_string_offset(Baker& baker, const String str)
+    {
+        auto element = find(baker.string_offsets, str);
+        if (element)
+            return element.value();
+
+        const u64 offset = baker.strings.size;
+        append_many(baker.strings, str.data, str.size);
+        put(baker.string_offsets, str, offset);
+
+        return offset;
+    }
+
+    static inline u32 get_key_slot(const String key, u32 mask)
+    {
+        return Hashing::fold_to_u32(Hashing::hash_bytes(key.data, key.size)) & mask;
+    }
+
+    static void bake_value(Baker& baker, const Slz::Value value)
+    {
+        using namespace Slz;
+
+        const u64 start = baker.tape.size;
+
+        switch (value.type())
+        {
+            case Slz::Type::NONE:
+            {
+                take_words(baker, 1);
+                baker.tape[start] = tape_word(Slz::Type::NONE, 0);
+            } break;
+
+            case Slz::Type::BOOLEAN:
+            {
+                take_words(baker, 1);
+                baker.tape[start] = tape_word(Slz::Type::BOOLEAN, value.boolean());
+            } break;
+
+            case Slz::Type::INTEGER:
+            {
+                take_words(baker, 2);
+                baker.tape[start]     = tape_word(Slz::Type::INTEGER, 0);
+                baker.tape[start + 1] = (u64) value.int64();
+            } break;
+
+            case Slz::Type::FLOAT:
+            {
+                const f64 float_value = value.float64();
+
+                take_words(baker, 2);
+                baker.tape[start] = tape_word(Slz::Type::FLOAT, 0);
+                platform_copy_memory(&baker.tape[start + 1], &float_value, sizeof(float_value));
+            } break;
+
+            case Slz::Type::STRING:
+            {
+                const String str = value.string();
+                const u64 offset = get_string_offset(baker, str);
+
+                take_words(baker, 2);
+                baker.tape[start]     = tape_word(Slz::Type::STRING, str.size);
+                baker.tape[start + 1] = offset;
+            } break;
+
+            case Slz::Type::ARRAY:
+            {
+                const Array array = value.array();
+                const u64 count = array.size();
+
+                take_words(baker, 2 + tape_offset_words(count));
+                baker.tape[start] = tape_word(Slz::Type::ARRAY, count);
+
+                for (u64 i = 0; i < count; i++)
+                {
+                    ((u32*) tape_array_offsets(baker.tape.data, start))[i] = (u32) (baker.tape.size - start);
+                    bake_value(baker, array[i]);
+                }
+
+                baker.tape[start + 1] = baker.tape.size - start;
+            } break;
+
+            case Slz::Type::OBJECT:
+            {
+                const Object object = value.object();
+                const u32 count = object.filled();
+                const u32 slot_count = tape_index_slot_count(count);
+
+                take_words(baker, 2 + tape_key_words(count) + tape_offset_words(count) + tape_index_words(count));
+                baker.tape[start] = tape_word(Slz::Type::OBJECT, count);
+
+                u32 entry = 0;
+                for (u32 i = 0; i < object.capacity(); i++)
+                {
+                    const Atom key = object.key_at(i);
+                    if (key == ATOM_NONE)
+                        continue;
+
+                    // Key ids go where the atoms would, so tape_find works on them as they are
+                    const Atom key_id = Atom { get_key_id(baker, key) };
+                    ((u32*) tape_object_keys(baker.tape.data, start))[entry] = key_id.id;
+
+                    if (slot_count)
+                        tape_index_insert((u32*) tape_object_index(baker.tape.data, start), slot_count, key_id, entry);
+
+                    ((u32*) tape_object_offsets(baker.tape.data, start))[entry] = (u32) (baker.tape.size - start);
+                    bake_value(baker, object.value_at(i));
+
+                    entry++;
+                }
+
+                baker.tape[start + 1] = baker.tape.size - start;
+            } break;
+        }
+
+        gn_assert_with_message(baker.tape.size - start <= 0xFFFFFFFFui64, "Value is too big for the tape! (size in words: %)", baker.tape.size - start);
+    }
+
+    static inline bool section_fits(u64 offset, u64 size, u64 file_size)
+    {
+        return offset <= file_size && size <= file_size - offset;
+    }
+}
+
+MappedValue MappedDocument::start() const
+{
+    return MappedValue { this, Slz::TAPE_ROOT_INDEX };
+}
+
+MappedValue MappedValue::operator[](u64 element) const
+{
+    gn_assert_with_message(type() == Slz::Type::ARRAY, "Value doesn't correspond to a ARRAY resource! (actual node type: %)", Slz::get_type_name(type()));
+
+    const u64 count = size();
+    gn_assert_with_message(element < count, "Index out of bounds! (index: %, array size: %)", element, count);
+
+    return MappedValue { document, index + Slz::tape_array_offsets(document->tape, index)[element] };
+}
+
+// Returns null if key isn't found
+MappedValue MappedValue::operator[](const MappedKey key) const
+{
+    gn_assert_with_message(type() == Slz::Type::OBJECT, "Value doesn't correspond to a OBJECT resource! (actual node type: %)", Slz::get_type_name(type()));
+
+    if (key.id == 0)
+        return MappedValue { document, 0 };
+
+    return MappedValue { document, Slz::tape_find(document->tape, index, Atom { key.id }) };
+}
+
+// Returns null if key isn't found
+MappedValue MappedValue::operator[](const String& key) const
+{
+    return (*this)[mapped_find_key(*document, key)];
+}
+
+String MappedValue::key_at(u32 entry) const
+{
+    gn_assert_with_message(type() == Slz::Type::OBJECT, "Value doesn't correspond to a OBJECT resource! (actual node type: %)", Slz::get_type_name(type()));
+    gn_assert_with_message(entry < size(), "Entry out of bounds! (entry: %, object size: %)", entry, size());
+
+    const u32 id = Slz::tape_object_keys(document->tape, index)[entry];
+
+    const u32 start = (id == 1) ? 0 : document->key_ends[id - 2];
+    return ref((char*) document->key_data + start, (u64) (document->key_ends[id - 1] - start));
+}
+
+MappedValue MappedValue::value_at(u32 entry) const
+{
+    gn_assert_with_message(type() == Slz::Type::OBJECT, "Value doesn't correspond to a OBJECT resource! (actual node type: %)", Slz::get_type_name(type()));
+    gn_assert_with_message(entry < size(), "Entry out of bounds! (entry: %, object size: %)", entry, size());
+
+    return MappedValue { document, index + Slz::tape_object_offsets(document->tape, index)[entry] };
+}
+
+Bytes slz_document_to_mapped(const Slz::Document& document)
+{
+    using namespace MappedInternal;
+
+    Baker baker = {};
+    baker.tape           = make<DynamicArray<u64>>(1024ui64);
+    baker.key_ids        = make<HashTable<Atom, u32>>();
+    baker.keys           = make<DynamicArray<String>>();
+    baker.string_offsets = make<HashTable<String, u64>>();
+    baker.strings        = make<DynamicArray<char>>(1024ui64);
+
+    // Word 0 is what missing values point to
+    take_words(baker, Slz::TAPE_ROOT_INDEX);
+    baker.tape[0] = Slz::tape_word(Slz::Type::NONE, 0);
+
+    bake_value(baker, document.start());
+
+    gn_assert_with_message(baker.key_bytes <= 0xffffffffui64, "Keys don't fit in a key table! (key bytes: %)", baker.key_bytes);
+
+    const u64 key_index_slots = max(next_power_of_2(2 * baker.keys.size), MIN_KEY_INDEX_SLOTS);
+
+    // Every section is a multiple of 4 bytes up to the key data, so the u32 sections stay aligned
+    MappedHeader header = {};
+    header.magic            = MAPPED_MAGIC;
+    header.version          = MAPPED_VERSION;
+    header.tape_offset      = sizeof(header);
+    header.tape_words       = baker.tape.size;
+    header.key_count        = baker.keys.size;
+    header.key_index_offset = header.tape_offset + header.tape_words * sizeof(u64);
+    header.key_index_slots  = key_index_slots;
+    header.key_ends_offset  = header.key_index_offset + key_index_slots * sizeof(u32);
+    header.key_data_offset  = header.key_ends_offset + header.key_count * sizeof(u32);
+    header.key_data_bytes   = baker.key_bytes;
+    header.string_offset    = header.key_data_offset + header.key_data_bytes;
+    header.string_bytes     = baker.strings.size;
+
+    const u64 total_size = header.string_offset + header.string_bytes;
+    u8* output = (u8*) platform_allocate(total_size);
+
+    platform_copy_memory(output, &header, sizeof(header));
+    platform_copy_memory(output + header.tape_offset, baker.tape.data, header.tape_words * sizeof(u64));
+
+    {   // Key table
+        u32* key_index = (u32*) (output + header.key_index_offset);
+        u32* key_ends  = (u32*) (output + header.key_ends_offset);
+        char* key_data = (char*) (output + header.key_data_offset);
+
+        platform_set_memory(key_index, 0, key_index_slots * sizeof(u32));
+
+        const u32 mask = (u32) key_index_slots - 1;
+
+        u32 end = 0;
+        for (u64 i = 0; i < baker.keys.size; i++)
+        {
+            const String key = baker.keys[i];
+
+            platform_copy_memory(key_data + end, key.data, key.size);
+            end += (u32) key.size;
+            key_ends[i] = end;
+
+            u32 slot = get_key_slot(key, mask);
+            while (key_index[slot] != 0)
+                slot = (slot + 1) & mask;
+
+            key_index[slot] = (u32) i + 1;
+        }
+    }
+
+    platform_copy_memory(output + header.string_offset, baker.strings.data, header.string_bytes);
+
+    free(baker.tape);
+    free(baker.key_ids);
+    free(baker.keys);
+    free(baker.string_offsets);
+    free(baker.strings);
+
+    return Bytes { output, total_size };
+}
+
+bool mapped_document_open(const Bytes bytes, MappedDocument& out)
+{
+    using namespace MappedInternal;
+
+    if (bytes.size < sizeof(MappedHeader))
+    {
+        print_error("Mapped Error: File is too small for a header! (size: %)\n", bytes.size);
+        return false;
+    }
+
+    if ((u64) bytes.data % alignof(u64) != 0)
+    {
+        print_error("Mapped Error: Data has to be aligned to 8 bytes!\n");
+        return false;
+    }
+
+    const MappedHeader& header = *(const MappedHeader*) bytes.data;
+
+    if (header.magic != MAPPED_MAGIC)
+    {
+        print_error("Mapped Error: Not a mapped Slz document! (magic: %)\n", header.magic);
+        return false;
+    }
+
+    if (header.version != MAPPED_VERSION)
+    {
+        print_error("Mapped Error: Unsupported version! (version: %, expected: %)\n", header.version, MAPPED_VERSION);
+        return false;
+    }
+
+    // Counts are checked before they're multiplied, so the products can't wrap
+    const bool valid_sizes = header.tape_words > Slz::TAPE_ROOT_INDEX && header.tape_words <= bytes.size / sizeof(u64) &&
+                             is_power_of_2(header.key_index_slots) && header.key_index_slots >= MIN_KEY_INDEX_SLOTS &&
+                             header.key_index_slots <= bytes.size / sizeof(u32) && header.key_count < header.key_index_slots &&
+                             header.key_data_bytes <= 0xffffffffui64;
+
+    const bool valid_alignment = header.tape_offset % sizeof(u64) == 0 &&
+                                 header.key_index_offset % sizeof(u32) == 0 &&
+                                 header.key_ends_offset % sizeof(u32) == 0;
+
+    if (!valid_sizes || !valid_alignment ||
+        !section_fits(header.tape_offset,      header.tape_words * sizeof(u64),      bytes.size) ||
+        !section_fits(header.key_index_offset, header.key_index_slots * sizeof(u32), bytes.size) ||
+        !section_fits(header.key_ends_offset,  header.key_count * sizeof(u32),       bytes.size) ||
+        !section_fits(header.key_data_offset,  header.key_data_bytes,                bytes.size) ||
+        !section_fits(header.string_offset,    header.string_bytes,                  bytes.size))
+    {
+        print_error("Mapped Error: Header doesn't match the file! (size: %)\n", bytes.size);
+        return false;
+    }
+
+    out = {};
+    out.data           = bytes.data;
+    out.size           = bytes.size;
+    out.tape           = (const u64*) (bytes.data + header.tape_offset);
+    out.key_index      = (const u32*) (bytes.data + header.key_index_offset);
+    out.key_index_mask = (u32) header.key_index_slots - 1;
+    out.key_ends       = (const u32*) (bytes.data + header.key_ends_offset);
+    out.key_data       = (const char*) (bytes.data + header.key_data_offset);
+    out.key_count      = header.key_count;
+    out.strings        = (const char*) (bytes.data + header.string_offset);
+
+    return true;
+}
+
+MappedKey mapped_find_key(const MappedDocument& document, const String key)
+{
+    using namespace MappedInternal;
+
+    const u32 mask = document.key_index_mask;
+    for (u32 slot = get_key_slot(key, mask); document.key_index[slot] != 0; slot = (slot + 1) & mask)
+    {
+        const u32 id = document.key_index[slot];
+
+        const u32 start = (id == 1) ? 0 : document.key_ends[id - 2];
+        const String candidate = ref((char*) document.key_data + start, (u64) (document.key_ends[id - 1] - start));
+
+        if (candidate == key)
+            return MappedKey { id };
+    }
+
+    return MappedKey { 0 };
+}
+
+} // namespace Binary
\ No newline at end of file
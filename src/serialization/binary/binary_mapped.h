@@ -0,0 +1,156 @@
+#pragma once
+
+#include "core/types.h"
+#include "core/logger.h"
+#include "containers/bytes.h"
+#include "containers/string.h"
+#include "serialization/slz.h"
+
+// Random access layout that's read straight out of a read only memory mapping, nothing is
+// parsed or copied when it's opened and only the pages that are looked at get loaded.
+// Values use the tape layout from slz_tape.h, so arrays find an element through their
+// offset table and objects find a key with a linear scan or their index, but everything
+// that only makes sense in one process is replaced:
+//   - strings store the offset of their data in the string section instead of a pointer
+//   - object keys are ids into the file's key table instead of atoms (0 is never a key)
+// Key strings are turned into ids through the key index, an open addressing table hashed
+// with Hashing::hash_bytes, so looking a key up doesn't intern anything.
+//
+//     [MappedHeader] [tape words] [key index] [key ends] [key data] [string data]
+
+namespace Binary
+{
+
+constexpr u32 MAPPED_MAGIC   = 0x4D5A4C53;    // "SLZM"
+constexpr u32 MAPPED_VERSION = 1;             // Has to change with the tape layout or either hash
+
+struct MappedHeader
+{
+    u32 magic;
+    u32 version;
+
+    // Offsets are in bytes from the start of the file
+    u64 tape_offset;
+    u64 tape_words;
+
+    u64 key_count;
+    u64 key_index_offset;   // u32 key ids, 0 is an empty slot
+    u64 key_index_slots;    // Power of 2
+    u64 key_ends_offset;    // u32 end of each key in the key data
+    u64 key_data_offset;
+    u64 key_data_bytes;
+
+    u64 string_offset;
+    u64 string_bytes;
+};
+
+// Id of a key in one file, 0 if the file doesn't have it. Finding it once and
+// using it for every lookup skips hashing the string each time.
+struct MappedKey
+{
+    u32 id;
+};
+
+struct MappedValue;
+
+struct MappedDocument
+{
+    const u8* data;
+    u64 size;
+
+    const u64*  tape;
+    const u32*  key_index;
+    u32         key_index_mask;
+    const u32*  key_ends;
+    const char* key_data;
+    u64         key_count;
+    const char* strings;
+
+    MappedValue start() const;
+};
+
+struct MappedValue
+{
+    const MappedDocument* document;
+    u64 index;
+
+    Slz::Type type() const
+    {
+        return Slz::tape_type(document->tape[index]);
+    }
+
+    s64 int64() const
+    {
+        const Slz::Type value_type = type();
+        gn_assert_with_message(value_type == Slz::Type::INTEGER,
+                               "Value doesn't correspond to a INTEGER resource! (actual node type: %)",
+                               Slz::get_type_name(value_type));
+
+        return (s64) document->tape[index + 1];
+    }
+
+    // Can cast integer values to float
+    f64 float64() const
+    {
+        const Slz::Type value_type = type();
+        gn_assert_with_message(value_type == Slz::Type::FLOAT || value_type == Slz::Type::INTEGER,
+                               "Value doesn't correspond to a FLOAT or INTEGER resource! (actual node type: %)",
+                               Slz::get_type_name(value_type));
+
+        const u64 bits = document->tape[index + 1];
+        return (value_type == Slz::Type::FLOAT) ? *(const f64*) &bits : (f64) (s64) bits;
+    }
+
+    bool boolean() const
+    {
+        const Slz::Type value_type = type();
+        gn_assert_with_message(value_type == Slz::Type::BOOLEAN,
+                               "Value doesn't correspond to a BOOLEAN resource! (actual node type: %)",
+                               Slz::get_type_name(value_type));
+
+        return Slz::tape_payload(document->tape[index]) != 0;
+    }
+
+    // Points into the mapping
+    String string() const
+    {
+        const Slz::Type value_type = type();
+        gn_assert_with_message(value_type == Slz::Type::STRING,
+                               "Value doesn't correspond to a STRING resource! (actual node type: %)",
+                               Slz::get_type_name(value_type));
+
+        return ref((char*) document->strings + document->tape[index + 1], Slz::tape_payload(document->tape[index]));
+    }
+
+    // Number of elements of an array or keys of an object
+    u64 size() const
+    {
+        const Slz::Type value_type = type();
+        gn_assert_with_message(value_type == Slz::Type::ARRAY || value_type == Slz::Type::OBJECT,
+                               "Value doesn't correspond to a ARRAY or OBJECT resource! (actual node type: %)",
+                               Slz::get_type_name(value_type));
+
+        return Slz::tape_payload(document->tape[index]);
+    }
+
+    MappedValue operator[](u64 element) const;
+
+    // Return null if key isn't found
+    MappedValue operator[](const MappedKey key) const;
+    MappedValue operator[](const String& key) const;
+
+    // For going over every entry of an object, entries go from 0 to size()
+    String      key_at(u32 entry) const;
+    MappedValue value_at(u32 entry) const;
+};
+
+// Bakes the document into the mapped layout, free the bytes when done
+Bytes slz_document_to_mapped(const Slz::Document& document);
+
+// Only checks that the header and the sections it points to fit in the bytes, so opening
+// takes the same time for any size. The bytes have to stay around (mapped) while it's used.
+bool mapped_document_open(const Bytes bytes, MappedDocument& out);
+
+MappedKey mapped_find_key(const MappedDocument& document, const String key);
+
+} // namespace Binary
\ No newline at end of file
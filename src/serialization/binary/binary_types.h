@@ -31,6 +31,11 @@ constexpr u8 STRING_2_BYTE     = type_data_pack(0b100, 0b00, 0b001);
 constexpr u8 STRING_4_BYTE     = type_data_pack(0b100, 0b00, 0b010);
 constexpr u8 STRING_8_BYTE     = type_data_pack(0b100, 0b00, 0b011);
 
+// Index into the string table of a document (see DocumentHeader)
+constexpr u8 STRING_REF_1_BYTE = type_data_pack(0b100, 0b01, 0b000);
+constexpr u8 STRING_REF_2_BYTE = type_data_pack(0b100, 0b01, 0b001);
+constexpr u8 STRING_REF_4_BYTE = type_data_pack(0b100, 0b01, 0b010);
+
 constexpr u8 BYTE_ARRAY_1_BYTE = type_data_pack(0b101, 0b00, 0b000);
 constexpr u8 BYTE_ARRAY_2_BYTE = type_data_pack(0b101, 0b00, 0b001);
 constexpr u8 BYTE_ARRAY_4_BYTE = type_data_pack(0b101, 0b00, 0b010);
@@ -44,8 +49,31 @@ constexpr u8 ARRAY_8_BYTE      = type_data_pack(0b101, 0b01, 0b011);
 constexpr u8 OBJECT_START      = type_data_pack(0b110, 0b00, 0b000);
 constexpr u8 OBJECT_END        = type_data_pack(0b110, 0b01, 0b000);
 
+// Objects with their entry count up front, entries are a key (string ref) followed by the value
+constexpr u8 OBJECT_1_BYTE     = type_data_pack(0b110, 0b10, 0b000);
+constexpr u8 OBJECT_2_BYTE     = type_data_pack(0b110, 0b10, 0b001);
+constexpr u8 OBJECT_4_BYTE     = type_data_pack(0b110, 0b10, 0b010);
+constexpr u8 OBJECT_8_BYTE     = type_data_pack(0b110, 0b10, 0b011);
+
 #undef type_data_pack
 
+// Documents start with this header, followed by the string table and then the root value.
+// The string table is string_count u32 end offsets into the string data, followed by
+// string_bytes of data. Every key and string value is an index into it, so each distinct
+// string is only stored once. Values use the type ids above.
+constexpr u32 DOCUMENT_MAGIC   = 0x425A4C53;  // "SLZB"
+constexpr u32 DOCUMENT_VERSION = 2;           // 1 was the headerless encoding that didn't keep keys
+
+struct DocumentHeader
+{
+    u32 magic;
+    u32 version;
+    u64 value_count;
+    u64 tape_words;         // Size of the decoded document's tape (see slz_tape.h), so it's allocated once
+    u64 string_count;
+    u64 string_bytes;
+};
+
 inline const char* get_type_name(u8 type)
 {
     switch (type)
@@ -72,6 +100,10 @@ inline const char* get_type_name(u8 type)
         case STRING_2_BYTE: return "string with size in 16 bits";
         case STRING_4_BYTE: return "string with size in 32 bits";
         case STRING_8_BYTE: return "string with size in 64 bits";
+
+        case STRING_REF_1_BYTE: return "string table index in 8 bits";
+        case STRING_REF_2_BYTE: return "string table index in 16 bits";
+        case STRING_REF_4_BYTE: return "string table index in 32 bits";
         
         case BYTE_ARRAY_1_BYTE: return "byte array with size in 8 bits";
         case BYTE_ARRAY_2_BYTE: return "byte array with size in 16 bits";
@@ -85,6 +117,11 @@ inline const char* get_type_name(u8 type)
 
         case OBJECT_START : return "start of object";
         case OBJECT_END   : return "end of object";
+
+        case OBJECT_1_BYTE: return "object with size in 8 bits";
+        case OBJECT_2_BYTE: return "object with size in 16 bits";
+        case OBJECT_4_BYTE: return "object with size in 32 bits";
+        case OBJECT_8_BYTE: return "object with size in 64 bits";
     }
 
     gn_assert_with_message(false, "invalid type id! (byte value: %)", (u32) type);
@@ -2,4 +2,5 @@
 
 #include "json/json_lexer.h"
 #include "json/json_parser.h"
+#include "json/json_reader.h"
 #include "slz/slz_document.h"
\ No newline at end of file
@@ -8,11 +8,14 @@
 #include "containers/string.h"
 #include "math/common.h"
 #include "serialization/slz/slz_error.h"
+#include "json_structural_index.h"
 
 namespace Json
 {
 
-bool tokenize(const String content, DynamicArray<Token>& tokens)
+// Walks the content one byte at a time, used when the structural index can't be (malformed
+// content is lexed here so errors get reported at the right place)
+static bool tokenize_bytewise(const String content, DynamicArray<Token>& tokens)
 {
     clear(tokens);
     
@@ -115,6 +118,7 @@ bool tokenize(const String content, DynamicArray<Token>& tokens)
             case '5': case '6': case '7': case '8': case '9':
             {
                 bool encountered_dot = false;   // Floats can't be written like .123, they have to be written as 0.123
+                bool encountered_exponent = false;
                 u64 number_size = 1;
 
                 while (true)
@@ -124,6 +128,18 @@ bool tokenize(const String content, DynamicArray<Token>& tokens)
                     if (index >= content.size)
                         break;
 
+                    // Exponent can have its own sign (1e-5, 2.5E+10)
+                    if ((content[index] == 'e' || content[index] == 'E') && !encountered_exponent)
+                    {
+                        encountered_exponent = true;
+                        number_size++;
+
+                        if (index + 1 < content.size && (content[index + 1] == '-' || content[index + 1] == '+'))
+                            number_size++;
+
+                        continue;
+                    }
+
                     // - is not allowed between numbers (no math allowed!)
                     if (content[index] == '-')
                     {
@@ -151,7 +167,7 @@ bool tokenize(const String content, DynamicArray<Token>& tokens)
                 
                 Token token;
                 token.index = current_index;
-                token.type  = encountered_dot ? Token::Type::FLOAT : Token::Type::INTEGER;
+                token.type  = (encountered_dot || encountered_exponent) ? Token::Type::FLOAT : Token::Type::INTEGER;
                 token.value = get_substring(content, current_index, number_size);
 
                 append(tokens, token);
@@ -196,6 +212,170 @@ bool tokenize(const String content, DynamicArray<Token>& tokens)
         }
     }
 
+    return !encountered_error;
+}
+
+bool lex_scalar(const String content, u64 current_index, Token& out_token)
+{
+    const char* data = content.data;
+    const u64   size = content.size;
+    const char  ch   = data[current_index];
+
+    out_token.index = current_index;
+
+    if (ch == '-' || is_digit(ch))
+    {
+        bool encountered_dot = false;
+        bool encountered_exponent = false;
+        u64 number_size = 1;
+
+        while (true)
+        {
+            const u64 index = current_index + number_size;
+
+            if (index >= size)
+                break;
+
+            if ((data[index] == 'e' || data[index] == 'E') && !encountered_exponent)
+            {
+                encountered_exponent = true;
+                number_size++;
+
+                if (index + 1 < size && (data[index + 1] == '-' || data[index + 1] == '+'))
+                    number_size++;
+
+                continue;
+            }
+
+            if (data[index] == '-')
+                return false;
+
+            if (data[index] == '.')
+            {
+                if (encountered_dot)
+                    return false;
+
+                encountered_dot = true;
+            }
+            else if (!is_digit(data[index]))
+            {
+                break;
+            }
+
+            number_size++;
+        }
+
+        out_token.type  = (encountered_dot || encountered_exponent) ? Token::Type::FLOAT : Token::Type::INTEGER;
+        out_token.value = ref((char*) data + current_index, number_size);
+        return true;
+    }
+
+    if (is_alphabet(ch))
+    {
+        u64 identifier_size = 1;
+        while (current_index + identifier_size < size && is_alphabet(data[current_index + identifier_size]))
+            identifier_size++;
+
+        out_token.type  = Token::Type::IDENTIFIER;
+        out_token.value = ref((char*) data + current_index, identifier_size);
+        return true;
+    }
+
+    return false;
+}
+
+bool ends_scalar_run(char ch)
+{
+    switch (ch)
+    {
+        case ' ': case '\t': case '\r': case '\n': case '\0':
+        case '[': case ']': case '{': case '}': case ':': case ',':
+        case '\"':
+            return true;
+    }
+
+    return false;
+}
+
+// Lexes a run of number/identifier characters starting at a structural position,
+// a run like 12abc is two tokens just like with the byte by byte lexer
+static bool tokenize_scalar_run(const String content, u64 current_index, DynamicArray<Token>& tokens)
+{
+    while (current_index < content.size && !ends_scalar_run(content.data[current_index]))
+    {
+        Token token;
+        if (!lex_scalar(content, current_index, token))
+            return false;
+
+        append(tokens, token);
+        current_index += token.value.size;
+    }
+
+    return true;
+}
+
+// Turns the structural positions into tokens, returns false if the byte by byte lexer needs to take over
+static bool tokenize_from_positions(const String content, const DynamicArray<u32>& positions, DynamicArray<Token>& tokens)
+{
+    clear(tokens);
+
+    if (tokens.capacity < positions.size)
+        resize(tokens, max(2ui64, positions.size));
+
+    for (u64 i = 0; i < positions.size; i++)
+    {
+        const u64 position = positions.data[i];
+
+        Token token;
+        switch (content.data[position])
+        {
+            case (char) Token::Type::BRACKET_OPEN:
+            case (char) Token::Type::BRACKET_CLOSE:
+            case (char) Token::Type::BRACE_OPEN:
+            case (char) Token::Type::BRACE_CLOSE:
+            case (char) Token::Type::COLON:
+            case (char) Token::Type::COMMA:
+            {
+                token.index = position;
+                token.type  = (Token::Type) content.data[position];
+                token.value = ref(content.data + position, 1ui64);
+
+                append(tokens, token);
+            } break;
+
+            // Closing quote is always the next position since nothing inside strings is indexed
+            case '\"':
+            {
+                const u64 closing = positions.data[++i];
+
+                token.index = position + 1;
+                token.type  = Token::Type::STRING;
+                token.value = ref(content.data + position + 1, closing - position - 1);
+
+                append(tokens, token);
+            } break;
+
+            default:
+            {
+                if (!tokenize_scalar_run(content, position, tokens))
+                    return false;
+            } break;
+        }
+    }
+
+    return true;
+}
+
+bool tokenize(const String content, DynamicArray<Token>& tokens)
+{
+    DynamicArray<u32> positions = make<DynamicArray<u32>>(max(16ui64, content.size / 4));
+
+    bool success = find_structural_positions(content, positions) && tokenize_from_positions(content, positions, tokens);
+    if (!success)
+        success = tokenize_bytewise(content, tokens);
+
+    free(positions);
+
     #ifdef GN_LOG_SERIALIZATION
         print("LEXER OUTPUT (token count: %)\n", tokens.size);
 
@@ -203,7 +383,7 @@ bool tokenize(const String content, DynamicArray<Token>& tokens)
             print("    type_id: %, value: '%'\n", (int) tokens[i].type, tokens[i].value);
     #endif // GN_LOG_SERIALIZATION
 
-    return !encountered_error;
+    return success;
 }
 
 } // namespace Json
\ No newline at end of file
@@ -33,4 +33,11 @@ struct Token
 
 bool tokenize(const String content, DynamicArray<Token>& tokens);
 
+// Lexes the number or identifier that starts at the index with the same rules as tokenize.
+// Returns false for anything tokenize would report as an error.
+bool lex_scalar(const String content, u64 index, Token& out_token);
+
+// Whitespace, punctuation and quotes end a run of number/identifier characters
+bool ends_scalar_run(char ch);
+
 } // namespace Json
\ No newline at end of file
@@ -3,20 +3,31 @@
 #define SLZ_ERROR_PREFIX "Json"
 
 #include "core/types.h"
+#include "core/allocator.h"
+#include "core/atom.h"
 #include "core/logger.h"
+#include "core/number_conversion.h"
 #include "serialization/slz/slz_debug_output.h"
 #include "serialization/slz/slz_error.h"
 #include "serialization/slz.h"
 #include "json_lexer.h"
+#include "json_structural_index.h"
 
 namespace Json
 {
 
+// Nesting past this is reported as an error instead of recursing deeper
+constexpr u32 MAX_NESTING_DEPTH = 1024;
+
 struct ParserContext
 {
     String content;
     u64 current_index;
+    u32 depth;
+    Slz::StringStorage string_storage;
+    Allocator* allocator;   // Document's arena, for arrays and objects
     bool encountered_error;
+    bool nested_too_deep;   // Stops every level from also reporting that it wasn't closed
 };
 
 static inline bool is_token_a_value(const ParserContext& context, const Token& token)
@@ -44,44 +55,63 @@ static inline bool is_token_a_value(const ParserContext& context, const Token& t
     return false;
 }
 
-static String copy_and_escape(const Token& source_token, ParserContext& context)
+static void report_bad_escape(const String source, u64 backslash, u64 source_index, ParserContext& context)
 {
-    DynamicArray<char> result = make<DynamicArray<char>>(source_token.value.size);
+    // Lexer makes sure a backslash is never the last character of a string
+    log_error(context.content, source_index, "Unexpected escape character! (character: '\\%')", source.data[backslash + 1]);
+    context.encountered_error = true;
+}
 
-    for (u64 i = 0; i < source_token.value.size; i++)
-    {
-        char ch = source_token.value[i];
+// Escaped string lives in the scratch arena, free it with arena_free when done
+static String escape_to_scratch(const String source, u64 source_index, ParserContext& context)
+{
+    // Escaped string can only be shorter than the source
+    Arena& scratch = get_scratch_arena();
+    char* buffer = (char*) arena_allocate(scratch, source.size, alignof(char));
 
-        if (ch == '\\')
-        {
-            i++;
-            switch (source_token.value[i])
-            {
-                case 'b':  ch = '\b'; break;
-                case 'f':  ch = '\f'; break;
-                case 'n':  ch = '\n'; break;
-                case 'r':  ch = '\r'; break;
-                case 't':  ch = '\t'; break;
-                case '\"': ch = '\"'; break;
-                case '\\': ch = '\\'; break;
+    u64 size;
+    if (!Slz::unescape(source, buffer, size))
+        report_bad_escape(source, size, source_index, context);
 
-                default:
-                {
-                    log_error(context.content, source_token.index, "Unexpected escape character! (character: '\\%')", source_token.value[i]);
-                    context.encountered_error = true;
-                } break;
-            }
-        }
+    return ref(buffer, size);
+}
 
-        append(result, ch);
+// Strings without escapes are used as they are (or copied, depending on the storage),
+// the rest are decoded straight into the document's arena
+static String store_string(const String source, u64 source_index, ParserContext& context, Slz::Document& out)
+{
+    if (Slz::find_backslash(source, 0) == source.size)
+    {
+        if (context.string_storage == Slz::StringStorage::IN_SOURCE)
+            return source;
+
+        return document_copy_string(out, source);
     }
 
-    return String { result.data, result.size };
+    char* buffer = (char*) arena_allocate(out.arena, source.size, alignof(char));
+
+    u64 size;
+    if (!Slz::unescape(source, buffer, size))
+        report_bad_escape(source, size, source_index, context);
+
+    // Escapes made it shorter, give back the rest
+    arena_reallocate(out.arena, buffer, source.size, size, alignof(char));
+
+    return ref(buffer, size);
+}
+
+static Atom intern_and_escape(const String source, u64 source_index, ParserContext& context)
+{
+    const String escaped = escape_to_scratch(source, source_index, context);
+    const Atom   result  = atom_intern(escaped);
+    arena_free(get_scratch_arena(), escaped.data);
+
+    return result;
 }
 
 static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context, Slz::Document& out)
 {
-    if (context.current_index > tokens.size)
+    if (context.current_index >= tokens.size)
     {
         log_error(context.content, tokens.size - 1, "Json data is incomplete! (Parser ran out of tokens)");
         context.encountered_error = true;
@@ -89,6 +119,19 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
     }
 
     const Token& token = tokens[context.current_index];
+
+    const bool opens_scope = (token.type == Token::Type::BRACKET_OPEN || token.type == Token::Type::BRACE_OPEN);
+    if (opens_scope && context.depth >= MAX_NESTING_DEPTH)
+    {
+        log_error(context.content, token.index, "Json is nested too deeply! (max depth: %)", MAX_NESTING_DEPTH);
+        context.encountered_error = true;
+        context.nested_too_deep = true;
+        context.current_index = tokens.size;
+        return;
+    }
+
+    context.depth += opens_scope;
+
     switch (token.type)
     {
         case Token::Type::STRING:
@@ -99,7 +142,7 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
             append(out.dependency_tree, node);
 
             Slz::Resource res = {};
-            res.string = copy_and_escape(token, context);
+            res.string = store_string(token.value, token.index, context, out);
             append(out.resources, res);
         } break;
 
@@ -108,11 +151,21 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
             Slz::DependencyNode node = {};
             node.index = out.resources.size;
             node.type  = Slz::Type::INTEGER;
-            append(out.dependency_tree, node);
 
-            // TODO: convert string to integer on your own with error checking
             Slz::Resource res = {};
-            res.integer64 = _atoi64(token.value.data);
+            if (!parse_s64(token.value, res.integer64))
+            {
+                // Doesn't fit in 64 bits, keep it as a float
+                node.type = Slz::Type::FLOAT;
+
+                if (!parse_f64(token.value, res.float64))
+                {
+                    log_error(context.content, token.index, "Invalid number! (found: '%')", token.value);
+                    context.encountered_error = true;
+                }
+            }
+
+            append(out.dependency_tree, node);
             append(out.resources, res);
         } break;
 
@@ -123,9 +176,13 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
             node.type  = Slz::Type::FLOAT;
             append(out.dependency_tree, node);
 
-            // TODO: convert string to float on your own with error checking
             Slz::Resource res = {};
-            res.float64 = atof(token.value.data);
+            if (!parse_f64(token.value, res.float64))
+            {
+                log_error(context.content, token.index, "Invalid number! (found: '%')", token.value);
+                context.encountered_error = true;
+            }
+
             append(out.resources, res);
         } break;
 
@@ -170,7 +227,7 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
             u64 array_tree_index = out.dependency_tree.size;
 
             Slz::DependencyNode node = {};
-            node.array = make<Slz::ArrayNode>();
+            node.array = make<Slz::ArrayNode>(context.allocator);
             node.type  = Slz::Type::ARRAY;
             append(out.dependency_tree, node);
 
@@ -193,6 +250,9 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
                 append(out.dependency_tree[array_tree_index].array, out.dependency_tree.size);
                 parse_next(tokens, context, out);
 
+                if (context.nested_too_deep)
+                    break;
+
                 if (context.current_index >= tokens.size)
                 {
                     log_error(context.content, tokens[context.current_index - 1].index, "Array was never closed with a ]!");
@@ -227,7 +287,7 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
             u64 object_tree_index = out.dependency_tree.size;
 
             Slz::DependencyNode node = {};
-            node.object = make<Slz::ObjectNode>();
+            node.object = make<Slz::ObjectNode>(Slz::OBJECT_START_CAPACITY, context.allocator);
             node.type  = Slz::Type::OBJECT;
             append(out.dependency_tree, node);
 
@@ -256,6 +316,13 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
                 }
 
                 context.current_index++;
+                if (context.current_index >= tokens.size)
+                {
+                    log_error(context.content, key_token.index, "Object was never closed with a }!");
+                    context.encountered_error = true;
+                    break;
+                }
+
                 const Token& colon_token = tokens[context.current_index];
 
                 // Key should be followed by a :
@@ -269,12 +336,15 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
                         context.current_index--;
                 }
 
-                String key_string = copy_and_escape(key_token, context);
-                put(out.dependency_tree[object_tree_index].object, key_string, out.dependency_tree.size);
+                const Atom key = intern_and_escape(key_token.value, key_token.index, context);
+                put(out.dependency_tree[object_tree_index].object, key, out.dependency_tree.size);
 
                 context.current_index++;
                 parse_next(tokens, context, out);
 
+                if (context.nested_too_deep)
+                    break;
+
                 if (context.current_index >= tokens.size)
                 {
                     log_error(context.content, tokens[context.current_index - 1].index, "Object was never closed with a }!");
@@ -311,52 +381,66 @@ static void parse_next(const DynamicArray<Token>& tokens, ParserContext& context
         } break;
     }
 
-    context.current_index++;
+    context.depth -= opens_scope;
+
+    // Error recovery can leave the index at the end already, don't step past it
+    if (context.current_index < tokens.size)
+        context.current_index++;
 }
 
-bool parse_tokens(const DynamicArray<Token>& tokens, const String content, Slz::Document& out)
+static void add_null_node(Slz::Document& out)
 {
-    gn_assert_with_message(tokens.data, "Tokens array points to null!");
-    gn_assert_with_message(out.dependency_tree.size == 0, "Output json Slz::Document struct is not empty! (number of elements: %)", out.dependency_tree.size);
+    // If user tries to access an object property that wasn't in the file,
+    // then the value will point to this element
+    append(out.dependency_tree, Slz::DependencyNode {});
+    append(out.resources, Slz::Resource {});
+}
 
-    {   // Add the null element
-        // If user tries to access an object property that wasn't in the file,
-        // then the value will point to this element
-        append(out.dependency_tree, Slz::DependencyNode {});
-        append(out.resources, Slz::Resource {});
-    }
+// Constants for false and true, identifiers point to these
+static void add_boolean_nodes(Slz::Document& out)
+{
+    Slz::DependencyNode node;
+    node.type  = Slz::Type::BOOLEAN;
+
+    Slz::Resource res;
 
-    if (tokens.size == 0)
     {
-        log_error(content, 0, "Tokens array is empty!");
-        return false;
-    }
+        node.index = out.resources.size;
+        res.boolean = false;
 
-    {   // Add constants for true and false
-        Slz::DependencyNode node;
-        node.type  = Slz::Type::BOOLEAN;
+        append(out.dependency_tree, node);
+        append(out.resources, res);
+    }
 
-        Slz::Resource res;
+    {
+        node.index = out.resources.size;
+        res.boolean = true;
 
-        {
-            node.index = out.resources.size;
-            res.boolean = false;
+        append(out.dependency_tree, node);
+        append(out.resources, res);
+    }
+}
 
-            append(out.dependency_tree, node);
-            append(out.resources, res);
-        }
+bool parse_tokens(const DynamicArray<Token>& tokens, const String content, Slz::Document& out, Slz::StringStorage string_storage)
+{
+    gn_assert_with_message(tokens.data, "Tokens array points to null!");
+    gn_assert_with_message(out.dependency_tree.size == 0, "Output json Slz::Document struct is not empty! (number of elements: %)", out.dependency_tree.size);
 
-        {
-            node.index = out.resources.size;
-            res.boolean = true;
+    Allocator* allocator = document_allocator(out);
+    add_null_node(out);
 
-            append(out.dependency_tree, node);
-            append(out.resources, res);
-        }
+    if (tokens.size == 0)
+    {
+        log_error(content, 0, "Tokens array is empty!");
+        return false;
     }
 
+    add_boolean_nodes(out);
+
     ParserContext context = {};
     context.content = content;
+    context.string_storage = string_storage;
+    context.allocator = allocator;
     
     parse_next(tokens, context, out);
 
@@ -374,9 +458,348 @@ bool parse_tokens(const DynamicArray<Token>& tokens, const String content, Slz::
     return !context.encountered_error;
 }
 
-bool parse_string(const String content, Slz::Document& out)
+// Single pass parser that builds the document straight from the structural positions.
+// There's no token array, and nesting is tracked with an explicit stack instead of recursion.
+// It doesn't report errors, it gives up and parse_string runs the token parser to report them.
+namespace FusedInternal
 {
+    struct Scope
+    {
+        Slz::ResourceIndex tree_index;
+        bool is_object;
+    };
+
+    // Returns false for escape sequences the token parser would report
+    static bool check_escapes(const String source, bool& out_has_escapes)
+    {
+        u64 backslash = Slz::find_backslash(source, 0);
+        out_has_escapes = (backslash < source.size);
+
+        while (backslash < source.size)
+        {
+            switch (source.data[backslash + 1])
+            {
+                case 'b': case 'f': case 'n': case 'r': case 't': case '\"': case '\\':
+                    break;
+
+                default:
+                    return false;
+            }
+
+            backslash = Slz::find_backslash(source, backslash + 2);
+        }
+
+        return true;
+    }
+
+    // Content between the quotes at positions[p] and positions[p + 1]
+    static inline bool get_string_content(const String content, const DynamicArray<u32>& positions, u64 p, String& out_source)
+    {
+        if (p + 1 >= positions.size)
+            return false;
+
+        const u32 open  = positions[p];
+        const u32 close = positions[p + 1];
+
+        out_source = ref(content.data + open + 1, (u64) (close - open - 1));
+        return true;
+    }
+
+    static bool parse_string_value(const String content, const DynamicArray<u32>& positions, u64 p, ParserContext& context, Slz::Document& out)
+    {
+        String source;
+        if (!get_string_content(content, positions, p, source))
+            return false;
+
+        bool has_escapes;
+        if (!check_escapes(source, has_escapes))
+            return false;
+
+        Slz::DependencyNode node = {};
+        node.index = out.resources.size;
+        node.type  = Slz::Type::STRING;
+        append(out.dependency_tree, node);
+
+        Slz::Resource res = {};
+        res.string = store_string(source, positions[p], context, out);
+        append(out.resources, res);
+
+        return true;
+    }
+
+    static bool parse_scalar_value(const String content, u32 index, Slz::Document& out)
+    {
+        Token token;
+        if (!lex_scalar(content, index, token))
+            return false;
+
+        // Something like 12abc is two tokens, which can't be valid json
+        const u64 end = index + token.value.size;
+        if (end < content.size && !ends_scalar_run(content.data[end]))
+            return false;
+
+        Slz::DependencyNode node = {};
+        Slz::Resource res = {};
+
+        switch (token.type)
+        {
+            case Token::Type::INTEGER:
+            {
+                node.index = out.resources.size;
+                node.type  = Slz::Type::INTEGER;
+
+                if (!parse_s64(token.value, res.integer64))
+                {
+                    // Doesn't fit in 64 bits, keep it as a float
+                    node.type = Slz::Type::FLOAT;
+
+                    if (!parse_f64(token.value, res.float64))
+                        return false;
+                }
+
+                append(out.resources, res);
+            } break;
+
+            case Token::Type::FLOAT:
+            {
+                node.index = out.resources.size;
+                node.type  = Slz::Type::FLOAT;
+
+                if (!parse_f64(token.value, res.float64))
+                    return false;
+
+                append(out.resources, res);
+            } break;
+
+            default:
+            {
+                // Identifiers point to the constants at the start of the tree
+                if (token.value == ref("null", 4))
+                {
+                    node.type  = Slz::Type::NONE;
+                    node.index = 0;
+                }
+                else if (token.value == ref("false", 5))
+                {
+                    node.type  = Slz::Type::BOOLEAN;
+                    node.index = 1;
+                }
+                else if (token.value == ref("true", 4))
+                {
+                    node.type  = Slz::Type::BOOLEAN;
+                    node.index = 2;
+                }
+                else
+                {
+                    return false;
+                }
+            } break;
+        }
+
+        append(out.dependency_tree, node);
+        return true;
+    }
+
+    // Adds the next element to the innermost scope, for objects that means parsing the key and the :
+    static bool begin_element(const String content, const DynamicArray<u32>& positions, u64& p, const Scope& scope, ParserContext& context, Slz::Document& out)
+    {
+        Slz::DependencyNode& node = out.dependency_tree[scope.tree_index];
+
+        if (!scope.is_object)
+        {
+            append(node.array, out.dependency_tree.size);
+            return true;
+        }
+
+        String source;
+        if (content.data[positions[p]] != '\"' || !get_string_content(content, positions, p, source))
+            return false;
+
+        if (p + 2 >= positions.size || content.data[positions[p + 2]] != ':')
+            return false;
+
+        bool has_escapes;
+        if (!check_escapes(source, has_escapes))
+            return false;
+
+        const Atom key = has_escapes ? intern_and_escape(source, positions[p], context) : atom_intern(source);
+        put(node.object, key, out.dependency_tree.size);
+
+        p += 3;
+        return true;
+    }
+
+    static bool parse_positions(const String content, const DynamicArray<u32>& positions, Slz::StringStorage string_storage, Slz::Document& out)
+    {
+        Allocator* allocator = document_allocator(out);
+        add_null_node(out);
+
+        if (positions.size == 0)
+            return false;
+
+        add_boolean_nodes(out);
+
+        ParserContext context = {};
+        context.content = content;
+        context.string_storage = string_storage;
+        context.allocator = allocator;
+
+        DynamicArray<Scope> stack = make<DynamicArray<Scope>>(16ull, arena_allocator(get_scratch_arena()));
+
+        const char* data = content.data;
+        u64 p = 0;
+
+        while (true)
+        {
+            if (p >= positions.size)
+                return false;
+
+            {   // Parse the value at p
+                const u32 index = positions[p];
+
+                switch (data[index])
+                {
+                    case '\"':
+                    {
+                        if (!parse_string_value(content, positions, p, context, out))
+                            return false;
+
+                        p += 2;
+                    } break;
+
+                    case '[':
+                    case '{':
+                    {
+                        // Same limit as the token parser, so both accept the same documents
+                        if (stack.size >= MAX_NESTING_DEPTH)
+                            return false;
+
+                        Scope scope;
+                        scope.tree_index = out.dependency_tree.size;
+                        scope.is_object  = (data[index] == '{');
+
+                        Slz::DependencyNode node = {};
+                        if (scope.is_object)
+                        {
+                            node.object = make<Slz::ObjectNode>(Slz::OBJECT_START_CAPACITY, context.allocator);
+                            node.type   = Slz::Type::OBJECT;
+                        }
+                        else
+                        {
+                            node.array = make<Slz::ArrayNode>(context.allocator);
+                            node.type  = Slz::Type::ARRAY;
+                        }
+                        append(out.dependency_tree, node);
+
+                        p++;
+
+                        // Empty scopes are closed right away, the rest go on to their first element
+                        const char closing = scope.is_object ? '}' : ']';
+                        if (p < positions.size && data[positions[p]] == closing)
+                        {
+                            p++;
+                            break;
+                        }
+
+                        if (p >= positions.size)
+                            return false;
+
+                        append(stack, scope);
+
+                        if (!begin_element(content, positions, p, scope, context, out))
+                            return false;
+
+                        continue;
+                    }
+
+                    case ']': case '}': case ':': case ',':
+                        return false;
+
+                    default:
+                    {
+                        if (!parse_scalar_value(content, index, out))
+                            return false;
+
+                        p++;
+                    } break;
+                }
+            }
+
+            // Close every scope that ends here, then start the next element of the innermost one
+            while (true)
+            {
+                if (stack.size == 0)
+                    return p == positions.size && !context.encountered_error;
+
+                if (p >= positions.size)
+                    return false;
+
+                const Scope& scope = stack[stack.size - 1];
+                const char closing = scope.is_object ? '}' : ']';
+                const char ch = data[positions[p]];
+
+                if (ch == closing)
+                {
+                    pop(stack);
+                    p++;
+                    continue;
+                }
+
+                if (ch != ',')
+                    return false;
+
+                p++;
+
+                // Trailing commas are allowed
+                if (p < positions.size && data[positions[p]] == closing)
+                {
+                    pop(stack);
+                    p++;
+                    continue;
+                }
+
+                if (p >= positions.size)
+                    return false;
+
+                if (!begin_element(content, positions, p, scope, context, out))
+                    return false;
+
+                break;
+            }
+        }
+    }
+}
+
+bool parse_string(const String content, Slz::Document& out, Slz::StringStorage string_storage)
+{
+    gn_assert_with_message(out.dependency_tree.size == 0, "Output json Slz::Document struct is not empty! (number of elements: %)", out.dependency_tree.size);
+
+    // Positions and tokens are only needed while parsing
+    Arena& scratch = get_scratch_arena();
+    const ArenaMarker marker = arena_get_marker(scratch);
+
+    {   // Fast path, builds the document in one pass without tokens
+        DynamicArray<u32> positions = make<DynamicArray<u32>>(content.size / 4 + 16, arena_allocator(scratch));
+
+        if (find_structural_positions(content, positions) && FusedInternal::parse_positions(content, positions, string_storage, out))
+        {
+            arena_restore(scratch, marker);
+
+            #ifdef GN_LOG_SERIALIZATION
+                Slz::document_debug_output(out);
+            #endif // GN_LOG_SERIALIZATION
+
+            return true;
+        }
+
+        // Something's wrong with the json, start over with the token parser so it gets reported properly
+        arena_restore(scratch, marker);
+        clear(out);
+    }
+
     DynamicArray<Token> tokens = {};
+    tokens.allocator = arena_allocator(scratch);
+
     bool success = tokenize(content, tokens);
 
     if (!success)
@@ -385,13 +808,13 @@ bool parse_string(const String content, Slz::Document& out)
         goto err_lexing;
     }
 
-    success = parse_tokens(tokens, content, out);
+    success = parse_tokens(tokens, content, out, string_storage);
 
     if (!success)
         print_error("Parsing failed!");
 
 err_lexing:
-    free(tokens);
+    arena_restore(scratch, marker);
 
     return success;
 }
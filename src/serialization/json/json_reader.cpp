@@ -0,0 +1,596 @@
+#include "json_reader.h"
+
+#include "core/types.h"
+#include "core/logger.h"
+#include "core/number_conversion.h"
+#include "math/common.h"
+#include "platform/platform.h"
+#include "json_lexer.h"
+#include "json_structural_index.h"
+
+// Same format as log_error, but the whole input isn't around to count lines in
+#define reader_error(reader, index, fmt, ...) { u64 line, col; ReaderInternal::get_line_and_column(reader, index, line, col); print_error("Json Error[%, %]: " fmt "\n", line, col, ##__VA_ARGS__); gn_break_point(); }
+
+namespace Json
+{
+
+namespace ReaderInternal
+{
+    enum State : u8
+    {
+        VALUE,                  // Start of the input or after a :
+        VALUE_OR_ARRAY_END,     // After [ or a , in an array
+        KEY_OR_OBJECT_END,      // After { or a , in an object
+        COLON,                  // After a key
+        COMMA_OR_END,           // After a value inside an array or object
+        SKIPPING,               // Looking for the end of the scope that's being skipped
+        DONE,                   // After the top level value, only whitespace can follow
+    };
+
+    enum struct Scan : u8
+    {
+        FOUND,
+        INCOMPLETE,     // Token might go on in input that hasn't arrived yet
+        ERROR,
+    };
+
+    static inline bool is_whitespace(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == '\0';
+    }
+
+    static void count_lines(Reader& reader, u64 index)
+    {
+        const u64 end = reader.buffer_offset + index;
+
+        for (u64 i = reader.lines_counted_to; i < end; i++)
+        {
+            if (reader.buffer.data[i - reader.buffer_offset] == '\n')
+            {
+                reader.line++;
+                reader.line_start = i + 1;
+            }
+        }
+
+        reader.lines_counted_to = max(reader.lines_counted_to, end);
+    }
+
+    static void get_line_and_column(Reader& reader, u64 index, u64& out_line, u64& out_column)
+    {
+        count_lines(reader, index);
+
+        out_line   = reader.line;
+        out_column = reader.buffer_offset + index - reader.line_start + 1;
+    }
+
+    static Reader::Event fail(Reader& reader)
+    {
+        reader.encountered_error = true;
+        return Reader::Event::ERROR;
+    }
+
+    // Throws away everything before the cursor
+    static void discard_read_input(Reader& reader)
+    {
+        if (reader.cursor == 0)
+            return;
+
+        count_lines(reader, reader.cursor);
+
+        const u64 unread = reader.buffer.size - reader.cursor;
+        platform_move_memory(reader.buffer.data, reader.buffer.data + reader.cursor, unread);
+
+        reader.buffer.size = unread;
+        reader.buffer_offset += reader.cursor;
+        reader.cursor = 0;
+    }
+
+    // Returns false if nothing more can be read right now
+    static bool read_more(Reader& reader)
+    {
+        if (!reader.file || reader.input_finished)
+            return false;
+
+        discard_read_input(reader);
+
+        const u64 size = reader.buffer.size;
+        if (size + reader.chunk_size > reader.buffer.capacity)
+            resize(reader.buffer, max(2 * reader.buffer.capacity, size + reader.chunk_size));
+
+        const u64 read = fread(reader.buffer.data + size, sizeof(char), reader.chunk_size, reader.file);
+        reader.buffer.size += read;
+
+        // Short read means end of file (or an error, which can't be recovered from either)
+        if (read < reader.chunk_size)
+            reader.input_finished = true;
+
+        return true;
+    }
+
+    static inline State state_after_value(const Reader& reader)
+    {
+        return (reader.scopes.size > 0) ? COMMA_OR_END : DONE;
+    }
+
+    static Reader::Event close_scope(Reader& reader)
+    {
+        reader.cursor++;
+        reader.skip_next_value = false;
+
+        const bool is_object = pop(reader.scopes);
+        reader.state = state_after_value(reader);
+
+        return is_object ? Reader::Event::END_OBJECT : Reader::Event::END_ARRAY;
+    }
+
+    // Finds the closing quote of the string that starts at the cursor
+    static Scan scan_string(Reader& reader, u64& out_end)
+    {
+        const char* data = reader.buffer.data;
+        const u64   size = reader.buffer.size;
+
+        // Picks up where the last scan ran out of input
+        u64 i = reader.cursor + 1 + reader.scanned;
+
+        while (i < size)
+        {
+            const char ch = data[i];
+
+            if (ch == '\"')
+            {
+                out_end = i;
+                reader.scanned = 0;
+                return Scan::FOUND;
+            }
+
+            if (ch == '\n')
+            {
+                reader_error(reader, i, "Reached new line before closing string!");
+                return Scan::ERROR;
+            }
+
+            if (ch == '\\')
+            {
+                // Escaped character isn't here yet, start from the backslash next time
+                if (i + 1 >= size)
+                    break;
+
+                i += 2;
+                continue;
+            }
+
+            i++;
+        }
+
+        if (reader.input_finished)
+        {
+            reader_error(reader, reader.cursor, "String was not closed!");
+            return Scan::ERROR;
+        }
+
+        reader.scanned = i - reader.cursor - 1;
+        return Scan::INCOMPLETE;
+    }
+
+    // Finds the end of the number/identifier that starts at the cursor
+    static Scan scan_scalar(Reader& reader, u64& out_end)
+    {
+        const char* data = reader.buffer.data;
+        const u64   size = reader.buffer.size;
+
+        u64 i = reader.cursor + reader.scanned;
+        while (i < size && !ends_scalar_run(data[i]))
+            i++;
+
+        if (i == size && !reader.input_finished)
+        {
+            reader.scanned = i - reader.cursor;
+            return Scan::INCOMPLETE;
+        }
+
+        out_end = i;
+        reader.scanned = 0;
+        return Scan::FOUND;
+    }
+
+    // Points the reader's string at the string between the cursor and end, unescaping it if needed
+    static bool read_string(Reader& reader, u64 end)
+    {
+        char* data = reader.buffer.data;
+        const u64 start = reader.cursor + 1;
+
+        u64 i = start;
+        while (i < end && data[i] != '\\')
+            i++;
+
+        // Nothing to unescape, use the input as is
+        if (i == end)
+        {
+            reader.string = ref(data + start, end - start);
+            return true;
+        }
+
+        clear(reader.unescaped);
+        append_many(reader.unescaped, data + start, i - start);
+
+        for (; i < end; i++)
+        {
+            char ch = data[i];
+
+            if (ch == '\\')
+            {
+                i++;
+                switch (data[i])
+                {
+                    case 'b':  ch = '\b'; break;
+                    case 'f':  ch = '\f'; break;
+                    case 'n':  ch = '\n'; break;
+                    case 'r':  ch = '\r'; break;
+                    case 't':  ch = '\t'; break;
+                    case '\"': ch = '\"'; break;
+                    case '\\': ch = '\\'; break;
+
+                    default:
+                    {
+                        reader_error(reader, i - 1, "Unexpected escape character! (character: '\\%')", data[i]);
+                        return false;
+                    }
+                }
+            }
+
+            append(reader.unescaped, ch);
+        }
+
+        reader.string = ref(reader.unescaped.data, reader.unescaped.size);
+        return true;
+    }
+
+    static bool read_scalar(Reader& reader, u64 end, Reader::Event& out_event)
+    {
+        const String run = ref(reader.buffer.data + reader.cursor, end - reader.cursor);
+
+        Token token;
+        if (!lex_scalar(ref(reader.buffer.data, end), reader.cursor, token) || token.value.size != run.size)
+        {
+            reader_error(reader, reader.cursor, "Encountered invalid token! (found: '%')", run);
+            return false;
+        }
+
+        switch (token.type)
+        {
+            case Token::Type::INTEGER:
+            {
+                out_event = Reader::Event::INTEGER;
+                if (parse_s64(run, reader.integer64))
+                    return true;
+
+                // Doesn't fit in 64 bits, keep it as a float
+                out_event = Reader::Event::FLOAT;
+                if (parse_f64(run, reader.float64))
+                    return true;
+
+                reader_error(reader, reader.cursor, "Invalid number! (found: '%')", run);
+                return false;
+            }
+
+            case Token::Type::FLOAT:
+            {
+                out_event = Reader::Event::FLOAT;
+                if (parse_f64(run, reader.float64))
+                    return true;
+
+                reader_error(reader, reader.cursor, "Invalid number! (found: '%')", run);
+                return false;
+            }
+
+            default:
+            {
+                if (run == ref("null", 4))
+                {
+                    out_event = Reader::Event::NONE;
+                    return true;
+                }
+
+                if (run == ref("true", 4) || run == ref("false", 5))
+                {
+                    out_event = Reader::Event::BOOLEAN;
+                    reader.boolean = (run.size == 4);
+                    return true;
+                }
+
+                reader_error(reader, reader.cursor, "Identifiers can only be true, false, or null! (found: '%')", run);
+                return false;
+            }
+        }
+    }
+}
+
+void reader_feed(Reader& reader, const String chunk)
+{
+    gn_assert_with_message(!reader.file, "Reader gets its input from a file, it can't be fed!");
+    gn_assert_with_message(!reader.input_finished, "Reader was already told that the input is finished!");
+
+    ReaderInternal::discard_read_input(reader);
+    append_many(reader.buffer, chunk.data, chunk.size);
+}
+
+void reader_finish(Reader& reader)
+{
+    reader.input_finished = true;
+}
+
+Reader::Event reader_next(Reader& reader)
+{
+    using namespace ReaderInternal;
+    using Event = Reader::Event;
+
+    while (!reader.encountered_error)
+    {
+        if (reader.state == SKIPPING)
+        {
+            const String unread = ref(reader.buffer.data + reader.cursor, reader.buffer.size - reader.cursor);
+            reader.cursor += skip_to_scope_end(unread, reader.skip_state);
+
+            if (reader.skip_state.depth > 0)
+            {
+                if (read_more(reader))
+                    continue;
+
+                if (!reader.input_finished)
+                    return Event::NEED_INPUT;
+
+                reader_error(reader, reader.cursor, "Json data is incomplete! (Skipped scope was never closed)");
+                return fail(reader);
+            }
+
+            pop(reader.scopes);
+            reader.state = state_after_value(reader);
+            continue;
+        }
+
+        {   // Skip whitespace
+            const char* data = reader.buffer.data;
+            while (reader.cursor < reader.buffer.size && is_whitespace(data[reader.cursor]))
+                reader.cursor++;
+        }
+
+        if (reader.cursor == reader.buffer.size)
+        {
+            if (read_more(reader))
+                continue;
+
+            if (!reader.input_finished)
+                return Event::NEED_INPUT;
+
+            if (reader.state == DONE)
+                return Event::END;
+
+            reader_error(reader, reader.cursor, "Json data is incomplete!");
+            return fail(reader);
+        }
+
+        const char ch = reader.buffer.data[reader.cursor];
+
+        switch (reader.state)
+        {
+            case DONE:
+            {
+                reader_error(reader, reader.cursor, "End of file expected! (found: '%')", ch);
+                return fail(reader);
+            }
+
+            case COLON:
+            {
+                if (ch != ':')
+                {
+                    reader_error(reader, reader.cursor, "Expected : after key in object! (found: '%')", ch);
+                    return fail(reader);
+                }
+
+                reader.cursor++;
+                reader.state = VALUE;
+                continue;
+            }
+
+            case COMMA_OR_END:
+            {
+                const bool in_object = reader.scopes[reader.scopes.size - 1];
+
+                if (ch == (in_object ? '}' : ']'))
+                    return close_scope(reader);
+
+                if (ch != ',')
+                {
+                    if (in_object)
+                    {
+                        reader_error(reader, reader.cursor, "Object properties must be separated by commas! (found: '%')", ch);
+                    }
+                    else
+                    {
+                        reader_error(reader, reader.cursor, "Array items must be separated by commas! (found: '%')", ch);
+                    }
+
+                    return fail(reader);
+                }
+
+                // Trailing commas are allowed, so the scope can still end after this
+                reader.cursor++;
+                reader.state = in_object ? KEY_OR_OBJECT_END : VALUE_OR_ARRAY_END;
+                continue;
+            }
+
+            case KEY_OR_OBJECT_END:
+            {
+                if (ch == '}')
+                    return close_scope(reader);
+
+                if (ch != '\"')
+                {
+                    reader_error(reader, reader.cursor, "Expected a key for object! (found: '%')", ch);
+                    return fail(reader);
+                }
+
+                u64 end;
+                const Scan scan = scan_string(reader, end);
+
+                if (scan == Scan::INCOMPLETE)
+                {
+                    if (read_more(reader))
+                        continue;
+
+                    return Event::NEED_INPUT;
+                }
+
+                if (scan == Scan::ERROR || !read_string(reader, end))
+                    return fail(reader);
+
+                reader.cursor = end + 1;
+                reader.state = COLON;
+                return Event::KEY;
+            }
+
+            case VALUE_OR_ARRAY_END:
+            {
+                if (ch == ']')
+                    return close_scope(reader);
+            } // Fallthrough
+
+            case VALUE:
+            {
+                Event event;
+
+                switch (ch)
+                {
+                    case '[':
+                    case '{':
+                    {
+                        const bool is_object = (ch == '{');
+
+                        reader.cursor++;
+                        append(reader.scopes, is_object);
+
+                        if (reader.skip_next_value)
+                        {
+                            reader.skip_next_value = false;
+                            reader.skip_state = SkipState { 0, 0, 1 };
+                            reader.state = SKIPPING;
+                            continue;
+                        }
+
+                        reader.state = is_object ? KEY_OR_OBJECT_END : VALUE_OR_ARRAY_END;
+                        return is_object ? Event::BEGIN_OBJECT : Event::BEGIN_ARRAY;
+                    }
+
+                    case ']': case '}': case ':': case ',':
+                    {
+                        reader_error(reader, reader.cursor, "Expected a value (identifier, number, string, array, or object), got %", ch);
+                        return fail(reader);
+                    }
+
+                    case '\"':
+                    {
+                        u64 end;
+                        const Scan scan = scan_string(reader, end);
+
+                        if (scan == Scan::INCOMPLETE)
+                        {
+                            if (read_more(reader))
+                                continue;
+
+                            return Event::NEED_INPUT;
+                        }
+
+                        if (scan == Scan::ERROR)
+                            return fail(reader);
+
+                        // Skipped strings don't need to be unescaped
+                        if (!reader.skip_next_value && !read_string(reader, end))
+                            return fail(reader);
+
+                        reader.cursor = end + 1;
+                        event = Event::STRING;
+                    } break;
+
+                    default:
+                    {
+                        u64 end;
+                        const Scan scan = scan_scalar(reader, end);
+
+                        if (scan == Scan::INCOMPLETE)
+                        {
+                            if (read_more(reader))
+                                continue;
+
+                            return Event::NEED_INPUT;
+                        }
+
+                        if (!read_scalar(reader, end, event))
+                            return fail(reader);
+
+                        reader.cursor = end;
+                    } break;
+                }
+
+                reader.state = state_after_value(reader);
+
+                if (reader.skip_next_value)
+                {
+                    reader.skip_next_value = false;
+                    continue;
+                }
+
+                return event;
+            }
+        }
+    }
+
+    return Reader::Event::ERROR;
+}
+
+void reader_skip_value(Reader& reader)
+{
+    using namespace ReaderInternal;
+
+    gn_assert_with_message(reader.state == VALUE || reader.state == VALUE_OR_ARRAY_END || reader.state == COLON,
+                           "Reader isn't at a value, there's nothing to skip!");
+
+    reader.skip_next_value = true;
+}
+
+void reader_skip_scope(Reader& reader)
+{
+    using namespace ReaderInternal;
+
+    gn_assert_with_message(reader.scopes.size > 0, "Reader isn't inside an object or array, there's nothing to skip!");
+    gn_assert_with_message(reader.state != SKIPPING, "Reader is already skipping a scope!");
+
+    reader.skip_next_value = false;
+    reader.skip_state = SkipState { 0, 0, 1 };
+    reader.state = SKIPPING;
+}
+
+} // namespace Json
+
+Json::Reader make(Type<Json::Reader>, FILE* file, u64 chunk_size)
+{
+    Json::Reader reader = {};
+
+    reader.file       = file;
+    reader.chunk_size = chunk_size;
+
+    reader.buffer    = make<DynamicArray<char>>(chunk_size);
+    reader.scopes    = make<DynamicArray<bool>>();
+    reader.unescaped = make<DynamicArray<char>>();
+
+    reader.state = Json::ReaderInternal::VALUE;
+    reader.line  = 1;
+
+    return reader;
+}
+
+void free(Json::Reader& reader)
+{
+    free(reader.buffer);
+    free(reader.scopes);
+    free(reader.unescaped);
+}
\ No newline at end of file
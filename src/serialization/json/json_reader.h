@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "core/types.h"
+#include "containers/darray.h"
+#include "containers/string.h"
+#include "json_structural_index.h"
+
+namespace Json
+{
+
+// Pull parser that hands out json one event at a time instead of building a document.
+// Input comes in pieces, either read from a file by the reader itself or given to it with
+// reader_feed, and only the part that hasn't been read yet is kept. Memory depends on the
+// nesting depth and the longest string/number, not on the size of the input.
+//
+//     Json::Reader reader = make<Json::Reader>(file);
+//     Json::Reader::Event event;
+//     while ((event = Json::reader_next(reader)) != Json::Reader::Event::END) { ... }
+struct Reader
+{
+    enum struct Event : u8
+    {
+        BEGIN_OBJECT,
+        END_OBJECT,
+        BEGIN_ARRAY,
+        END_ARRAY,
+        KEY,            // Key is in string
+        STRING,
+        INTEGER,
+        FLOAT,
+        BOOLEAN,
+        NONE,           // null
+
+        NEED_INPUT,     // Only without a file, call reader_feed or reader_finish and then try again
+        END,            // Input is done and was valid
+        ERROR,          // Already reported, the reader is stuck returning this from here on
+    };
+
+    FILE* file;         // Null if input comes from reader_feed, the reader doesn't close it
+    u64 chunk_size;     // Bytes read from the file at a time
+
+    DynamicArray<char> buffer;  // Unread input starts at the cursor, the rest gets thrown away
+    u64 cursor;
+    u64 scanned;                // How much of the token at the cursor is known not to end it
+    bool input_finished;
+
+    DynamicArray<bool> scopes;  // One per open scope, true for objects
+    u8 state;
+    bool skip_next_value;
+    SkipState skip_state;
+    bool encountered_error;
+
+    // Value of the last event, string is only valid until the next call
+    String string;
+    s64    integer64;
+    f64    float64;
+    bool   boolean;
+
+    DynamicArray<char> unescaped;   // Backing memory for strings that had escapes
+
+    // Only used for error messages
+    u64 buffer_offset;      // Offset of the start of the buffer in the whole input
+    u64 lines_counted_to;   // Offset up to which new lines have been counted
+    u64 line;
+    u64 line_start;         // Offset of the first character of the current line
+};
+
+// Copies the chunk, so it can be reused as soon as this returns
+void reader_feed(Reader& reader, const String chunk);
+
+// There's no more input after what has been fed so far
+void reader_finish(Reader& reader);
+
+Reader::Event reader_next(Reader& reader);
+
+// Skips the value that comes next (an array item or the value after a KEY) without reporting
+// anything in it. Objects and arrays are skipped by only looking for their closing bracket.
+void reader_skip_value(Reader& reader);
+
+// Skips the rest of the innermost open object or array, including its closing bracket.
+// The next event is whatever comes after it.
+void reader_skip_scope(Reader& reader);
+
+} // namespace Json
+
+// Chunk size is a u64, pass it as one (64ull * 1024)
+Json::Reader make(Type<Json::Reader>, FILE* file = nullptr, u64 chunk_size = 64 * 1024);
+void free(Json::Reader& reader);
\ No newline at end of file
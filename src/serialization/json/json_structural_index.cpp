@@ -0,0 +1,301 @@
+#include "json_structural_index.h"
+
+#include <emmintrin.h>
+
+#include "core/types.h"
+#include "core/bit_utils.h"
+#include "containers/darray.h"
+#include "containers/string.h"
+#include "math/common.h"
+#include "platform/platform.h"
+
+#if defined(GN_COMPILER_MSVC) || defined(__PCLMUL__)
+    #include <wmmintrin.h>
+    #define GN_JSON_USE_CLMUL
+#endif
+
+// Stage 1 of the lexer (same idea as simdjson). Every 64 byte block is turned into
+// bitmasks (one bit per byte) and strings are found with bit tricks instead of branches:
+//  - Escaped characters are the ones after an odd length run of backslashes.
+//  - Running xor over the unescaped quotes gives a mask that's set inside strings.
+//  - Whatever is left outside strings is either whitespace, punctuation or part of
+//    a number/identifier, and only the first byte of those runs is a token start.
+// State that crosses blocks (open string, pending escape, scalar run) is carried as bits.
+
+namespace Json
+{
+
+namespace StructuralInternal
+{
+    constexpr u64 BLOCK_SIZE = 64;
+
+    struct BlockMasks
+    {
+        u64 quote;
+        u64 backslash;
+        u64 newline;
+        u64 whitespace;
+        u64 punctuation;
+    };
+
+    struct BlockState
+    {
+        u64 in_string;      // All ones if the previous block ended inside a string
+        u64 escaped;        // 1 if the first byte of this block is escaped
+        u64 scalar;         // 1 if the previous block ended in the middle of a number/identifier
+    };
+
+    static inline u64 equal_mask(__m128i chunk, char ch)
+    {
+        return (u64) (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(ch)));
+    }
+
+    static inline BlockMasks classify(const char* block)
+    {
+        BlockMasks masks = {};
+
+        for (u64 i = 0; i < BLOCK_SIZE / 16; i++)
+        {
+            const __m128i chunk = _mm_loadu_si128((const __m128i*) (block + 16 * i));
+            const u64 shift = 16 * i;
+
+            const u64 newline = equal_mask(chunk, '\n');
+
+            masks.quote       |= equal_mask(chunk, '\"') << shift;
+            masks.backslash   |= equal_mask(chunk, '\\') << shift;
+            masks.newline     |= newline << shift;
+            masks.whitespace  |= (equal_mask(chunk, ' ') | equal_mask(chunk, '\t') | equal_mask(chunk, '\r') | newline | equal_mask(chunk, '\0')) << shift;
+            masks.punctuation |= (equal_mask(chunk, '[') | equal_mask(chunk, ']') | equal_mask(chunk, '{') |
+                                  equal_mask(chunk, '}') | equal_mask(chunk, ':') | equal_mask(chunk, ',')) << shift;
+        }
+
+        return masks;
+    }
+
+    // Running xor from the lowest bit up, bit i is the parity of the bits at or below i
+    static inline u64 prefix_xor(u64 bits)
+    {
+    #ifdef GN_JSON_USE_CLMUL
+        // Carry-less multiplication by all ones does it in one instruction
+        const __m128i result = _mm_clmulepi64_si128(_mm_set_epi64x(0, (s64) bits), _mm_set1_epi8((char) 0xFF), 0);
+        return (u64) _mm_cvtsi128_si64(result);
+    #else
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    #endif
+    }
+
+    // Bits for characters that are escaped by an odd number of backslashes before them
+    static inline u64 find_escaped(u64 backslash, u64& carried_escape)
+    {
+        constexpr u64 EVEN_BITS = 0x5555555555555555ui64;
+
+        // An escaped backslash doesn't escape anything
+        backslash &= ~carried_escape;
+        const u64 follows_escape = (backslash << 1) | carried_escape;
+
+        // Adding the start of each run that begins on an odd bit to the run carries past the
+        // end of it, which tells whether the run has an odd length
+        const u64 odd_sequence_starts = backslash & ~EVEN_BITS & ~follows_escape;
+        const u64 sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+        carried_escape = (sequences_starting_on_even_bits < backslash);
+
+        const u64 invert_mask = sequences_starting_on_even_bits << 1;
+        return (EVEN_BITS ^ invert_mask) & follows_escape;
+    }
+
+    static inline void write_positions(u32* out, u64 base, u64 bits)
+    {
+        while (bits)
+        {
+            *out++ = (u32) (base + count_trailing_zeros(bits));
+            bits &= bits - 1;
+        }
+    }
+
+    struct ScopeMasks
+    {
+        u64 quote;
+        u64 backslash;
+        u64 open;
+        u64 close;
+    };
+
+    // Only what's needed to find where a scope ends
+    static inline ScopeMasks classify_scopes(const char* block)
+    {
+        ScopeMasks masks = {};
+
+        for (u64 i = 0; i < BLOCK_SIZE / 16; i++)
+        {
+            const __m128i chunk = _mm_loadu_si128((const __m128i*) (block + 16 * i));
+            const u64 shift = 16 * i;
+
+            masks.quote     |= equal_mask(chunk, '\"') << shift;
+            masks.backslash |= equal_mask(chunk, '\\') << shift;
+            masks.open      |= (equal_mask(chunk, '[') | equal_mask(chunk, '{')) << shift;
+            masks.close     |= (equal_mask(chunk, ']') | equal_mask(chunk, '}')) << shift;
+        }
+
+        return masks;
+    }
+
+    // Returns false if something in the block needs the byte by byte lexer
+    static inline bool index_block(const char* block, u64 base, BlockState& state, DynamicArray<u32>& positions)
+    {
+        const BlockMasks masks = classify(block);
+
+        const u64 escaped = find_escaped(masks.backslash, state.escaped);
+        const u64 quotes  = masks.quote & ~escaped;
+
+        // Set for the opening quote and the string's content, clear for the closing quote
+        const u64 in_string = prefix_xor(quotes) ^ state.in_string;
+        state.in_string = (u64) ((s64) in_string >> 63);
+
+        // Backslashes outside of strings and unescaped new lines inside them are errors
+        if ((masks.backslash & ~in_string) || (masks.newline & in_string & ~escaped))
+            return false;
+
+        const u64 outside  = ~in_string & ~quotes;
+        const u64 scalars  = outside & ~masks.whitespace & ~masks.punctuation;
+        const u64 scalar_starts = scalars & ~((scalars << 1) | state.scalar);
+        state.scalar = scalars >> 63;
+
+        const u64 starts = (masks.punctuation & outside) | quotes | scalar_starts;
+
+        if (positions.size + BLOCK_SIZE > positions.capacity)
+            resize(positions, max(2 * positions.capacity, positions.size + BLOCK_SIZE));
+
+        write_positions(positions.data + positions.size, base, starts);
+        positions.size += pop_count(starts);
+
+        return true;
+    }
+}
+
+bool find_structural_positions(const String content, DynamicArray<u32>& out_positions)
+{
+    using namespace StructuralInternal;
+
+    clear(out_positions);
+
+    if (content.size > 0xFFFFFFFFui64)
+        return false;
+
+    BlockState state = {};
+
+    u64 offset = 0;
+    for (; offset + BLOCK_SIZE <= content.size; offset += BLOCK_SIZE)
+    {
+        if (!index_block(content.data + offset, offset, state, out_positions))
+            return false;
+    }
+
+    if (offset < content.size)
+    {
+        // Pad the last block with spaces so it doesn't add anything
+        alignas(16) char last_block[BLOCK_SIZE];
+        platform_set_memory(last_block, ' ', BLOCK_SIZE);
+        platform_copy_memory(last_block, content.data + offset, content.size - offset);
+
+        if (!index_block(last_block, offset, state, out_positions))
+            return false;
+    }
+
+    // String was never closed
+    return state.in_string == 0;
+}
+
+u64 skip_to_scope_end(const String content, SkipState& state)
+{
+    using namespace StructuralInternal;
+
+    gn_assert_with_message(state.depth > 0, "Skipping needs at least one open scope!");
+
+    u64 offset = 0;
+    for (; offset + BLOCK_SIZE <= content.size; offset += BLOCK_SIZE)
+    {
+        const ScopeMasks masks = classify_scopes(content.data + offset);
+
+        const u64 escaped = find_escaped(masks.backslash, state.escaped);
+        const u64 quotes  = masks.quote & ~escaped;
+
+        const u64 in_string = prefix_xor(quotes) ^ state.in_string;
+        state.in_string = (u64) ((s64) in_string >> 63);
+
+        const u64 opens  = masks.open  & ~in_string;
+        const u64 closes = masks.close & ~in_string;
+
+        // Can't get back to depth 0 in this block, so the order of the brackets doesn't matter
+        const u64 close_count = pop_count(closes);
+        if (close_count < state.depth)
+        {
+            state.depth = state.depth + pop_count(opens) - close_count;
+            continue;
+        }
+
+        u64 brackets = opens | closes;
+        while (brackets)
+        {
+            const u64 lowest = brackets & (~brackets + 1);
+            state.depth = (opens & lowest) ? state.depth + 1 : state.depth - 1;
+
+            if (state.depth == 0)
+            {
+                // A closing bracket is never in a string or escaped
+                state.in_string = 0;
+                state.escaped   = 0;
+                return offset + count_trailing_zeros(brackets) + 1;
+            }
+
+            brackets &= brackets - 1;
+        }
+    }
+
+    // Rest of the content doesn't fill a block, and padding it would throw off the carried state
+    for (u64 i = offset; i < content.size; i++)
+    {
+        const char ch = content.data[i];
+
+        if (state.escaped)
+        {
+            state.escaped = 0;
+            continue;
+        }
+
+        switch (ch)
+        {
+            case '\\':
+                state.escaped = 1;
+                break;
+
+            case '\"':
+                state.in_string = ~state.in_string;
+                break;
+
+            case '[':
+            case '{':
+                state.depth += !state.in_string;
+                break;
+
+            case ']':
+            case '}':
+            {
+                if (state.in_string)
+                    break;
+
+                if (--state.depth == 0)
+                    return i + 1;
+            } break;
+        }
+    }
+
+    return content.size;
+}
+
+} // namespace Json
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "core/types.h"
+#include "containers/darray.h"
+#include "containers/string.h"
+
+namespace Json
+{
+
+// Finds the position of every token start in the content 64 bytes at a time:
+// punctuation, both quotes of every string and the first character of every run of
+// number/identifier characters. Nothing inside strings is indexed.
+// Returns false if the content needs the byte by byte lexer, either because it's malformed
+// (unclosed string, new line in a string, backslash outside a string) or too big for u32 positions.
+bool find_structural_positions(const String content, DynamicArray<u32>& out_positions);
+
+// Carried between calls to skip_to_scope_end when the input comes in pieces
+struct SkipState
+{
+    u64 in_string;  // All ones while inside a string
+    u64 escaped;    // 1 if the next byte is escaped
+    u64 depth;      // Scopes that are still open, skipping is done when this gets to 0
+};
+
+// Skips over everything up to and including the ] or } that closes the outermost of the
+// state's open scopes, brackets inside strings don't count. Nothing is validated or kept.
+// Returns the index right after the closing bracket, or content.size if the content
+// ran out first, in which case the state picks up from there with the next piece.
+u64 skip_to_scope_end(const String content, SkipState& state);
+
+} // namespace Json
\ No newline at end of file
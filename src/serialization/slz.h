@@ -1,4 +1,7 @@
 #pragma once
 
 #include "slz/slz_types.h"
-#include "slz/slz_document.h"
\ No newline at end of file
+#include "slz/slz_document.h"
+#include "slz/slz_strings.h"
+#include "slz/slz_tape.h"
+#include "slz/slz_schema.h"
\ No newline at end of file
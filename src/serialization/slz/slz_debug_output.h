@@ -62,7 +62,7 @@ static u64 print_node_info(const Document& document, u64 index, u64 indent)
 
             for (u64 i = 0; i < node.object.capacity; i++)
             {
-                if (node.object.states[i] == ObjectNode::State::ALIVE)
+                if (is_alive(node.object, i))
                 {
                     print("%%:\n", ref(spaces, indent + 2), node.object.keys[i]);
                     index = print_node_info(document, node.object.values[i], indent + 4);
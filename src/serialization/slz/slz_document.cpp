@@ -11,11 +11,20 @@ namespace Slz
 
 Value Document::start() const
 {
-    return Value { this, 3 };
+    // Tree starts with the null and boolean constants
+    return Value { this, tape.size ? TAPE_ROOT_INDEX : 3 };
 }
 
 Value Array::operator[](u64 index) const
 {
+    if (document->tape.size)
+    {
+        const u64 count = tape_payload(document->tape[tree_index]);
+        gn_assert_with_message(index < count, "Index out of bounds! (index: %, array size: %)", index, count);
+
+        return Value { document, tree_index + tape_array_offsets(document->tape.data, tree_index)[index] };
+    }
+
     const auto& node = document->dependency_tree[tree_index];
     return Value { document, node.array[index] };
 }
@@ -23,7 +32,21 @@ Value Array::operator[](u64 index) const
 // Returns null if key isn't found
 Value Object::operator[](const String& key) const
 {
-    DependencyNode node = document->dependency_tree[tree_index];
+    // Key can't be in any object if it was never interned
+    Atom atom;
+    if (!atom_find(key, atom))
+        return Value { document, 0 };
+
+    return (*this)[atom];
+}
+
+// Returns null if key isn't found
+Value Object::operator[](const Atom key) const
+{
+    if (document->tape.size)
+        return Value { document, tape_find(document->tape.data, tree_index, key) };
+
+    const DependencyNode& node = document->dependency_tree[tree_index];
     auto elem = find(node.object, key);
 
     // Return null if element was not found
@@ -33,4 +56,26 @@ Value Object::operator[](const String& key) const
     return Value { document, elem.value() };
 }
 
+Atom Object::key_at(u32 slot) const
+{
+    gn_assert_with_message(slot < capacity(), "Slot out of bounds! (slot: %, capacity: %)", slot, capacity());
+
+    if (document->tape.size)
+        return Atom { tape_object_keys(document->tape.data, tree_index)[slot] };
+
+    const DependencyNode& node = document->dependency_tree[tree_index];
+    return is_alive(node.object, slot) ? node.object.keys[slot] : ATOM_NONE;
+}
+
+Value Object::value_at(u32 slot) const
+{
+    gn_assert_with_message(slot < capacity(), "Slot out of bounds! (slot: %, capacity: %)", slot, capacity());
+
+    if (document->tape.size)
+        return Value { document, tree_index + tape_object_offsets(document->tape.data, tree_index)[slot] };
+
+    const DependencyNode& node = document->dependency_tree[tree_index];
+    return Value { document, is_alive(node.object, slot) ? node.object.values[slot] : 0 };
+}
+
 } // namespace Slz
\ No newline at end of file
@@ -2,17 +2,27 @@
 
 #include "core/types.h"
 #include "core/logger.h"
+#include "core/allocator.h"
+#include "core/bit_utils.h"
+#include "core/atom.h"
 #include "containers/darray.h"
+#include "containers/segmented_array.h"
+#include "containers/small_array.h"
 #include "containers/string.h"
 #include "containers/hash_table.h"
 #include "slz_types.h"
+#include "slz_tape.h"
 
 namespace Slz
 {
 
 using ResourceIndex = u64;
-using ArrayNode = DynamicArray<ResourceIndex>;
-using ObjectNode = HashTable<String, ResourceIndex>;
+using ArrayNode = SmallArray<ResourceIndex, 4>;    // Most arrays are tiny (bounds, pairs), so they skip the heap
+using ObjectNode = HashTable<Atom, ResourceIndex>;   // Keys are interned
+
+// Most objects only have a few keys, and the table an object grew out of stays in the
+// document's arena until the document is freed, so they start small
+constexpr u32 OBJECT_START_CAPACITY = HashTableInternal::MIN_CAPACITY;
 
 union Resource
 {
@@ -40,12 +50,25 @@ struct Value;
 
 struct Document
 {
-    DynamicArray<DependencyNode> dependency_tree;
-    DynamicArray<Resource>       resources;
+    // Nodes never move, so parsers can hold on to a node while adding its children
+    SegmentedArray<DependencyNode> dependency_tree;
+    SegmentedArray<Resource>       resources;
+
+    // Compact layout (see slz_tape.h) made by document_compact or Binary::decode_to_document.
+    // When this isn't empty the tree is, and values index into this instead.
+    DynamicArray<u64> tape;
+
+    // Everything the document owns (node chunks, arrays, objects and strings) lives here,
+    // so freeing it only releases the arena's blocks instead of walking every node.
+    // Strings parsed with StringStorage::IN_SOURCE can also point into the source instead.
+    Arena arena;
 
     Value start() const;
 };
 
+// Values, arrays and objects work the same with both layouts, tree_index is
+// the index of the value's first word in the tape for compacted documents
+
 struct Array
 {
     const Document* document;
@@ -53,6 +76,9 @@ struct Array
     
     u64 size() const
     {
+        if (document->tape.size)
+            return tape_payload(document->tape[tree_index]);
+
         const auto& node = document->dependency_tree[tree_index];
         return node.array.size;
     }
@@ -67,18 +93,30 @@ struct Object
 
     // Returns null if key isn't found
     Value operator[](const String& key) const;
+    Value operator[](const Atom key) const;
 
     u32 filled() const
     {
+        if (document->tape.size)
+            return (u32) tape_payload(document->tape[tree_index]);
+
         const auto& node = document->dependency_tree[tree_index];
         return node.object.filled;
     }
 
+    // Compacted objects don't have empty slots, so this is the same as filled()
     u32 capacity() const
     {
+        if (document->tape.size)
+            return (u32) tape_payload(document->tape[tree_index]);
+
         const auto& node = document->dependency_tree[tree_index];
         return node.object.capacity;
     }
+
+    // For going over every entry, slots go from 0 to capacity() and empty ones have no key
+    Atom  key_at(u32 slot) const;
+    Value value_at(u32 slot) const;
 };
 
 struct Value
@@ -88,16 +126,23 @@ struct Value
 
     Type type() const
     {
+        if (document->tape.size)
+            return tape_type(document->tape[tree_index]);
+
         return document->dependency_tree[tree_index].type;
     }
 
     const s64 int64() const
     {
-        const auto& node = document->dependency_tree[tree_index];
-        gn_assert_with_message(node.type == Type::INTEGER,
+        const Type value_type = type();
+        gn_assert_with_message(value_type == Type::INTEGER,
                                "Value doesn't correspond to a INTEGER resource! (actual node type: %)",
-                               get_type_name(node.type));
+                               get_type_name(value_type));
 
+        if (document->tape.size)
+            return (s64) document->tape[tree_index + 1];
+
+        const auto& node = document->dependency_tree[tree_index];
         const auto& resource = document->resources[node.index];
         return resource.integer64;
     }
@@ -105,43 +150,58 @@ struct Value
     // Can cast integer values to float
     const f64 float64() const
     {
-        const auto& node = document->dependency_tree[tree_index];
-        gn_assert_with_message(node.type == Type::FLOAT || node.type == Type::INTEGER,
+        const Type value_type = type();
+        gn_assert_with_message(value_type == Type::FLOAT || value_type == Type::INTEGER,
                                "Value doesn't correspond to a FLOAT or INTEGER resource! (actual node type: %)",
-                               get_type_name(node.type));
+                               get_type_name(value_type));
 
+        if (document->tape.size)
+        {
+            const u64 bits = document->tape[tree_index + 1];
+            return (value_type == Type::FLOAT) ? *(const f64*) &bits : (f64) (s64) bits;
+        }
+
+        const auto& node = document->dependency_tree[tree_index];
         const auto& resource = document->resources[node.index];
-        return (node.type == Type::FLOAT) ? resource.float64 : (f64) resource.integer64;
+        return (value_type == Type::FLOAT) ? resource.float64 : (f64) resource.integer64;
     }
 
     const bool boolean() const
     {
-        const auto& node = document->dependency_tree[tree_index];
-        gn_assert_with_message(node.type == Type::BOOLEAN,
+        const Type value_type = type();
+        gn_assert_with_message(value_type == Type::BOOLEAN,
                                "Value doesn't correspond to a BOOLEAN resource! (actual node type: %)",
-                               get_type_name(node.type));
+                               get_type_name(value_type));
+
+        if (document->tape.size)
+            return tape_payload(document->tape[tree_index]) != 0;
 
+        const auto& node = document->dependency_tree[tree_index];
         const auto& resource = document->resources[node.index];
         return resource.boolean;
     }
     
     const String string() const
     {
-        const auto& node = document->dependency_tree[tree_index];
-        gn_assert_with_message(node.type == Type::STRING,
+        const Type value_type = type();
+        gn_assert_with_message(value_type == Type::STRING,
                                "Value doesn't correspond to a STRING resource! (actual node type: %)",
-                               get_type_name(node.type));
+                               get_type_name(value_type));
+
+        if (document->tape.size)
+            return ref((char*) document->tape[tree_index + 1], tape_payload(document->tape[tree_index]));
 
+        const auto& node = document->dependency_tree[tree_index];
         const auto& resource = document->resources[node.index];
         return resource.string;
     }
 
     Array array() const
     {
-        const auto node_type = document->dependency_tree[tree_index].type;
-        gn_assert_with_message(node_type == Type::ARRAY,
+        const Type value_type = type();
+        gn_assert_with_message(value_type == Type::ARRAY,
                                "Value doesn't correspond to a ARRAY resource! (actual node type: %)",
-                               get_type_name(node_type));
+                               get_type_name(value_type));
 
         // Since data layout is the same
         return *(Array*) (this);
@@ -149,20 +209,15 @@ struct Value
 
     Value operator[](u64 index) const
     {
-        const auto& node = document->dependency_tree[tree_index];
-        gn_assert_with_message(node.type == Type::ARRAY,
-                               "Value doesn't correspond to a ARRAY resource! (actual node type: %)",
-                               get_type_name(node.type));
-
-        return Value { document, node.array[index] };
+        return array()[index];
     }
     
     Object object() const
     {
-        const auto node_type = document->dependency_tree[tree_index].type;
-        gn_assert_with_message(node_type == Type::OBJECT,
+        const Type value_type = type();
+        gn_assert_with_message(value_type == Type::OBJECT,
                                "Value doesn't correspond to a OBJECT resource! (actual node type: %)",
-                               get_type_name(node_type));
+                               get_type_name(value_type));
 
         // Since data layout is the same
         return *(Object*) (this);
@@ -171,61 +226,84 @@ struct Value
     // Returns null if key isn't found
     Value operator[](const String& key) const
     {
-        DependencyNode node = document->dependency_tree[tree_index];
-        gn_assert_with_message(node.type == Type::OBJECT,
-                               "Value doesn't correspond to a OBJECT resource! (actual node type: %)",
-                               get_type_name(node.type));
-
-        auto elem = find(node.object, key);
-
-        // Return null if element was not found
-        if (!elem)
-            return Value { document, 0 };
+        return object()[key];
+    }
 
-        return Value { document, elem.value() };
+    // Returns null if key isn't found
+    Value operator[](const Atom key) const
+    {
+        return object()[key];
     }
 };
 
 } // namespace Slz
 
-inline Slz::Document make(Type<Slz::Document>, u64 start_cap = 16)
+// Chunk size has to be a power of 2. Nothing is allocated until something is parsed into it.
+inline Slz::Document make(Type<Slz::Document>, u64 chunk_size = 256)
 {
     using namespace Slz;
 
-    Document document;
+    gn_assert_with_message(chunk_size > 1 && is_power_of_2(chunk_size), "Chunk size needs to be a power of 2! (chunk size: %)", chunk_size);
+
+    Document document = {};
 
-    document.resources = make<DynamicArray<Resource>>(start_cap);
-    document.dependency_tree = make<DynamicArray<DependencyNode>>(start_cap);
+    // The containers can only point to the arena once the document is in its final place
+    document.dependency_tree.chunk_shift = count_trailing_zeros(chunk_size);
+    document.resources.chunk_shift       = count_trailing_zeros(chunk_size);
 
     return document;
 }
 
+// Points the document's containers at its arena and returns the allocator that everything
+// added to the document should use. Parsers call this before adding anything, the allocator
+// points into the document so it can't be moved while it's being filled (after that it can).
+inline Allocator* document_allocator(Slz::Document& document)
+{
+    Allocator* allocator = arena_allocator(document.arena);
+
+    document.dependency_tree.allocator = document.dependency_tree.chunks.allocator = allocator;
+    document.resources.allocator       = document.resources.chunks.allocator       = allocator;
+
+    return allocator;
+}
+
+// Throws everything away but keeps the arena's memory, so parsing into the same document
+// again (hot reloading) doesn't go to the heap once it has grown big enough
+inline void clear(Slz::Document& document)
+{
+    arena_reset(document.arena);
+
+    // Chunks and the tape were in the arena too
+    document.dependency_tree.chunks = {};
+    document.dependency_tree.size = 0;
+    document.resources.chunks = {};
+    document.resources.size = 0;
+    document.tape = {};
+
+    document_allocator(document);
+}
+
 inline void free(Slz::Document& document)
 {
-    for (u64 i = 0; i < document.dependency_tree.size; i++)
-    {
-        switch (document.dependency_tree[i].type)
-        {
-            case Slz::Type::STRING:
-            {
-                Slz::ResourceIndex index = document.dependency_tree[i].index;
-                free(document.resources[index].string);
-            } break;
-
-            case Slz::Type::ARRAY:
-            {
-                free(document.dependency_tree[i].array);
-            } break;
-
-            case Slz::Type::OBJECT:
-            {
-                Slz::ObjectNode node = document.dependency_tree[i].object;
-                free_keys(node);    // Keys are all strings
-                free(node);
-            } break;
-        }
-    }
+    free(document.arena);
+
+    document.dependency_tree.chunks = {};
+    document.dependency_tree.size = 0;
+    document.resources.chunks = {};
+    document.resources.size = 0;
+    document.tape = {};
+}
+
+// Rewrites a parsed document into the tape layout and frees the tree. Strings are copied
+// into the tape's arena, so the document doesn't point into the source after this.
+// Values taken from the document before compacting it can't be used anymore.
+void document_compact(Slz::Document& document);
+
+// Copies the string into the document's arena
+inline String document_copy_string(Slz::Document& document, const String str)
+{
+    char* data = (char*) arena_allocate(document.arena, str.size, alignof(char));
+    platform_copy_memory(data, str.data, str.size);
 
-    free(document.dependency_tree);
-    free(document.resources);
+    return ref(data, str.size);
 }
\ No newline at end of file
@@ -0,0 +1,325 @@
+#include "slz_schema.h"
+
+#include "core/types.h"
+#include "core/atom.h"
+#include "core/bit_utils.h"
+#include "core/logger.h"
+#include "containers/string.h"
+#include "slz_document.h"
+
+namespace Slz
+{
+
+namespace SchemaInternal
+{
+    constexpr u64 NO_ELEMENT = ~0ui64;
+
+    static const char* get_field_type_name(FieldType type)
+    {
+        const char* names[] = {
+            "BOOLEAN",
+            "S32",
+            "S64",
+            "F32",
+            "F64",
+            "STRING",
+            "OBJECT"
+        };
+
+        return names[(int) type];
+    }
+
+    static void report_location(const Schema& schema, u64 element)
+    {
+        if (element == NO_ELEMENT)
+            print_error("Schema Error[%]: ", schema.name);
+        else
+            print_error("Schema Error[%, element %]: ", schema.name, element);
+    }
+
+    // Keys usually come in the same order as the fields, so the one after the last match is tried first
+    static inline u32 find_field(const Schema& schema, Atom key, u32 next)
+    {
+        if (next < schema.field_count && schema.fields[next].key == key)
+            return next;
+
+        // Structs only have a handful of fields, comparing ids beats hashing
+        for (u32 i = 0; i < schema.field_count; i++)
+        {
+            if (schema.fields[i].key == key)
+                return i;
+        }
+
+        return schema.field_count;
+    }
+
+    static bool read_object(const Object object, const Schema& schema, u8* out, u64 element);
+
+    // Type and scalar of a value straight from the layout, without going through Value
+    static inline Type load_value(const Document* document, ResourceIndex index, Resource& out_scalar)
+    {
+        if (document->tape.size)
+        {
+            const u64* tape = document->tape.data;
+            const u64 word = tape[index];
+            const Type type = tape_type(word);
+
+            // Integers and floats share the bits of the next word
+            if (type == Type::INTEGER || type == Type::FLOAT)
+                out_scalar.integer64 = (s64) tape[index + 1];
+            else if (type == Type::STRING)
+                out_scalar.string = ref((char*) tape[index + 1], tape_payload(word));
+            else
+                out_scalar.boolean = tape_payload(word) != 0;
+
+            return type;
+        }
+
+        const DependencyNode& node = document->dependency_tree[index];
+
+        // Index is only there for scalars
+        if (node.type != Type::ARRAY && node.type != Type::OBJECT)
+            out_scalar = document->resources[node.index];
+
+        return node.type;
+    }
+
+    static bool read_field(const Document* document, ResourceIndex index, const Field& field, u8* out, const Schema& schema, u64 element)
+    {
+        Resource scalar;
+        const Type type = load_value(document, index, scalar);
+
+        switch (field.type)
+        {
+            case FieldType::BOOLEAN:
+            {
+                if (type != Type::BOOLEAN)
+                    break;
+
+                *(bool*) out = scalar.boolean;
+            } return true;
+
+            case FieldType::S32:
+            {
+                if (type != Type::INTEGER)
+                    break;
+
+                const s64 integer = scalar.integer64;
+                if ((s64) (s32) integer != integer)
+                {
+                    report_location(schema, element);
+                    print_error("Field '%' doesn't fit in an S32! (value: %)\n", field.name, integer);
+                    return false;
+                }
+
+                *(s32*) out = (s32) integer;
+            } return true;
+
+            case FieldType::S64:
+            {
+                if (type != Type::INTEGER)
+                    break;
+
+                *(s64*) out = scalar.integer64;
+            } return true;
+
+            case FieldType::F32:
+            {
+                if (type != Type::FLOAT && type != Type::INTEGER)
+                    break;
+
+                *(f32*) out = (f32) ((type == Type::FLOAT) ? scalar.float64 : (f64) scalar.integer64);
+            } return true;
+
+            case FieldType::F64:
+            {
+                if (type != Type::FLOAT && type != Type::INTEGER)
+                    break;
+
+                *(f64*) out = (type == Type::FLOAT) ? scalar.float64 : (f64) scalar.integer64;
+            } return true;
+
+            case FieldType::STRING:
+            {
+                if (type != Type::STRING)
+                    break;
+
+                *(String*) out = scalar.string;
+            } return true;
+
+            case FieldType::OBJECT:
+            {
+                if (type != Type::OBJECT)
+                    break;
+
+                return read_object(Object { document, index }, *field.schema, out, element);
+            }
+        }
+
+        report_location(schema, element);
+        print_error("Field '%' should be % but is %!\n", field.name, get_field_type_name(field.type), get_type_name(type));
+        return false;
+    }
+
+    struct ObjectReader
+    {
+        const Schema* schema;
+        u8* out;
+        u64 element;
+
+        u64 found;
+        u32 next_field;
+        bool success;
+    };
+
+    static inline void read_entry(ObjectReader& reader, const Document* document, Atom key, ResourceIndex value_index)
+    {
+        const Schema& schema = *reader.schema;
+
+        const u32 field_index = find_field(schema, key, reader.next_field);
+        if (field_index == schema.field_count)
+        {
+            if (!schema.allow_extra)
+            {
+                report_location(schema, reader.element);
+                print_error("Unknown field '%'!\n", atom_get_string(key));
+                reader.success = false;
+            }
+
+            return;
+        }
+
+        const Field& field = schema.fields[field_index];
+        reader.found |= 1ui64 << field_index;
+        reader.next_field = field_index + 1;
+
+        reader.success &= read_field(document, value_index, field, reader.out + field.offset, schema, reader.element);
+    }
+
+    static bool read_object(const Object object, const Schema& schema, u8* out, u64 element)
+    {
+        ObjectReader reader = {};
+        reader.schema  = &schema;
+        reader.out     = out;
+        reader.element = element;
+        reader.success = true;
+
+        // Entries are walked straight out of the layout instead of through key_at/value_at
+        const Document* document = object.document;
+        if (document->tape.size)
+        {
+            const u64* tape = document->tape.data;
+            const u32 count = (u32) tape_payload(tape[object.tree_index]);
+
+            const u32* keys    = tape_object_keys(tape, object.tree_index);
+            const u32* offsets = tape_object_offsets(tape, object.tree_index);
+
+            for (u32 i = 0; i < count; i++)
+                read_entry(reader, document, Atom { keys[i] }, object.tree_index + offsets[i]);
+        }
+        else
+        {
+            const ObjectNode& node = document->dependency_tree[object.tree_index].object;
+
+            for (u32 i = 0; i < node.capacity; i++)
+            {
+                if (is_alive(node, i))
+                    read_entry(reader, document, node.keys[i], node.values[i]);
+            }
+        }
+
+        u64 missing = schema.required_mask & ~reader.found;
+        while (missing)
+        {
+            report_location(schema, element);
+            print_error("Missing field '%'!\n", schema.fields[count_trailing_zeros(missing)].name);
+
+            missing &= missing - 1;
+            reader.success = false;
+        }
+
+        return reader.success;
+    }
+
+    static bool check_object(const Value value, const Schema& schema, u64 element)
+    {
+        if (value.type() == Type::OBJECT)
+            return true;
+
+        report_location(schema, element);
+        print_error("Expected an OBJECT but found %!\n", get_type_name(value.type()));
+        return false;
+    }
+}
+
+void schema_compile(Schema& schema)
+{
+    if (schema.compiled)
+        return;
+
+    gn_assert_with_message(schema.field_count <= SCHEMA_MAX_FIELDS, "Too many fields in schema! (schema: %, field count: %)", schema.name, schema.field_count);
+
+    schema.required_mask = 0;
+    for (u32 i = 0; i < schema.field_count; i++)
+    {
+        Field& field = schema.fields[i];
+        field.key = atom_intern(ref((char*) field.name));
+
+        if (!field.optional)
+            schema.required_mask |= 1ui64 << i;
+
+        if (field.type == FieldType::OBJECT)
+        {
+            gn_assert_with_message(field.schema, "Object field doesn't have a schema! (schema: %, field: %)", schema.name, field.name);
+            schema_compile(*field.schema);
+        }
+    }
+
+    schema.compiled = true;
+}
+
+bool deserialize(const Value value, Schema& schema, void* out)
+{
+    using namespace SchemaInternal;
+
+    schema_compile(schema);
+
+    if (!check_object(value, schema, NO_ELEMENT))
+        return false;
+
+    return read_object(value.object(), schema, (u8*) out, NO_ELEMENT);
+}
+
+bool deserialize_array(const Value value, Schema& schema, void* out, u64 stride)
+{
+    using namespace SchemaInternal;
+
+    schema_compile(schema);
+
+    if (value.type() != Type::ARRAY)
+    {
+        report_location(schema, NO_ELEMENT);
+        print_error("Expected an ARRAY but found %!\n", get_type_name(value.type()));
+        return false;
+    }
+
+    const Array array = value.array();
+    const u64 size = array.size();
+
+    bool success = true;
+    for (u64 i = 0; i < size; i++)
+    {
+        const Value element = array[i];
+        if (!check_object(element, schema, i))
+        {
+            success = false;
+            continue;
+        }
+
+        success &= read_object(element.object(), schema, (u8*) out + i * stride, i);
+    }
+
+    return success;
+}
+
+} // namespace Slz
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "core/types.h"
+#include "core/atom.h"
+#include "slz_document.h"
+
+// Binds the keys of an object to the members of a struct, so a struct is described once
+// and then filled straight from a document instead of looking every key up by hand.
+//
+//     static Slz::Field bounds_fields[] = {
+//         SLZ_FIELD(Vector4, x, "left",  F32),
+//         SLZ_FIELD(Vector4, y, "top",   F32),
+//     };
+//     static Slz::Schema bounds_schema = make<Slz::Schema>("bounds", bounds_fields, 2u);
+//     Slz::deserialize(document.start()[ref("bounds")], bounds_schema, &bounds);
+//
+// Field names are interned the first time a schema is used, after that reading an object is a
+// single walk over its entries that matches keys by atom id, checks their types and reports
+// wrong, missing and unknown keys all at once instead of stopping at the first one.
+
+namespace Slz
+{
+
+constexpr u32 SCHEMA_MAX_FIELDS = 64;
+
+enum struct FieldType : u8
+{
+    BOOLEAN,    // bool
+    S32,        // Integers, checked to fit
+    S64,
+    F32,        // Floats or integers
+    F64,
+    STRING,     // String, points into the document
+    OBJECT,     // Struct described by another schema
+};
+
+struct Schema;
+
+struct Field
+{
+    const char* name;
+    u32 offset;             // Of the member in the struct
+    FieldType type;
+    bool optional;          // Missing optional fields leave the member as it was
+    Schema* schema;         // Only for FieldType::OBJECT
+
+    Atom key;               // Interned name, set by schema_compile
+};
+
+struct Schema
+{
+    const char* name;       // Only used for error messages
+    Field* fields;
+    u32 field_count;
+    bool allow_extra;       // Keys without a field are reported unless this is set
+
+    bool compiled;
+    u64 required_mask;      // Bit per field that isn't optional
+};
+
+#define SLZ_FIELD(struct_type, member, key_name, field_type) \
+    Slz::Field { key_name, (u32) offsetof(struct_type, member), Slz::FieldType::field_type, false, nullptr, ATOM_NONE }
+
+#define SLZ_OPTIONAL_FIELD(struct_type, member, key_name, field_type) \
+    Slz::Field { key_name, (u32) offsetof(struct_type, member), Slz::FieldType::field_type, true, nullptr, ATOM_NONE }
+
+#define SLZ_OBJECT_FIELD(struct_type, member, key_name, member_schema, is_optional) \
+    Slz::Field { key_name, (u32) offsetof(struct_type, member), Slz::FieldType::OBJECT, is_optional, &(member_schema), ATOM_NONE }
+
+// Interns the field names of the schema and the schemas it uses. Called by the first
+// deserialize, but not thread safe, so call it up front if threads share a schema.
+void schema_compile(Schema& schema);
+
+// Fills the struct from an object. Every problem is reported, returns false if there were any.
+bool deserialize(const Value value, Schema& schema, void* out);
+
+// Fills a struct per element of the array, stride bytes apart, out needs room for array.size() of them
+bool deserialize_array(const Value value, Schema& schema, void* out, u64 stride);
+
+} // namespace Slz
+
+inline Slz::Schema make(Type<Slz::Schema>, const char* name, Slz::Field* fields, u32 field_count, bool allow_extra = false)
+{
+    gn_assert_with_message(field_count <= Slz::SCHEMA_MAX_FIELDS, "Too many fields in schema! (schema: %, field count: %)", name, field_count);
+
+    Slz::Schema schema = {};
+    schema.name        = name;
+    schema.fields      = fields;
+    schema.field_count = field_count;
+    schema.allow_extra = allow_extra;
+
+    return schema;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "slz_strings.h"
+
+#include <emmintrin.h>
+
+#include "core/types.h"
+#include "core/bit_utils.h"
+#include "containers/string.h"
+#include "platform/platform.h"
+
+namespace Slz
+{
+
+u64 find_backslash(const String str, u64 index)
+{
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    for (; index + 16 <= str.size; index += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*) (str.data + index));
+        const u32 mask = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash));
+
+        if (mask)
+            return index + count_trailing_zeros(mask);
+    }
+
+    for (; index < str.size; index++)
+    {
+        if (str.data[index] == '\\')
+            return index;
+    }
+
+    return str.size;
+}
+
+bool unescape(const String source, char* out_buffer, u64& out_size)
+{
+    u64 size  = 0;
+    u64 index = 0;
+
+    while (true)
+    {
+        const u64 backslash = find_backslash(source, index);
+
+        platform_copy_memory(out_buffer + size, source.data + index, backslash - index);
+        size += backslash - index;
+
+        if (backslash == source.size)
+            break;
+
+        // Lexers don't let a string end in a backslash, but don't read past it if one does
+        if (backslash + 1 == source.size)
+        {
+            out_size = backslash;
+            return false;
+        }
+
+        char ch;
+        switch (source.data[backslash + 1])
+        {
+            case 'b':  ch = '\b'; break;
+            case 'f':  ch = '\f'; break;
+            case 'n':  ch = '\n'; break;
+            case 'r':  ch = '\r'; break;
+            case 't':  ch = '\t'; break;
+            case '\"': ch = '\"'; break;
+            case '\\': ch = '\\'; break;
+
+            default:
+            {
+                out_size = backslash;
+                return false;
+            }
+        }
+
+        out_buffer[size++] = ch;
+        index = backslash + 2;
+    }
+
+    out_size = size;
+    return true;
+}
+
+} // namespace Slz
\ No newline at end of file
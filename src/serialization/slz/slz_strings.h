@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/types.h"
+#include "containers/string.h"
+
+namespace Slz
+{
+
+// How parsers store the strings of a document
+enum struct StringStorage : u8
+{
+    COPY,       // Every string lives in the document, the source can be freed right after parsing
+    IN_SOURCE,  // Strings without escapes point into the source, which has to outlive the document
+};
+
+// Index of the first backslash at or after the index, or str.size if there isn't one.
+// Looks at 16 bytes at a time, most strings don't have any escapes at all.
+u64 find_backslash(const String str, u64 index);
+
+// Decodes \b \f \n \r \t \" and \\ into the buffer, which needs room for source.size characters.
+// Runs between escapes are copied in one go. Returns false at the first escape sequence it
+// doesn't know, out_size is then the index of that backslash in the source.
+bool unescape(const String source, char* out_buffer, u64& out_size);
+
+} // namespace Slz
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "slz_tape.h"
+
+#include <emmintrin.h>
+
+#include "core/types.h"
+#include "core/allocator.h"
+#include "core/bit_utils.h"
+#include "core/logger.h"
+#include "containers/hash.h"
+#include "platform/platform.h"
+#include "slz_document.h"
+
+namespace Slz
+{
+
+u64 tape_find(const u64* tape, u64 object_index, Atom key)
+{
+    const u32 count = (u32) tape_payload(tape[object_index]);
+    const u32* keys = tape_object_keys(tape, object_index);
+
+    u32 entry = count;
+    if (count <= TAPE_LINEAR_SEARCH_MAX)
+    {
+        // Keys are interned, so comparing ids is enough and 4 of them fit in a register.
+        // Padding is ATOM_NONE, which only matches past the count.
+        const __m128i needle = _mm_set1_epi32((s32) key.id);
+
+        for (u32 i = 0; i < count; i += 4)
+        {
+            const __m128i chunk = _mm_loadu_si128((const __m128i*) (keys + i));
+            const u32 mask = (u32) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(chunk, needle)));
+
+            if (mask)
+            {
+                entry = i + count_trailing_zeros(mask);
+                break;
+            }
+        }
+    }
+    else
+    {
+        const u32* index = tape_object_index(tape, object_index);
+        const u32 mask = tape_index_slot_count(count) - 1;
+
+        for (u32 slot = Hasher<Atom>()(key) & mask; index[slot] != 0; slot = (slot + 1) & mask)
+        {
+            if (keys[index[slot] - 1] == key.id)
+            {
+                entry = index[slot] - 1;
+                break;
+            }
+        }
+    }
+
+    if (entry >= count)
+        return 0;
+
+    return object_index + tape_object_offsets(tape, object_index)[entry];
+}
+
+void tape_index_insert(u32* index, u32 slot_count, Atom key, u32 entry)
+{
+    const u32 mask = slot_count - 1;
+
+    u32 slot = Hasher<Atom>()(key) & mask;
+    while (index[slot] != 0)
+        slot = (slot + 1) & mask;
+
+    index[slot] = entry + 1;
+}
+
+namespace TapeInternal
+{
+    struct Sizes
+    {
+        u64 words;
+        u64 string_bytes;
+    };
+
+    struct Writer
+    {
+        u64* tape;
+        u64  size;
+        char* strings;
+    };
+
+    static void measure(const Document& document, ResourceIndex tree_index, Sizes& sizes)
+    {
+        const DependencyNode& node = document.dependency_tree[tree_index];
+
+        switch (node.type)
+        {
+            case Type::NONE:
+            case Type::BOOLEAN:
+            {
+                sizes.words += 1;
+            } break;
+
+            case Type::INTEGER:
+            case Type::FLOAT:
+            {
+                sizes.words += 2;
+            } break;
+
+            case Type::STRING:
+            {
+                sizes.words += 2;
+                sizes.string_bytes += document.resources[node.index].string.size;
+            } break;
+
+            case Type::ARRAY:
+            {
+                sizes.words += 2 + tape_offset_words(node.array.size);
+
+                for (u64 i = 0; i < node.array.size; i++)
+                    measure(document, node.array[i], sizes);
+            } break;
+
+            case Type::OBJECT:
+            {
+                const u64 count = node.object.filled;
+                sizes.words += 2 + tape_key_words(count) + tape_offset_words(count) + tape_index_words(count);
+
+                for (u32 i = 0; i < node.object.capacity; i++)
+                {
+                    if (is_alive(node.object, i))
+                        measure(document, node.object.values[i], sizes);
+                }
+            } break;
+        }
+    }
+
+    // Tape is zeroed beforehand, so padding and empty index slots are already there
+    static void write(const Document& document, ResourceIndex tree_index, Writer& writer)
+    {
+        const DependencyNode& node = document.dependency_tree[tree_index];
+        const u64 start = writer.size;
+
+        switch (node.type)
+        {
+            case Type::NONE:
+            {
+                writer.tape[writer.size++] = tape_word(Type::NONE, 0);
+            } break;
+
+            case Type::BOOLEAN:
+            {
+                writer.tape[writer.size++] = tape_word(Type::BOOLEAN, document.resources[node.index].boolean);
+            } break;
+
+            case Type::INTEGER:
+            {
+                writer.tape[writer.size++] = tape_word(Type::INTEGER, 0);
+                writer.tape[writer.size++] = (u64) document.resources[node.index].integer64;
+            } break;
+
+            case Type::FLOAT:
+            {
+                const f64 value = document.resources[node.index].float64;
+
+                writer.tape[writer.size++] = tape_word(Type::FLOAT, 0);
+                platform_copy_memory(&writer.tape[writer.size++], &value, sizeof(value));
+            } break;
+
+            case Type::STRING:
+            {
+                const String str = document.resources[node.index].string;
+                platform_copy_memory(writer.strings, str.data, str.size);
+
+                writer.tape[writer.size++] = tape_word(Type::STRING, str.size);
+                writer.tape[writer.size++] = (u64) writer.strings;
+                writer.strings += str.size;
+            } break;
+
+            case Type::ARRAY:
+            {
+                const u64 count = node.array.size;
+
+                writer.tape[start] = tape_word(Type::ARRAY, count);
+                writer.size += 2 + tape_offset_words(count);
+
+                u32* offsets = (u32*) tape_array_offsets(writer.tape, start);
+                for (u64 i = 0; i < count; i++)
+                {
+                    offsets[i] = (u32) (writer.size - start);
+                    write(document, node.array[i], writer);
+                }
+
+                writer.tape[start + 1] = writer.size - start;
+            } break;
+
+            case Type::OBJECT:
+            {
+                const u32 count = node.object.filled;
+
+                writer.tape[start] = tape_word(Type::OBJECT, count);
+                writer.size += 2 + tape_key_words(count) + tape_offset_words(count) + tape_index_words(count);
+
+                u32* keys    = (u32*) tape_object_keys(writer.tape, start);
+                u32* offsets = (u32*) tape_object_offsets(writer.tape, start);
+                u32* index   = (u32*) tape_object_index(writer.tape, start);
+
+                u32 entry = 0;
+                for (u32 i = 0; i < node.object.capacity; i++)
+                {
+                    if (!is_alive(node.object, i))
+                        continue;
+
+                    const Atom key = node.object.keys[i];
+                    keys[entry] = key.id;
+
+                    if (count > TAPE_LINEAR_SEARCH_MAX)
+                        tape_index_insert(index, tape_index_slot_count(count), key, entry);
+
+                    offsets[entry] = (u32) (writer.size - start);
+                    write(document, node.object.values[i], writer);
+
+                    entry++;
+                }
+
+                writer.tape[start + 1] = writer.size - start;
+            } break;
+        }
+
+        gn_assert_with_message(writer.size - start <= 0xFFFFFFFFui64, "Value is too big for the tape! (size in words: %)", writer.size - start);
+    }
+}
+
+} // namespace Slz
+
+void document_compact(Slz::Document& document)
+{
+    using namespace Slz;
+    using namespace Slz::TapeInternal;
+
+    gn_assert_with_message(document.tape.size == 0, "Document is already compacted!");
+    gn_assert_with_message(document.dependency_tree.size > 3, "Document is empty! (number of elements: %)", document.dependency_tree.size);
+
+    const ResourceIndex root = document.start().tree_index;
+
+    // Word 0 is what missing values point to
+    Sizes sizes = { TAPE_ROOT_INDEX, 0 };
+    measure(document, root, sizes);
+
+    Arena arena = {};
+
+    u64* tape = (u64*) arena_allocate(arena, sizes.words * sizeof(u64), alignof(u64));
+    platform_set_memory(tape, 0, sizes.words * sizeof(u64));
+
+    Writer writer = {};
+    writer.tape    = tape;
+    writer.size    = TAPE_ROOT_INDEX;
+    writer.strings = (char*) arena_allocate(arena, sizes.string_bytes, alignof(char));
+
+    write(document, root, writer);
+    gn_assert_with_message(writer.size == sizes.words, "Tape size doesn't match what was measured! (measured: %, written: %)", sizes.words, writer.size);
+
+    free(document);
+    document.arena = arena;
+
+    document.tape.data      = tape;
+    document.tape.size      = sizes.words;
+    document.tape.capacity  = sizes.words;
+    document.tape.allocator = arena_allocator(document.arena);
+}
\ No newline at end of file
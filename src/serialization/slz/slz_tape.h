@@ -0,0 +1,103 @@
+#pragma once
+
+#include "core/types.h"
+#include "core/atom.h"
+#include "core/bit_utils.h"
+#include "containers/string.h"
+#include "slz_types.h"
+
+// Compact layout for a document: one array of 64 bit words with every value stored in
+// place, in document order. The top byte of a value's first word is its type and the
+// rest is a payload, containers also store the offset of their end so they can be stepped over.
+//
+//     NONE     [NONE]
+//     BOOLEAN  [BOOLEAN | value]
+//     INTEGER  [INTEGER] [s64]
+//     FLOAT    [FLOAT] [f64]
+//     STRING   [STRING | size] [data pointer]
+//     ARRAY    [ARRAY | count] [end] [offsets] [elements...]
+//     OBJECT   [OBJECT | count] [end] [keys] [offsets] [index] [values...]
+//
+// Offsets are u32s from the start of the container to each element/value. Object keys are
+// the atom ids packed next to each other (padded with zeros to a multiple of 4) so they
+// can be compared 4 at a time, and only objects with more than TAPE_LINEAR_SEARCH_MAX keys
+// get an index: an open addressing table of key number + 1 (0 is empty) sized from the count.
+// Word 0 is always a NONE that missing values point to, the root value starts at word 1.
+
+namespace Slz
+{
+
+constexpr u64 TAPE_TYPE_SHIFT = 56;
+constexpr u64 TAPE_PAYLOAD_MASK = (1ui64 << TAPE_TYPE_SHIFT) - 1;
+constexpr u64 TAPE_ROOT_INDEX = 1;
+
+constexpr u32 TAPE_LINEAR_SEARCH_MAX = 16;
+
+inline u64 tape_word(Type type, u64 payload)
+{
+    return ((u64) type << TAPE_TYPE_SHIFT) | (payload & TAPE_PAYLOAD_MASK);
+}
+
+inline Type tape_type(u64 word)
+{
+    return (Type) (word >> TAPE_TYPE_SHIFT);
+}
+
+inline u64 tape_payload(u64 word)
+{
+    return word & TAPE_PAYLOAD_MASK;
+}
+
+// Sizes of the parts of a container in words, from its element count
+inline u64 tape_key_words(u64 count)
+{
+    return ((count + 3) / 4) * 2;
+}
+
+inline u64 tape_offset_words(u64 count)
+{
+    return (count + 1) / 2;
+}
+
+inline u32 tape_index_slot_count(u64 count)
+{
+    if (count <= TAPE_LINEAR_SEARCH_MAX)
+        return 0;
+
+    // At most half full
+    return next_power_of_2((u32) (2 * count));
+}
+
+inline u64 tape_index_words(u64 count)
+{
+    return tape_index_slot_count(count) / 2;
+}
+
+inline const u32* tape_array_offsets(const u64* tape, u64 index)
+{
+    return (const u32*) (tape + index + 2);
+}
+
+inline const u32* tape_object_keys(const u64* tape, u64 index)
+{
+    return (const u32*) (tape + index + 2);
+}
+
+inline const u32* tape_object_offsets(const u64* tape, u64 index)
+{
+    return (const u32*) (tape + index + 2 + tape_key_words(tape_payload(tape[index])));
+}
+
+inline const u32* tape_object_index(const u64* tape, u64 index)
+{
+    const u64 count = tape_payload(tape[index]);
+    return (const u32*) (tape + index + 2 + tape_key_words(count) + tape_offset_words(count));
+}
+
+// Index of the object's value for the key, or 0 (the NONE word) if it doesn't have it
+u64 tape_find(const u64* tape, u64 object_index, Atom key);
+
+// Adds an object's key number to its index, which has to start out zeroed
+void tape_index_insert(u32* index, u32 slot_count, Atom key, u32 entry);
+
+} // namespace Slz
\ No newline at end of file
@@ -96,15 +96,13 @@ bool collect_block_string(String& block_string, const String content, char delim
         return true;
     }
     
-    StringBuilder builder = make<StringBuilder>();
-
-    char new_lines[] = "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n";
-    char spaces[] = "                                                                ";
+    // Block strings are only needed while parsing, same as the tokens
+    StringBuilder builder = make<StringBuilder>(256ui64, arena_allocator(get_scratch_arena()));
 
     s64 indentation = start_indent;  // Used for spacing
     s64 line = start_line;   // Used for new lines
 
-    append(builder, ref(new_lines, (u64) (line - out_line - 1)));
+    append_repeated(builder, '\n', (u64) (line - out_line - 1));
 
     while (current_index < content.size)
     {
@@ -115,8 +113,8 @@ bool collect_block_string(String& block_string, const String content, char delim
         if (indentation < start_indent)
             break;
 
-        append(builder, ref(new_lines, (u64) (max(line - prev_line - 1, 0i64))));
-        append(builder, ref(spaces, (u64) (indentation - start_indent)));
+        append_repeated(builder, '\n', (u64) (max(line - prev_line - 1, 0i64)));
+        append_repeated(builder, ' ', (u64) (indentation - start_indent));
 
         {   // Append string till end of line or file
             u64 str_size = 0;
@@ -129,13 +127,12 @@ bool collect_block_string(String& block_string, const String content, char delim
             }
 
             append(builder, get_substring(content, current_index, str_size));
-            append(builder, ref(&delim, 1));
+            append(builder, delim);
             current_index += str_size;
         }
     }
 
-    block_string = build_string(builder);
-    free(builder);
+    block_string = get_string(builder);
 
     out_indentation = indentation;
     out_line = line;
@@ -219,6 +216,7 @@ bool tokenize(const String content, DynamicArray<Token> &tokens)
                 token.line = line;
                 token.type  = Token::Type::SCALAR;
                 token.is_quoted = true;
+                token.in_scratch = true;
 
                 encountered_error = collect_block_string(token.value, content, '\n', current_index, indentation, line);
 
@@ -236,6 +234,7 @@ bool tokenize(const String content, DynamicArray<Token> &tokens)
                 token.line = line;
                 token.type  = Token::Type::SCALAR;
                 token.is_quoted = true;
+                token.in_scratch = true;
 
                 encountered_error = collect_block_string(token.value, content, ' ', current_index, indentation, line);
 
@@ -294,6 +293,7 @@ bool tokenize(const String content, DynamicArray<Token> &tokens)
                 token.line = line;
                 token.type  = force_key ? Token::Type::KEY : Token::Type::SCALAR;
                 token.is_quoted = true;
+                token.in_scratch = false;
                 token.value = get_substring(content, current_index, str_size);
 
                 append(tokens, token);
@@ -424,6 +424,7 @@ bool tokenize(const String content, DynamicArray<Token> &tokens)
                 token.line = line;
                 token.type  = force_key ? Token::Type::KEY : Token::Type::SCALAR;
                 token.is_quoted = false;
+                token.in_scratch = false;
                 token.value = get_substring(content, current_index, str_size);
 
                 append(tokens, token);
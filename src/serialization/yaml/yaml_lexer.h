@@ -31,8 +31,9 @@ struct Token
     u64 index;
     s64 line;
     s64 indentation;
-    String value; // Not owned
+    String value; // Not owned, points into the content unless it's in the scratch arena
     bool is_quoted;
+    bool in_scratch; // Block strings are put together in the scratch arena, so they can't be used in place
 };
 
 bool tokenize(const String content, DynamicArray<Token>& tokens);
@@ -4,6 +4,9 @@
 
 #include "core/logger.h"
 #include "core/types.h"
+#include "core/allocator.h"
+#include "core/atom.h"
+#include "core/number_conversion.h"
 #include "core/utils.h"
 #include "containers/string.h"
 #include "containers/string_builder.h"
@@ -19,6 +22,8 @@ struct ParserContext
 {
     String content;
     u64 current_index;
+    Slz::StringStorage string_storage;
+    Allocator* allocator;   // Document's arena, for arrays and objects
     bool encountered_error;
 };
 
@@ -27,39 +32,61 @@ struct IndentContext
     s64 line, indentation;
 };
 
-static String copy_and_escape(const Token& source_token, ParserContext& context)
+static void report_bad_escape(const Token& source_token, u64 backslash, ParserContext& context)
 {
-    DynamicArray<char> result = make<DynamicArray<char>>(source_token.value.size);
+    // Lexer makes sure a backslash is never the last character of a string
+    log_error(context.content, source_token.index, "Unexpected escape character! (character: '\\%')", source_token.value.data[backslash + 1]);
+    context.encountered_error = true;
+}
 
-    for (u64 i = 0; i < source_token.value.size; i++)
-    {
-        char ch = source_token.value[i];
+// Escaped string lives in the scratch arena, free it with arena_free when done
+static String escape_to_scratch(const Token& source_token, ParserContext& context)
+{
+    // Escaped string can only be shorter than the source
+    Arena& scratch = get_scratch_arena();
+    char* buffer = (char*) arena_allocate(scratch, source_token.value.size, alignof(char));
 
-        if (ch == '\\')
-        {
-            i++;
-            switch (source_token.value[i])
-            {
-                case 'b':  ch = '\b'; break;
-                case 'f':  ch = '\f'; break;
-                case 'n':  ch = '\n'; break;
-                case 'r':  ch = '\r'; break;
-                case 't':  ch = '\t'; break;
-                case '\"': ch = '\"'; break;
-                case '\\': ch = '\\'; break;
-
-                default:
-                {
-                    log_error(context.content, source_token.index, "Unexpected escape character! (character: '\\%')", source_token.value[i]);
-                    context.encountered_error = true;
-                } break;
-            }
-        }
+    u64 size;
+    if (!Slz::unescape(source_token.value, buffer, size))
+        report_bad_escape(source_token, size, context);
+
+    return ref(buffer, size);
+}
+
+// Unquoted strings and quoted ones without escapes are used as they are (or copied,
+// depending on the storage), the rest are decoded straight into the document's arena.
+// Block strings are in the scratch arena, which is restored after parsing, so they're always copied.
+static String store_string(const Token& source_token, ParserContext& context, Slz::Document& out)
+{
+    const String source = source_token.value;
+
+    if (!source_token.is_quoted || Slz::find_backslash(source, 0) == source.size)
+    {
+        if (context.string_storage == Slz::StringStorage::IN_SOURCE && !source_token.in_scratch)
+            return source;
 
-        append(result, ch);
+        return document_copy_string(out, source);
     }
 
-    return String { result.data, result.size };
+    char* buffer = (char*) arena_allocate(out.arena, source.size, alignof(char));
+
+    u64 size;
+    if (!Slz::unescape(source, buffer, size))
+        report_bad_escape(source_token, size, context);
+
+    // Escapes made it shorter, give back the rest
+    arena_reallocate(out.arena, buffer, source.size, size, alignof(char));
+
+    return ref(buffer, size);
+}
+
+static Atom intern_and_escape(const Token& source_token, ParserContext& context)
+{
+    const String escaped = escape_to_scratch(source_token, context);
+    const Atom   result  = atom_intern(escaped);
+    arena_free(get_scratch_arena(), escaped.data);
+
+    return result;
 }
 
 static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserContext& context, const IndentContext& indent_ctx, Slz::Document& out)
@@ -101,56 +128,23 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
                 break;
             }
 
-            // Check if it's a number
-            if (!token.is_quoted && (token.value[0] == '-' || token.value[0] == '.' || is_digit(token.value[0])))
+            // Check if it's a number, integers that don't fit in 64 bits become floats
+            if (!token.is_quoted)
             {
-                bool encountered_dot = token.value[0] == '.';
+                Slz::Resource res = {};
                 bool is_number = true;
 
-                for (u64 i = 1; i < token.value.size; i++)
-                {
-                    // - is not allowed between numbers (no math allowed!)
-                    if (token.value[i] == '-')
-                    {
-                        is_number = false;
-                        break;
-                    }
-                    
-                    // there should be only 1 dot in a number
-                    if (token.value[i] == '.')
-                    {
-                        if (encountered_dot)
-                        {
-                            is_number = false;
-                            break;
-                        }
-
-                        encountered_dot = true;
-                    }
-                    else if (!is_digit(token.value[i]))
-                    {
-                        is_number = false;
-                        break;
-                    }
-                }
+                if (parse_s64(token.value, res.integer64))
+                    node.type = Slz::Type::INTEGER;
+                else if (parse_f64(token.value, res.float64))
+                    node.type = Slz::Type::FLOAT;
+                else
+                    is_number = false;
 
                 if (is_number)
                 {
                     node.index = out.resources.size;
 
-                    Slz::Resource res = {};
-
-                    if (encountered_dot)
-                    {
-                        res.float64 = atof(token.value.data);
-                        node.type = Slz::Type::FLOAT;
-                    }
-                    else
-                    {
-                        res.integer64 = _atoi64(token.value.data);
-                        node.type = Slz::Type::INTEGER;
-                    }
-
                     append(out.resources, res);
                     context.current_index++;
                     break;
@@ -161,7 +155,7 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
             Slz::ResourceIndex index = out.resources.size;
 
             Slz::Resource res = {};
-            res.string = token.is_quoted ? copy_and_escape(token, context) : copy(token.value);
+            res.string = store_string(token, context, out);
             append(out.resources, res);
 
             node.index = index;
@@ -192,7 +186,7 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
 
             {   // Initialize parent as an object
                 Slz::DependencyNode& node = out.dependency_tree[current_node_index];
-                node.object = make<Slz::ObjectNode>();
+                node.object = make<Slz::ObjectNode>(Slz::OBJECT_START_CAPACITY, context.allocator);
                 node.type = Slz::Type::OBJECT;
             }
 
@@ -217,7 +211,7 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
                     break;
                 }
 
-                const String& key_string = next_token.is_quoted ? copy_and_escape(next_token, context) : next_token.value;
+                const Atom key = next_token.is_quoted ? intern_and_escape(next_token, context) : atom_intern(next_token.value);
 
                 context.current_index++;
 
@@ -227,14 +221,14 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
                 {
                     Slz::ResourceIndex value_index = out.dependency_tree.size;
                     append(out.dependency_tree, {});
-                    put(out.dependency_tree[current_node_index].object, key_string, value_index);
+                    put(out.dependency_tree[current_node_index].object, key, value_index);
 
                     continue;
                 }
 
                 IndentContext child_indent_ctx = { next_token.line, next_token.indentation };
                 Slz::ResourceIndex value_index = parse_next(tokens, context, child_indent_ctx, out);
-                put(out.dependency_tree[current_node_index].object, key_string, value_index);
+                put(out.dependency_tree[current_node_index].object, key, value_index);
             }
         } break;
 
@@ -243,7 +237,7 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
         {
             {   // Initialize parent as an object
                 Slz::DependencyNode& node = out.dependency_tree[current_node_index];
-                node.object = make<Slz::ObjectNode>();
+                node.object = make<Slz::ObjectNode>(Slz::OBJECT_START_CAPACITY, context.allocator);
                 node.type = Slz::Type::OBJECT;
             }
             
@@ -275,13 +269,13 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
                     break;
                 }
 
-                const String& key_string = next_token.is_quoted ? copy_and_escape(next_token, context) : next_token.value;
+                const Atom key = next_token.is_quoted ? intern_and_escape(next_token, context) : atom_intern(next_token.value);
 
                 context.current_index++;
 
                 IndentContext child_indent_ctx = { next_token.line, next_token.indentation };
                 Slz::ResourceIndex value_index = parse_next(tokens, context, child_indent_ctx, out);
-                put(out.dependency_tree[current_node_index].object, key_string, value_index);
+                put(out.dependency_tree[current_node_index].object, key, value_index);
 
                 if (context.current_index >= tokens.size)
                 {
@@ -324,7 +318,7 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
 
             {   // Initialize parent as an array
                 Slz::DependencyNode& node = out.dependency_tree[current_node_index];
-                node.array = make<Slz::ArrayNode>();
+                node.array = make<Slz::ArrayNode>(context.allocator);
                 node.type = Slz::Type::ARRAY;
             }
 
@@ -373,7 +367,7 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
         {
             {   // Initialize parent as an array
                 Slz::DependencyNode& node = out.dependency_tree[current_node_index];
-                node.array = make<Slz::ArrayNode>();
+                node.array = make<Slz::ArrayNode>(context.allocator);
                 node.type = Slz::Type::ARRAY;
             }
             
@@ -433,11 +427,13 @@ static Slz::ResourceIndex parse_next(const DynamicArray<Token>& tokens, ParserCo
     return current_node_index;
 }
 
-bool parse_tokens(const DynamicArray<Token> &tokens, const String content, Slz::Document &out)
+bool parse_tokens(const DynamicArray<Token> &tokens, const String content, Slz::Document &out, Slz::StringStorage string_storage)
 {
     gn_assert_with_message(tokens.data, "Tokens array points to null!");
     gn_assert_with_message(out.dependency_tree.size == 0, "Output json Slz::Document struct is not empty! (number of elements: %)", out.dependency_tree.size);
 
+    Allocator* allocator = document_allocator(out);
+
     {   // Add the null element
         // If user tries to access an object property that wasn't in the file,
         // then the value will point to this element
@@ -476,6 +472,8 @@ bool parse_tokens(const DynamicArray<Token> &tokens, const String content, Slz::
 
     ParserContext context = {};
     context.content = content;
+    context.string_storage = string_storage;
+    context.allocator = allocator;
 
     IndentContext indent_ctx;
     indent_ctx.line = indent_ctx.indentation = -1;
@@ -496,9 +494,15 @@ bool parse_tokens(const DynamicArray<Token> &tokens, const String content, Slz::
     return !context.encountered_error;
 }
 
-bool parse_string(const String content, Slz::Document &out)
+bool parse_string(const String content, Slz::Document &out, Slz::StringStorage string_storage)
 {
+    // Tokens are only needed while parsing
+    Arena& scratch = get_scratch_arena();
+    const ArenaMarker marker = arena_get_marker(scratch);
+
     DynamicArray<Token> tokens = {};
+    tokens.allocator = arena_allocator(scratch);
+
     bool success = tokenize(content, tokens);
 
     if (!success)
@@ -507,12 +511,12 @@ bool parse_string(const String content, Slz::Document &out)
         goto err_lexing;
     }
 
-    success = parse_tokens(tokens, content, out);
+    success = parse_tokens(tokens, content, out, string_storage);
     if (!success)
         print_error("Parsing failed!");
 
 err_lexing:
-    free(tokens);
+    arena_restore(scratch, marker);
 
     return success;
 }
@@ -6,7 +6,8 @@
 namespace Yaml
 {
 
-bool parse_tokens(const DynamicArray<Token>& tokens, const String content, Slz::Document& out);
-bool parse_string(const String content, Slz::Document& out);
+// With StringStorage::IN_SOURCE the content has to outlive the document
+bool parse_tokens(const DynamicArray<Token>& tokens, const String content, Slz::Document& out, Slz::StringStorage string_storage = Slz::StringStorage::COPY);
+bool parse_string(const String content, Slz::Document& out, Slz::StringStorage string_storage = Slz::StringStorage::COPY);
 
 } // namespace Yaml
\ No newline at end of file
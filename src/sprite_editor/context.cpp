@@ -3,7 +3,6 @@
 #include "application/application.h"
 #include "containers/string.h"
 #include "containers/darray.h"
-#include "containers/algorithms.h"
 #include "core/logger.h"
 #include "engine/imgui.h"
 #include "fileio/fileio.h"
@@ -19,8 +18,9 @@ bool context_init(Context& ctx, const Application& app)
     {   // Load UI Font
         String content = file_load_string(ref("assets/fonts/assistant-medium.font.json"));
 
+        // Document is freed before the content, so its strings can point into the content
         Slz::Document document = {};
-        if (!Json::parse_string(content, document))
+        if (!Json::parse_string(content, document, Slz::StringStorage::IN_SOURCE))
         {
             print_error("Error parsing font json!");
             return false;
@@ -82,8 +82,8 @@ bool context_init(Context& ctx, const Application& app)
     }
 
     {   // Other state things
-        ctx.sprites_selected = make<DynamicArray<s32>>();
-        ctx.sprites_to_be_deleted = make<DynamicArray<s32>>();
+        ctx.sprites_selected = make<DynamicBitSet>();
+        ctx.sprites_to_be_deleted = make<DynamicBitSet>();
     }
 
     return true;
@@ -94,6 +94,9 @@ void context_free(Context &ctx)
     free(ctx.background_image);
     free(ctx.sprite_sheet);
     free(ctx.ui_font);
+
+    free(ctx.sprites_selected);
+    free(ctx.sprites_to_be_deleted);
 }
 
 void context_update_on_image_load(Context& ctx, const String filepath, const TextureSettings settings)
@@ -151,6 +154,7 @@ void context_update_on_image_load(Context& ctx, const String filepath, const Tex
 
     {   // Reset sprite sheet and animation data
         clear(ctx.sprite_sheet.sprites);
+        context_on_sprite_count_changed(ctx);
 
         for (u64 i = 0; i < ctx.animations.size; i++)
             free(ctx.animations[i]);
@@ -163,13 +167,37 @@ void context_update_on_image_load(Context& ctx, const String filepath, const Tex
     }
 }
 
+void context_on_sprite_count_changed(Context& ctx)
+{
+    resize(ctx.sprites_selected, ctx.sprite_sheet.sprites.size);
+    resize(ctx.sprites_to_be_deleted, ctx.sprite_sheet.sprites.size);
+}
+
 void context_delete_sprites(Context &ctx)
 {
-    // Sort the list first
-    sort(ctx.sprites_to_be_deleted);
+    if (!any_set(ctx.sprites_to_be_deleted))
+        return;
+
+    // Compact the remaining sprites in one pass, selected sprites move along with them
+    DynamicArray<SpriteSheet::SpriteData>& sprites = ctx.sprite_sheet.sprites;
+
+    u64 kept = 0;
+    for (u64 i = 0; i < sprites.size; i++)
+    {
+        if (test_bit(ctx.sprites_to_be_deleted, i))
+            continue;
+
+        const bool is_selected = test_bit(ctx.sprites_selected, i);
+        clear_bit(ctx.sprites_selected, i);
+
+        if (is_selected)
+            set_bit(ctx.sprites_selected, kept);
+
+        sprites[kept++] = sprites[i];
+    }
 
-    for (int i = ctx.sprites_to_be_deleted.size - 1; i >= 0; i--)
-        remove(ctx.sprite_sheet.sprites, ctx.sprites_to_be_deleted[i]);
+    sprites.size = kept;
 
-    clear(ctx.sprites_to_be_deleted);
+    clear_all(ctx.sprites_to_be_deleted);
+    context_on_sprite_count_changed(ctx);
 }
\ No newline at end of file
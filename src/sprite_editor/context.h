@@ -1,5 +1,6 @@
 #pragma once
 
+#include "containers/bitset.h"
 #include "containers/string.h"
 #include "engine/imgui.h"
 #include "engine/rect.h"
@@ -47,8 +48,9 @@ struct Context
         } create_sprite;
     };
 
-    DynamicArray<s32> sprites_selected = {};
-    DynamicArray<s32> sprites_to_be_deleted = {};
+    // One bit per sprite, kept the same size as the sprite list
+    DynamicBitSet sprites_selected = {};
+    DynamicBitSet sprites_to_be_deleted = {};
 };
 
 bool context_init(Context& ctx, const Application& app);
@@ -56,4 +58,6 @@ void context_free(Context& ctx);
 
 // TODO: Handle errors for wrong initialization
 void context_update_on_image_load(Context& ctx, const String file_path, const TextureSettings settings);
+// Call after sprites are added or removed, keeps the per sprite sets in sync
+void context_on_sprite_count_changed(Context& ctx);
 void context_delete_sprites(Context& ctx);
\ No newline at end of file
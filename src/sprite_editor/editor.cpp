@@ -2,6 +2,8 @@
 
 #include "application/application.h"
 #include "core/input.h"
+#include "core/allocator.h"
+#include "containers/string_builder.h"
 #include "context.h"
 
 void render_sprite_list(const Application &app, Context &ctx, f32& z)
@@ -37,14 +39,10 @@ void render_sprite_list(const Application &app, Context &ctx, f32& z)
 
     for (int i = 0; i < sheet.sprites.size; i++)
     {
-        const u64 sprite_index_in_selection = find(ctx.sprites_selected, i);
-        const bool is_sprite_selected = sprite_index_in_selection != ctx.sprites_selected.size;
+        const bool is_sprite_selected = test_bit(ctx.sprites_selected, i);
 
         {   // Sprite name
-            char buffer[128];
-            sprintf(buffer, "Sprite %d", i);
-
-            const String text  = ref(buffer);
+            const String text  = arena_format(get_frame_arena(), "Sprite %", i);
             const Vector2 size = Imgui::get_rendered_text_size(text, ctx.ui_font);
 
             if (!is_sprite_selected)
@@ -60,17 +58,14 @@ void render_sprite_list(const Application &app, Context &ctx, f32& z)
                 {
                     if (Input::get_key(Key::SHIFT))
                     {
-                        if (is_sprite_selected)
-                            remove(ctx.sprites_selected, sprite_index_in_selection);
-                        else
-                            append(ctx.sprites_selected, i);
+                        toggle_bit(ctx.sprites_selected, i);
                     }
                     else
                     {
-                        clear(ctx.sprites_selected);
+                        clear_all(ctx.sprites_selected);
                         
                         if (!is_sprite_selected)
-                            append(ctx.sprites_selected, i);
+                            set_bit(ctx.sprites_selected, i);
                     }
                 }
 
@@ -92,10 +87,11 @@ void render_sprite_list(const Application &app, Context &ctx, f32& z)
                         top_left.y + btn_text_size.y + 2 * padding_y
                     };
 
-                    // TODO: Need to remove this sprite from selected ones as well
-
                     if (Imgui::render_text_button(imgui_gen_id_with_secondary(i), rect, btn_text, ctx.ui_font, Vector2 { padding_x, padding_y }, z))
-                        append(ctx.sprites_to_be_deleted, i);
+                    {
+                        set_bit(ctx.sprites_to_be_deleted, i);
+                        clear_bit(ctx.sprites_selected, i);
+                    }
 
                     top_left.y += btn_text_size.y + 3 * padding_y;
                 }
@@ -4,10 +4,8 @@
 #include "math/math.h"
 #include "context.h"
 
-void on_mouse_scroll(Application &app, s32 scroll)
+void on_mouse_scroll(Context& ctx, s32 scroll)
 {
-    Context& ctx = *(Context*) app.data;
-    
     if (ctx.input_state == EditorInputState::DRAG_IMAGE)
         return;
 
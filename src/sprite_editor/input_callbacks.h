@@ -1,5 +1,7 @@
 #pragma once
 
-#include "application/application.h"
+#include "core/types.h"
 
-void on_mouse_scroll(Application& app, s32 scroll);
\ No newline at end of file
+struct Context;
+
+void on_mouse_scroll(Context& ctx, s32 scroll);
\ No newline at end of file